@@ -74,6 +74,7 @@ for _, exp in ipairs(experiments) do
           print(getTab(1) .. "--n_simulations_per_mdp 1 \\")
           print(getTab(1) .. "--discount_factor " .. exp.gamma .. " \\")
           print(getTab(1) .. "--horizon_limit " .. exp.T .. " \\")
+          print(getTab(1) .. "--test_set_store \"data/test_sets\" \\")
           print(getTab(1) .. "--compress_output \\")
           print(getTab(1) .. "--output \"data/experiments/"
                 .. exp.exp .. exp.N .. "-exp.dat" .. "\"")
@@ -29,6 +29,7 @@
 #include "src/AgentFactory/SLAgentFactory/ANNAgentFactory.h"
 
 #include "src/MDP/MDP.h"
+#include "src/MDP/MDPKernels.h"
 #include "src/MDP/Model.h"
 #include "src/MDP/CModel.h"
 
@@ -1,6 +1,7 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <set>
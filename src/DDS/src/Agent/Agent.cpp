@@ -84,6 +84,7 @@ Agent* Agent::parse(int argc, char* argv[],
                //   Get 'base agent'
                int argcBase;
                char** argvBase;
+               char str[] = "--agent";
                for (unsigned int i = 1; i < argc; ++i)
                {
                     //   '--base_agent' not found
@@ -93,7 +94,6 @@ Agent* Agent::parse(int argc, char* argv[],
                     //   '--base_agent' found
                     argvBase = new char*[2 + (argc - i - 1)];
                     argvBase[0] = argv[0];
-                    char str[] = "--agent";
                     argvBase[1] = str;
                     
                     argcBase = 2;
@@ -180,6 +180,20 @@ Agent* Agent::parse(int argc, char* argv[],
                string tmp = parsing::getValue(argc, argv, "--K");
                unsigned int K = atoi(tmp.c_str());
                
+               
+               //   Get 'reuseSamples'
+               bool reuseSamples =
+                    parsing::hasFlag(argc, argv, "--reuse_samples");
+               
+               
+               //   Get 'msPerAction' (optional)
+               double msPerAction = 0.0;
+               if (parsing::hasFlag(argc, argv, "--ms_per_action"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--ms_per_action");
+                    msPerAction = atof(tmp.c_str());
+               }
+               
                try
                {
                     //   Get 'D'
@@ -188,12 +202,12 @@ Agent* Agent::parse(int argc, char* argv[],
 
 
                     //   Return
-                    return new BAMCPAgent(K, D);
+                    return new BAMCPAgent(K, D, reuseSamples, msPerAction);
                }
 
                catch (parsing::ParsingException e)
                {
-                    return new BAMCPAgent(K);
+                    return new BAMCPAgent(K, 0, reuseSamples, msPerAction);
                }     
           }
           
@@ -209,6 +223,15 @@ Agent* Agent::parse(int argc, char* argv[],
                unsigned int C = atoi(tmp.c_str());
 
 
+               //   Get 'msPerAction' (optional)
+               double msPerAction = 0.0;
+               if (parsing::hasFlag(argc, argv, "--ms_per_action"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--ms_per_action");
+                    msPerAction = atof(tmp.c_str());
+               }
+
+
                try
                {
                     //   Get 'D'
@@ -217,12 +240,12 @@ Agent* Agent::parse(int argc, char* argv[],
 
 
                     //   Return
-                    return new BFS3Agent(K, C, D);
+                    return new BFS3Agent(K, C, D, msPerAction);
                }
 
                catch (parsing::ParsingException e)
                {
-                    return new BFS3Agent(K, C);
+                    return new BFS3Agent(K, C, 0, msPerAction);
                }
           }
           
@@ -238,8 +261,17 @@ Agent* Agent::parse(int argc, char* argv[],
                double delta = atof(tmp.c_str());
 
 
+               //   Get 'msPerAction' (optional)
+               double msPerAction = 0.0;
+               if (parsing::hasFlag(argc, argv, "--ms_per_action"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--ms_per_action");
+                    msPerAction = atof(tmp.c_str());
+               }
+
+
                //   Return
-               return new SBOSSAgent(epsilon, delta);
+               return new SBOSSAgent(epsilon, delta, msPerAction);
           }
           
           if (agentClassName == BEBAgent::toString())
@@ -409,11 +441,40 @@ Agent* Agent::parse(int argc, char* argv[],
                //   Get 'epochRange'
                tmp = parsing::getValue(argc, argv, "--epoch_range");
                unsigned int epochRange = atoi(tmp.c_str());
+               
+               
+               //   Get 'batchSize' (optional, incremental training if
+               //   not specified)
+               unsigned int batchSize = 0;
+               if (parsing::hasFlag(argc, argv, "--batch_size"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--batch_size");
+                    batchSize = atoi(tmp.c_str());
+               }
+               
+               
+               //   Get 'nbThreads' (optional)
+               unsigned int nbThreads = 1;
+               if (parsing::hasFlag(argc, argv, "--n_threads"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--n_threads");
+                    nbThreads = atoi(tmp.c_str());
+               }
+               
+               
+               //   Get 'nbNetworks' (optional)
+               unsigned int nbNetworks = 1;
+               if (parsing::hasFlag(argc, argv, "--n_networks"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--n_networks");
+                    nbNetworks = atoi(tmp.c_str());
+               }
           
           
                //   Get 'base agent'
                int argcBase;
                char** argvBase;
+               char str[] = "--agent";
                for (unsigned int i = 1; i < argc; ++i)
                {
                     //   '--base_agent' not found
@@ -423,7 +484,6 @@ Agent* Agent::parse(int argc, char* argv[],
                     //   '--base_agent' found
                     argvBase = new char*[2 + (argc - i - 1)];
                     argvBase[0] = argv[0];
-                    char str[] = "--agent";
                     argvBase[1] = str;
                     
                     argcBase = 2;
@@ -465,6 +525,7 @@ Agent* Agent::parse(int argc, char* argv[],
                return new ANNAgent(
                          hiddenLayers, learningRate, decreasingLearningRate,
                          maxEpoch, epochRange,
+                         batchSize, nbThreads, nbNetworks,
                          baseAgent, nbOfMDPs, simGamma, T, SLModelFileName);
           }
      }
@@ -140,6 +140,17 @@ class dds::Agent : public IAgent
 		virtual void freeData() {}
 		
 		
+		/**
+			\brief	Return the number of simulations performed by this
+					Agent on the last MDP it has interacted with.
+					(0 if this Agent does not plan)
+			
+			\return	The number of simulations performed by this Agent
+					on the last MDP it has interacted with.
+		*/
+		virtual unsigned long getNbSimulations() const { return 0; }
+		
+		
 		/**
 			\brief	Return a clone of this Agent.
 			
@@ -10,19 +10,25 @@ using namespace utils;
 //	Public Constructors/Destructor
 // ===========================================================================
 BAMCPAgent::BAMCPAgent(std::istream& is) :
-          Agent(), bamcp(0), simulator(0), samplerFact(0)
+          Agent(), bamcp(0), simulator(0), samplerFact(0),
+          nbSimulations(0)
 {
 	try							{ dDeserialize(is);	}
 	catch (SerializableException e)	{ deserialize(is);	}
 }
 
 
-BAMCPAgent::BAMCPAgent(unsigned int K_, unsigned int D_) :
-          K(K_), D(D_), bamcp(0), simulator(0), samplerFact(0)
+BAMCPAgent::BAMCPAgent(unsigned int K_, unsigned int D_, bool reuseSamples_,
+                       double msPerAction_) :
+          K(K_), D(D_), reuseSamples(reuseSamples_),
+          msPerAction(msPerAction_),
+          bamcp(0), simulator(0), samplerFact(0), nbSimulations(0)
 {
      stringstream sstr;
 	sstr << "BAMCP (K = " << K;
 	if (D > 0) { sstr << ", depth = " << D; }
+	if (reuseSamples) { sstr << ", reuse"; }
+	if (msPerAction > 0) { sstr << ", " << msPerAction << " ms/action"; }
 	sstr << ", no model)";
 	setName(sstr.str());
      
@@ -76,10 +82,13 @@ void BAMCPAgent::reset() throw (AgentException)
 	searchParamsBAMCP.ExplorationConstant 	= 3.0;
 	searchParamsBAMCP.RB 				= -1;
 	searchParamsBAMCP.eps 				= 0.5;
+	searchParamsBAMCP.ReuseSamples 		= reuseSamples;
+	searchParamsBAMCP.MsPerAction 		= msPerAction;
      
      unsigned int s = getMDP()->getCurrentState();     
      simulator      = new MDPSimulator(s, nX, nU, R, getGamma());     
      samplerFact    = new PCSamplerFactory(priorcountList);
+     nbSimulations  = 0;
      bamcp          = new BAMCP(*simulator, searchParamsBAMCP, *samplerFact);
 	
 	
@@ -92,6 +101,9 @@ void BAMCPAgent::reset() throw (AgentException)
 
 void BAMCPAgent::freeData()
 {
+     if (bamcp)
+          nbSimulations = bamcp->GetNumSimulationsDone();
+     
      if (bamcp)          { delete bamcp;       bamcp       = 0; }
      if (simulator)      { delete simulator;   simulator   = 0; }
      if (samplerFact)    { delete samplerFact; samplerFact = 0; }
@@ -104,13 +116,20 @@ void BAMCPAgent::freeData()
 }
 
 
+unsigned long BAMCPAgent::getNbSimulations() const
+{
+     if (bamcp) { return bamcp->GetNumSimulationsDone(); }
+     return nbSimulations;
+}
+
+
 void BAMCPAgent::serialize(ostream& os) const
 {
 	Agent::serialize(os);
 	
 	
 	os << BAMCPAgent::toString() << "\n";
-     os << 6 << "\n";
+     os << 8 << "\n";
 
 
 	//  'K'
@@ -153,6 +172,14 @@ void BAMCPAgent::serialize(ostream& os) const
 				else				{ os << "\n"; }
 			}
 		}
+	
+	
+	//  'reuseSamples'
+	os << reuseSamples << "\n";
+	
+	
+	//  'msPerAction'
+	os << msPerAction << "\n";
 }
 
 
@@ -241,6 +268,26 @@ void BAMCPAgent::deserialize(istream& is) throw (SerializableException)
 		}
 	}
 	++i;
+	
+	
+	//  'reuseSamples' (absent from the files saved before its addition)
+	reuseSamples = false;
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("reuseSamples"); }
+		reuseSamples = (atoi(tmp.c_str()) != 0);
+		++i;
+	}
+	
+	
+	//  'msPerAction' (absent from the files saved before its addition)
+	msPerAction = 0.0;
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("msPerAction"); }
+		msPerAction = atof(tmp.c_str());
+		++i;
+	}
      
      
      //   'bamcp', 'simulator' and 'samplerFact'
@@ -285,6 +332,8 @@ void BAMCPAgent::learnOffline_aux(const MDPDistribution* mdpDistrib)
 		stringstream sstr;
 		sstr << "BAMCP (K = " << K;
 		if (D > 0) { sstr << ", depth = " << D; }
+		if (reuseSamples) { sstr << ", reuse"; }
+		if (msPerAction > 0) { sstr << ", " << msPerAction << " ms/action"; }
 		sstr << ", " << dirDistrib->getShortName() << ")";
 		setName(sstr.str());
 	}
@@ -50,8 +50,18 @@
 			                 tree at each time-step.
                \param[D_        The maximal depth.
                                 (default: horizon limit)
+               \param[reuseSamples_
+                                If true, the posterior samples of a
+                                time-step are kept for the next one,
+                                and only their updated rows are redrawn.
+               \param[msPerAction_
+                                The time budget of a decision (in ms).
+                                If > 0, the planner runs until the
+                                deadline instead of inserting K nodes.
 		*/
-		BAMCPAgent(unsigned int K_, unsigned int D_ = 0);
+		BAMCPAgent(unsigned int K_, unsigned int D_ = 0,
+		           bool reuseSamples_ = false,
+		           double msPerAction_ = 0.0);
 		
 		
 		/**
@@ -115,6 +125,17 @@
 		void freeData();
 
 
+		/**
+			\brief	Return the number of simulations performed by this
+					Agent on the last MDP it has interacted with.
+					(one simulation = one descent in the BAMCP tree)
+			
+			\return	The number of simulations performed by this Agent
+					on the last MDP it has interacted with.
+		*/
+		unsigned long getNbSimulations() const;
+
+
 		/**
 			\brief	Return a clone of this Agent.
 			
@@ -181,6 +202,21 @@
 		unsigned int D;
 		
 		
+		/**
+               \brief    If true, the posterior samples of a time-step are
+                         kept for the next one, and only their updated rows
+                         are redrawn.
+		*/
+		bool reuseSamples;
+		
+		
+		/**
+               \brief    The time budget of a decision (in ms).
+                         (0: no time budget)
+		*/
+		double msPerAction;
+		
+		
 		/**
 		   \brief    The BAMCP algorithm (implemented by Guez).
 		*/
@@ -199,6 +235,13 @@
 		SamplerFactory* samplerFact;
 		
 		
+		/**
+               \brief    The number of simulations performed on the last
+                         MDP (saved when 'bamcp' is deleted).
+		*/
+		unsigned long nbSimulations;
+		
+		
 		/**
 		   \brief    The number of states of the MDPs to be played.
 		*/
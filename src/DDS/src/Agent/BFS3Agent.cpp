@@ -10,19 +10,23 @@ using namespace utils;
 //	Public Constructors/Destructor
 // ===========================================================================
 BFS3Agent::BFS3Agent(std::istream& is) :
-          Agent(), bfs3(0), simulator(0), samplerFact(0)
+          Agent(), bfs3(0), simulator(0), samplerFact(0),
+          nbSimulations(0)
 {
 	try							{ dDeserialize(is);	}
 	catch (SerializableException e)	{ deserialize(is);	}
 }
 
 
-BFS3Agent::BFS3Agent(unsigned int K_, unsigned int C_, unsigned int D_) :
-          K(K_), C(C_), D(D_), bfs3(0), simulator(0), samplerFact(0)
+BFS3Agent::BFS3Agent(unsigned int K_, unsigned int C_, unsigned int D_,
+                     double msPerAction_) :
+          K(K_), C(C_), D(D_), msPerAction(msPerAction_),
+          bfs3(0), simulator(0), samplerFact(0), nbSimulations(0)
 {
      stringstream sstr;
 	sstr << "BFS3 (K = " << K << ", C = " << C;
 	if (D > 0) { sstr << ", depth = " << D; }
+	if (msPerAction > 0) { sstr << ", " << msPerAction << " ms/action"; }
 	sstr << ", no model)";
 	setName(sstr.str());
      
@@ -77,11 +81,13 @@ void BFS3Agent::reset() throw (AgentException)
 	searchParamsBFS3.C = C;
 	searchParamsBFS3.N = std::max(1, (int) (K / searchParamsBFS3.C));
 	searchParamsBFS3.gamma = getGamma();
+	searchParamsBFS3.MsPerAction = msPerAction;
 	
      
      unsigned int s = getMDP()->getCurrentState();     
      simulator      = new MDPSimulator(s, nX, nU, R, getGamma());     
      samplerFact    = new PCSamplerFactory(priorcountList);
+     nbSimulations  = 0;
      bfs3           = new BFS3(*simulator, searchParamsBFS3, *samplerFact);
 	
 	
@@ -94,6 +100,9 @@ void BFS3Agent::reset() throw (AgentException)
 
 void BFS3Agent::freeData()
 {
+     if (bfs3)
+          nbSimulations = bfs3->GetNumSimulationsDone();
+     
      if (bfs3)           { delete bfs3;        bfs3        = 0; }
      if (simulator)      { delete simulator;   simulator   = 0; }
      if (samplerFact)    { delete samplerFact; samplerFact = 0; }
@@ -106,13 +115,20 @@ void BFS3Agent::freeData()
 }
 
 
+unsigned long BFS3Agent::getNbSimulations() const
+{
+     if (bfs3) { return bfs3->GetNumSimulationsDone(); }
+     return nbSimulations;
+}
+
+
 void BFS3Agent::serialize(ostream& os) const
 {
 	Agent::serialize(os);
 	
 	
 	os << BFS3Agent::toString() << "\n";
-     os << 8 << "\n";
+     os << 9 << "\n";
 
 
 	//  'K'
@@ -163,6 +179,10 @@ void BFS3Agent::serialize(ostream& os) const
 				else				{ os << "\n"; }
 			}
 		}
+	
+	
+	//  'msPerAction'
+	os << msPerAction << "\n";
 }
 
 
@@ -263,6 +283,16 @@ void BFS3Agent::deserialize(istream& is) throw (SerializableException)
 		}
 	}
 	++i;
+	
+	
+	//  'msPerAction' (absent from the files saved before its addition)
+	msPerAction = 0.0;
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("msPerAction"); }
+		msPerAction = atof(tmp.c_str());
+		++i;
+	}
      
      
      //   'BFS3', 'simulator' and 'samplerFact'
@@ -307,6 +337,7 @@ void BFS3Agent::learnOffline_aux(const MDPDistribution* mdpDistrib)
 		stringstream sstr;
 		sstr << "BFS3 (K = " << K << ", C = " << C;
 		if (D > 0) { sstr << ", depth = " << D; }
+		if (msPerAction > 0) { sstr << ", " << msPerAction << " ms/action"; }
 		sstr << ", " << dirDistrib->getShortName() << ")";
 		setName(sstr.str());
 	}
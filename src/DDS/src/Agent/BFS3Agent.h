@@ -51,8 +51,13 @@
                \param[C_        The branching factor.
                \param[D_        The maximal depth.
                                 (default: horizon limit)
+               \param[msPerAction_
+                                The time budget of a decision (in ms).
+                                If > 0, the planner runs until the
+                                deadline instead of performing K rollouts.
 		*/
-		BFS3Agent(unsigned int K_, unsigned int C_, unsigned int D_ = 0);
+		BFS3Agent(unsigned int K_, unsigned int C_, unsigned int D_ = 0,
+		          double msPerAction_ = 0.0);
 		
 		
 		/**
@@ -116,6 +121,17 @@
 		void freeData();
 
 
+		/**
+			\brief	Return the number of simulations performed by this
+					Agent on the last MDP it has interacted with.
+					(one simulation = one FSSS rollout)
+			
+			\return	The number of simulations performed by this Agent
+					on the last MDP it has interacted with.
+		*/
+		unsigned long getNbSimulations() const;
+
+
 		/**
 			\brief	Return a clone of this Agent.
 			
@@ -188,6 +204,13 @@
 		unsigned int D;
 		
 		
+		/**
+               \brief    The time budget of a decision (in ms).
+                         (0: no time budget)
+		*/
+		double msPerAction;
+		
+		
 		/**
              \brief    The maximal observable reward (learned from the prior).
 		*/
@@ -212,6 +235,13 @@
 		SamplerFactory* samplerFact;
 		
 		
+		/**
+               \brief    The number of simulations performed on the last
+                         MDP (saved when 'bfs3' is deleted).
+		*/
+		unsigned long nbSimulations;
+		
+		
 		/**
                \brief    The number of states of the MDPs to be played.
 		*/
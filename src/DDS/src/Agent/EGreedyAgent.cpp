@@ -62,14 +62,8 @@ int EGreedyAgent::getAction(int xt) const throw (AgentException)
 	//	'greedy' case
 	else
 	{		
-		vector<vector<double>::const_iterator> maxList;
-		maxList = utils::search::max<vector<double> >(
+		return utils::search::randMax<vector<double> >(
 				(Q.begin() + nU*xt), (Q.begin() + nU*xt + nU));
-		
-		assert(!maxList.empty());
-
-		int maxI = RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-		return (maxList[maxI] - (Q.begin() + nU*xt));
 	}
 }
 
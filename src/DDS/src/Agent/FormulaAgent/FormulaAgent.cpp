@@ -87,13 +87,7 @@ int FormulaAgent::getAction(int xt) const throw (AgentException)
 	
 	
 	//  Select the action maximizing the computed Q-function
-	vector<vector<double>::const_iterator> maxList;
-	maxList = utils::search::max<vector<double> >(Qxt.begin(), Qxt.end());
-	
-	assert(!maxList.empty());
-
-	int maxI = RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-	return (maxList[maxI] - Qxt.begin());
+	return utils::search::randMax<vector<double> >(Qxt.begin(), Qxt.end());
 }
 
 
@@ -37,8 +37,12 @@ QCounterVar* QCounterVar::generate(unsigned int nX, unsigned int nU,
                                    unsigned int b, unsigned int np,
                                    double accuracy,
                                    double alpha, double beta,
-                                   const vector<QCounterVar*>& varList)
+                                   const vector<QCounterVar*>& varList,
+                                   unsigned int nbThreads)
 {
+     if (nbThreads == 0) { nbThreads = 1; }
+     
+     
      //   Initialize the gaussians
      vector<double> gMu(nX*nU*nX);
      vector<double> gSigma(nX*nU*nX);
@@ -79,39 +83,54 @@ QCounterVar* QCounterVar::generate(unsigned int nX, unsigned int nU,
           }
           
           
-          //   Evaluate each individual and put them in a queue
+          //   Evaluate each individual
+          //   (the MDPs are drawn once, and shared by all the threads)
           vector<MDP*> mdps;
           for (unsigned int j = 0; j < N; ++j)
                mdps.push_back(prior->draw());
           
-          priority_queue<pair<double, unsigned int> > pq;
-          for (unsigned int i = 0; i < np; ++i)
+          Evaluation eval;
+          eval.prior   = prior;
+          eval.mdps    = &mdps;
+          eval.gamma   = gamma;
+          eval.T       = T;
+          eval.alpha   = alpha;
+          eval.beta    = beta;
+          eval.varList = &varList;
+          eval.nX      = nX;
+          eval.nU      = nU;
+          eval.pop     = &pop;
+          eval.scoreList.resize(np);
+          eval.seed    = RandomGen::randIntRange_Uniform(0, INT_MAX);
+          eval.nextInd = 0;
+          
+          vector<EvaluationThread*> threadList;
+          for (unsigned int k = 0; k < min(nbThreads, np); ++k)
           {
-               //   Evaluate
-               QCounterVar* var = new QCounterVar(nX, nU, pop[i]);
-               double score = evaluate(var, prior, mdps, gamma, T,
-                                       alpha, beta, varList);
-
-               //   Free data           
-               delete var;
-               
-               
-               //   Push the results
-               pq.push(pair<double, int>(score, i));
-               
-//               cout << (i / (double) np)*100 << "%\n";
+               threadList.push_back(new EvaluationThread(&eval));
+               threadList.back()->start();
+          }
+          
+          for (unsigned int k = 0; k < threadList.size(); ++k)
+          {
+               threadList[k]->join();
+               delete threadList[k];
           }
           
           for (unsigned int j = 0; j < N; ++j) { delete mdps[j]; }
           
           
           //   Retrieve the 'b' best individuals of the population
+          vector<pair<double, unsigned int> > rankList;
+          for (unsigned int i = 0; i < np; ++i)
+               rankList.push_back(make_pair(eval.scoreList[i], i));
+          
+          partial_sort(rankList.begin(), rankList.begin() + b, rankList.end(),
+                       greater<pair<double, unsigned int> >());
+          
           vector<vector<double> > bestList;
-          while (bestList.size() < b)
-          {
-               bestList.push_back(pop[pq.top().second]);
-               pq.pop();
-          }
+          for (unsigned int i = 0; i < b; ++i)
+               bestList.push_back(pop[rankList[i].second]);
           
           
           //   Update the gaussians
@@ -417,3 +436,41 @@ double QCounterVar::getDistance(double alpha, double beta,
      cout << (alpha*iniDist) / (beta*updateDist) << endl;
      return (alpha * iniDist) + (beta * updateDist);
 }
+
+
+// ===========================================================================
+//	Private Classes - EvaluationThread
+// ===========================================================================
+void* QCounterVar::EvaluationThread::run()
+{
+     //   Copy the MDPs (a simulation modifies the current state of its MDP)
+     vector<MDP*> mdps;
+     for (unsigned int j = 0; j < eval->mdps->size(); ++j)
+          mdps.push_back((*eval->mdps)[j]->clone());
+     
+     
+     for (;;)
+     {
+          //   Get the next individual to evaluate
+          unsigned int i = __sync_fetch_and_add(&eval->nextInd, 1);
+          if (i >= eval->pop->size()) { break; }
+          
+          
+          //   Evaluate it (with a stream of random numbers of its own)
+          RandomGen::setThreadSeed(hashing::computeSeed(eval->seed, i));
+          
+          QCounterVar* var = new QCounterVar(eval->nX, eval->nU,
+                                             (*eval->pop)[i]);
+          eval->scoreList[i] = evaluate(var, eval->prior, mdps,
+                                        eval->gamma, eval->T,
+                                        eval->alpha, eval->beta,
+                                        *eval->varList);
+          delete var;
+     }
+     
+     
+     //   Free
+     for (unsigned int j = 0; j < mdps.size(); ++j) { delete mdps[j]; }
+     
+     return 0;
+}
@@ -85,6 +85,11 @@
                \param[beta         The weight of the update score (of the
                                    distance score).
                \param[varList      A list of variables.
+               \param[nbThreads    The number of threads evaluating the
+                                   individuals of a population concurrently.
+                                   Each individual is evaluated with its own
+                                   stream of random numbers, so that the
+                                   result does not depend on 'nbThreads'.
 		*/
 		static QCounterVar* generate(unsigned int nX, unsigned int nU,
 		                             const MDPDistribution* prior,
@@ -94,7 +99,8 @@
 		                             unsigned int b, unsigned int np,
 		                             double accuracy,
 		                             double alpha, double beta,
-		                             const vector<QCounterVar*>& varList);
+		                             const vector<QCounterVar*>& varList,
+		                             unsigned int nbThreads);
 		
 		
 		
@@ -183,6 +189,40 @@
 
 
      private:
+          // =================================================================
+		//	Private structures
+		// =================================================================
+		/**
+		     \brief    The data shared by the EvaluationThreads evaluating
+		               a population (see 'generate()').
+		*/
+		struct Evaluation
+		{
+		     const MDPDistribution* prior;
+		     const std::vector<MDP*>* mdps;
+		     double gamma;
+		     unsigned int T;
+		     double alpha, beta;
+		     const std::vector<QCounterVar*>* varList;
+		     unsigned int nX, nU;
+		     
+		     const std::vector<std::vector<double> >* pop;
+		     std::vector<double> scoreList;
+		     unsigned int seed;
+		     unsigned int nextInd;
+		};
+
+
+          // =================================================================
+		//	Private Classes
+		// =================================================================
+		/**
+			\brief	A thread evaluating the individuals of a population,
+					one after another, until none is left.
+		*/
+		class EvaluationThread;
+
+
           // =================================================================
 		//	Private static methods
 		// =================================================================
@@ -253,6 +293,52 @@
                \brief    The list of prior observations.
 		*/
 		std::vector<double> N;
+
+
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		class EvaluationThread : public utils::Thread
+		{			
+			public:
+				// =======================================================
+				//	Public Constructors
+				// =======================================================
+				/**
+					\brief	Constructor.
+					
+					\param[eval_	The population to evaluate (shared by
+								all the EvaluationThreads).
+				*/
+				EvaluationThread(Evaluation* eval_) :
+						Thread(), eval(eval_) {}
+			
+				
+				// =======================================================
+				//	Public methods
+				// =======================================================
+				/**
+					\brief	Run the EvaluationThread.
+				*/
+				void* run();
+
+
+			private:				
+				// =======================================================
+				//	Private attributes
+				// =======================================================
+				Evaluation* eval;
+		};
+
+
+		// =================================================================
+		//	Friendships
+		// =================================================================
+		/**
+			\brief	Allow the EvaluationThreads to evaluate the
+					individuals.
+		*/
+		friend class EvaluationThread;
 };
 
 #endif
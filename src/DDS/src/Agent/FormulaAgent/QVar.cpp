@@ -45,6 +45,8 @@ void QVar::freeData()
 void QVar::update(
           unsigned int x, unsigned int u, unsigned int y, double r)
 {
+     PROFILE_SCOPE("QVar::update");
+     
      assert(model);
      assert(x < model->getNbStates());
      assert(u < model->getNbActions());
@@ -1,13 +1,16 @@
 #include "PCTransitionSampler.h"
 #include "envs/basicMDP.h"
 #include "utils/guez_utils.h"
+#include <algorithm>
 
 //PCTransitionSampler functions
 //-----------------------------------------------------
 
 
 PCTransitionSampler::PCTransitionSampler(double* _P, uint _S) : P(_P), S(_S){
-
+	//P is turned into its cumulative distribution
+	for(uint i=1;i<S;++i)
+		P[i] += P[i-1];
 }
 
 PCTransitionSampler::~PCTransitionSampler()
@@ -15,9 +18,9 @@ PCTransitionSampler::~PCTransitionSampler()
 	delete[] P;
 }
 uint PCTransitionSampler::getNextStateSample(){
-	uint sp;
-	guez_utils::rng.multinom(P,S,sp);
-	return sp;	
+	double u = guez_utils::getRNG().rand_open01();
+	uint sp = std::upper_bound(P,P+S,u) - P;
+	return (sp < S) ? sp : (S-1);
 }
 
 //PCTransitionParamSampler functions
@@ -36,7 +36,7 @@ bool BANDIT::Step(uint, uint action,
     uint& observation, double& reward) const
 {
 	
-	if(guez_utils::rng.rand_closed01() < p[action]){
+	if(guez_utils::getRNG().rand_closed01() < p[action]){
 		reward = 1;
 		observation = 0;
 	}	
@@ -156,7 +156,7 @@ void BasicMDP::Validate(const uint) const{
 bool BasicMDP::Step(uint state, uint action, 
     uint& observation, double& reward) const
 {
-	guez_utils::rng.multinom(T+state*SA+action*S,S,observation);
+	guez_utils::getRNG().multinom(T+state*SA+action*S,S,observation);
 	if(rsas)	
 		reward = R[state*SA+action*S+observation];
 	else
@@ -53,7 +53,7 @@ bool LazyMDP::Step(uint state, uint action,
 		sampler->getTransitionParam(state, action, lT[index]);
 	}
 	
-	guez_utils::rng.multinom(lT[index],S,observation);
+	guez_utils::getRNG().multinom(lT[index],S,observation);
 	if(rsas)	
 		reward = R[state*SA+action*S+observation];
 	else
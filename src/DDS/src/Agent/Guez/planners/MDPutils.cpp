@@ -1,6 +1,7 @@
 #include "MDPutils.h"
 
 #include "../utils/guez_utils.h"
+#include "../../../../../Utils/src/Profiler.h"
 
 namespace MDPutils{
 
@@ -13,6 +14,7 @@ namespace MDPutils{
 			double epsilon,
 			const uint* PI,
 			double* V){
+		PROFILE_SCOPE("MDPutils::policyEvaluation");
 		
 		assert(gamma > 0);
 		assert(gamma < 1); // != 1 to guarantee convergence
@@ -67,6 +69,7 @@ namespace MDPutils{
 			double epsilon,
 			uint* PI,
 			double* V){
+		PROFILE_SCOPE("MDPutils::valueIteration");
 
 		assert(gamma > 0);
 		assert(gamma < 1); // != 1 to guarantee convergence
@@ -129,6 +132,79 @@ namespace MDPutils{
 	}
 
 
+	uint valueIterationMerged(uint S,
+			uint A,
+			bool rsas,
+			double* const* P,
+			const uint* K,
+			const double* R,
+			double gamma,
+			double epsilon,
+			uint* PI,
+			double* V,
+			double deadline){
+		PROFILE_SCOPE("MDPutils::valueIterationMerged");
+
+		assert(gamma > 0);
+		assert(gamma < 1); // != 1 to guarantee convergence
+
+		uint SA = S*A;
+		double sqeps = epsilon*epsilon;
+		//Initialize value function with V
+		//(Create 2 to avoid copying memory each iteration)
+		double* V0 = new double[S];
+		double* V1 = new double[S];
+		memcpy(V1,V,S*sizeof(double));
+		size_t z = 1;
+		double* Vu;
+		double* Vv;
+
+		size_t ll,aa;
+		uint nSweeps = 0;
+		do{
+			if(z==1){
+				Vu = V1;Vv = V0;z=0;
+			}
+			else{
+				Vu = V0;Vv = V1;z=1;
+			}
+			for(ll=0;ll<S;++ll){
+				PI[ll] = 0;
+				Vv[ll] = -std::numeric_limits<double>::infinity();
+				for(aa=0;aa<A;++aa){
+					uint la = ll*A+aa;
+					double* Pk = P[la];
+					for(uint k=0;k<K[la];++k,Pk+=S){
+						double Q;
+						if(!rsas){
+							Q = R[la] + gamma*guez_utils::inner_prod(Pk,Vu,S);
+						}
+						else{
+							Q = 0;
+							const double* Rsa = R+ll*SA+aa*S;
+							for(uint ss=0;ss<S;++ss){
+								Q += Pk[ss]*(Rsa[ss] + gamma*Vu[ss]);
+							}
+						}
+						if(Q > Vv[ll]){
+							PI[ll] = aa;
+							Vv[ll] = Q;
+						}
+					}
+				}
+			}
+			++nSweeps;
+		}	
+		while(guez_utils::sqnorm_2(V0,V1,S) > sqeps
+				&& (deadline == 0 || guez_utils::getMonotonicTime() < deadline));
+
+		memcpy(V,Vv,S*sizeof(double));
+		delete[] V0;
+		delete[] V1;
+
+		return nSweeps;
+	}
+
 	void valueIterationRmax(uint S,
 			uint A,
 			bool rsas,
@@ -140,6 +216,7 @@ namespace MDPutils{
 			double* V,
 			const uint* counts,
 			uint B){
+		PROFILE_SCOPE("MDPutils::valueIterationRmax");
 
 		assert(gamma > 0);
 		assert(gamma < 1); // != 1 to guarantee convergence
@@ -219,6 +296,7 @@ namespace MDPutils{
 			double* V,
 			const double* counts,
 			uint B){
+		PROFILE_SCOPE("MDPutils::valueIterationRmax");
 
 		assert(gamma > 0);
 		assert(gamma < 1); // != 1 to guarantee convergence
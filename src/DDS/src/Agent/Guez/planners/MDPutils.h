@@ -24,6 +24,24 @@ namespace MDPutils{
 											double epsilon,
 											uint* PI,
 											double* V);
+
+	//Value iteration in a merged MDP, where (s,a) is available with K[s*A+a]
+	//sampled transition vectors, stored contiguously in P[s*A+a].
+	//V is used as initial value function, and PI[s] is the original action.
+	//If 'deadline' (monotonic clock, in ms) is not 0, the iterations also
+	//stop once it is passed (after one sweep at least).
+	//Return the number of sweeps performed.
+	uint valueIterationMerged(uint S,
+			uint A,
+			bool rsas,
+			double* const* P,
+			const uint* K,
+			const double* R,
+			double gamma,
+			double epsilon,
+			uint* PI,
+			double* V,
+			double deadline = 0);
 	
 	void valueIterationRmax(uint S,
 			uint A,
@@ -2,6 +2,7 @@
 
 #include <math.h>
 #include "../../../utils/guez_utils.h"
+#include "../../../../../../../Utils/src/Profiler.h"
 #include <algorithm>
 
 #include "../../../planners/MDPutils.h" 
@@ -20,7 +21,8 @@ SBOSS::PARAMS::PARAMS()
 :   Verbose(0),
 		delta(2),
 		epsilon(0.1),
-		maxError(0.0001)
+		maxError(0.0001),
+		MsPerAction(0)
 
 {
 }
@@ -29,7 +31,8 @@ SBOSS::SBOSS(const SIMULATOR& simulator, const PARAMS& params,
 					 SamplerFactory& sampFact)
 :   Simulator(simulator),
     Params(params),
-		SampFact(sampFact)
+		SampFact(sampFact),
+		NumSimulationsDone(0)
 {
 		A = Simulator.GetNumActions();
 		S = Simulator.GetNumObservations();
@@ -53,18 +56,24 @@ SBOSS::SBOSS(const SIMULATOR& simulator, const PARAMS& params,
           
           postCountsLastResample = new double[SAS];
           postCountsSumLastResample = new double[SA];
+          memcpy(postCountsLastResample,postCounts,SAS*sizeof(double));
+          memcpy(postCountsSumLastResample,postCountsSum,SA*sizeof(double));
 
 	
-	     Pm = 0;
-	     Rm = 0;
+	     Km = new uint[SA];
+	     Pm = new double*[SA];
+		for (uint i = 0; i < SA; ++i) { Km[i] = 0; Pm[i] = 0; }
 		RLPI =  new uint[S];
 		V = new double[S];
+		for (uint s = 0; s < S; ++s) { V[s] = 0.0; }
 
 		
 		K = new uint[SA];
 		for (uint s = 0; s < S; ++s)
 		   for (uint a = 0; a < A; ++a) { updateK(s, a); }
 		
+		resample = new bool[SA];
+		std::fill(resample,resample+SA,true);
 		do_sample = true;
 }
 
@@ -76,8 +85,10 @@ SBOSS::~SBOSS()
 	delete[] postCountsSumLastResample;
 	delete[] RLPI;
 	delete[] V;
-	if (Pm) { delete[] Pm; }
-	if (Rm) { delete[] Rm; }
+	for (uint i = 0; i < SA; ++i) { delete[] Pm[i]; }
+	delete[] Pm;
+	delete[] Km;
+	delete[] resample;
 	delete[] K;
 }
 
@@ -85,6 +96,9 @@ SBOSS::~SBOSS()
 //as done in Precup, Castro 2010.
 double SBOSS::posteriorDeviation(const double* counts1, double sum1,
 		                       const double* counts2, double sum2){	
+	//No count at all in the first posterior: any new count is a deviation
+	if (sum1 == 0.0) { return ((sum2 > 0.0) ? std::numeric_limits<double>::infinity() : 0.0); }
+	
 	double dev = 0.0;
 	for (uint sp = 0; sp < S; ++sp)
 	{
@@ -95,6 +109,14 @@ double SBOSS::posteriorDeviation(const double* counts1, double sum1,
 	              (counts1[sp] * (sum1 - counts1[sp]))
 	                   / (sum1 * sum1 * (sum1 + 1)));
 	    
+	    //A deterministic mean (sigma = 0) deviates infinitely as soon
+	    //as it changes (0/0 would be NaN, and never cross 'delta')
+	    if (sigma == 0.0)
+	    {
+	         if (P1 != P2) { return std::numeric_limits<double>::infinity(); }
+	         continue;
+	    }
+	    
 	    dev += (fabs(P1 - P2) / sigma);
 	}
 	return dev;
@@ -116,6 +138,7 @@ bool SBOSS::Update(uint state, uint action, uint observation, double)
 						  postCounts+ArrayPos,
 						  postCountsSum[state*A+action]) > Params.delta)
           {
+               resample[state*A+action] = true;
 			do_sample = true;
           }
 
@@ -124,62 +147,34 @@ bool SBOSS::Update(uint state, uint action, uint observation, double)
 		return true;
 }
 
+//Resample the (s,a) pairs whose posterior moved away from the one of
+//their last resampling
 void SBOSS::createMergedModel(){
-     //   Get the maximal number of samples to draw for a <state, action> pair    
-     uint maxNbSamples = 0;
-     for (uint s = 0; s < S; ++s)
-          for (uint a = 0; a < A; ++a)
-               if (maxNbSamples < K[A*s + a]) { maxNbSamples = K[A*s + a]; }
-
-     //   Adjust the size of the variables representing the merged MDP
-     Am = A*maxNbSamples;
-	SAm = S*Am;
-	
-	if (Pm) { delete[] Pm; }
-     Pm = new double[S*Am*S];
-
-     if (Rm) { delete[] Rm; }
-	if(Simulator.rsas){
-		Rm = new double[SAm*S];
-		for(uint s=0;s<S;++s){
-			for(uint a=0;a<Am;++a)
-				memcpy(Rm+s*SAm+a*S,
-				       Simulator.R+s*SA+(a%A)*S,S*sizeof(double));
-		}
-	}
-	else{
-		Rm = new double[SAm];
-		for(uint s=0;s<S;++s){
-			for(uint a=0;a<Am;++a)
-				Rm[s*Am+a] = Simulator.R[s*A+(a%A)];
-		}
-	}
+	PROFILE_SCOPE("SBOSS::createMergedModel");
+	for(uint i=0; i<S; ++i){
+		uint iSA = i*SA;
+		for(uint a=0; a<A; ++a){
+			uint ia = i*A + a;
+			if (!resample[ia]) { continue; }
 
+			//At least one sample, otherwise the action would be lost
+			uint nbSamples = std::max(K[ia], (uint) 1);
+			if (Km[ia] != nbSamples)
+			{
+				delete[] Pm[ia];
+				Pm[ia] = new double[nbSamples*S];
+				Km[ia] = nbSamples;
+			}
 
-     //   Build the merged MDP
-	for(size_t i=0; i<S; ++i){
-		uint iSAm = i*SAm;
-		uint iSA = i*SA;
-		for(size_t a=0; a<A; ++a){		   
 			//Get a sampler to sample K T(s,a,.) parameters
 			Sampler* TParamSampler = SampFact.getTransitionParamSampler(counts+iSA+a*S,i,a,S);
-			uint kA = 0;	
-			for(size_t k=0; k < K[i*A + a]; ++k){
-				TParamSampler->getNextTParamSample(Pm+iSAm+(a+kA)*S);
-				kA+=A;
-			}
-			for (size_t k = K[i*A + a]; k < maxNbSamples; ++k)
-			{
-                    for (uint j = 0; j < S; ++j)
-                    {
-                         if (i == j) { Pm[iSAm+(a+kA)*S+j] = 1.0; }
-                         else        { Pm[iSAm+(a+kA)*S+j] = 0.0; }
-                         Rm[iSAm+(a+kA)*S+j] = INT_MIN;
-                    }
-			     kA += A;
-			} 
-			
+			for(uint k=0; k < nbSamples; ++k)
+				TParamSampler->getNextTParamSample(Pm[ia]+k*S);
 			delete TParamSampler;
+
+			memcpy(postCountsLastResample+iSA+a*S,postCounts+iSA+a*S,S*sizeof(double));
+			postCountsSumLastResample[ia] = postCountsSum[ia];
+			resample[ia] = false;
 		}
 	}
 }
@@ -188,24 +183,29 @@ uint SBOSS::SelectAction(uint state)
 {
 		uint a;
 		if(do_sample){
-			//Sample K MDPs and create merged model
+			//With a time budget, the value iteration stops at the deadline
+			//(after one sweep at least)
+			double deadline = 0;
+			if(Params.MsPerAction > 0)
+				deadline = guez_utils::getMonotonicTime() + Params.MsPerAction;
+			//Resample the merged model where needed
 			createMergedModel();
-			//Solve merged model
-			MDPutils::valueIteration(S,
-															 Am,
-															 Simulator.rsas,
-															 Pm,
-															 Rm,
-															 Simulator.GetDiscount(),
-															 Params.maxError,
-															 RLPI,
-															 V);
-			memcpy(postCountsLastResample,postCounts,SAS*sizeof(uint));
-			memcpy(postCountsSumLastResample,postCountsSum,SA*sizeof(uint));
+			//Solve merged model (starting from the previous V)
+			NumSimulationsDone += MDPutils::valueIterationMerged(S,
+			                               A,
+			                               Simulator.rsas,
+			                               Pm,
+			                               Km,
+			                               Simulator.R,
+			                               Simulator.GetDiscount(),
+			                               Params.maxError,
+			                               RLPI,
+			                               V,
+			                               deadline);
 			do_sample = false;
 		}
 		//Use computed policy from the merged model	
-		a = RLPI[state]%A;
+		a = RLPI[state];
 		
 		return a;
 }
@@ -24,6 +24,7 @@ public:
 				double delta;
 				double epsilon;
 				double maxError;
+				double MsPerAction;
     };
 
     SBOSS(const SIMULATOR& simulator, const PARAMS& params,
@@ -36,6 +37,8 @@ public:
 		double posteriorDeviation(const double* counts1, double sum1,
 		                          const double* counts2, double sum2);
 		void createMergedModel();
+
+		unsigned long GetNumSimulationsDone() const { return NumSimulationsDone; }
    
 	private:
 		uint* counts;
@@ -43,6 +46,7 @@ public:
 	
 		//SBOSS-specific
 		bool do_sample;
+		bool* resample; //(s,a) pairs to resample
 		
 		double* postCounts;
 		double* postCountsSum;
@@ -50,10 +54,10 @@ public:
 		double* postCountsSumLastResample;
 		PARAMS Params;
 		
-		//Merged model
-		uint Am;	
-		double* Pm;
-		double* Rm;
+		//Merged model: Km[s*A+a] sampled T(s,a,.), stored
+		//contiguously in Pm[s*A+a]
+		uint* Km;
+		double** Pm;
 		uint* RLPI;
 		double* V;
 		
@@ -61,10 +65,13 @@ public:
 		
 
 		//Cached values
-		uint S,A,SA,SAS,SAm;
+		uint S,A,SA,SAS;
 
 		SamplerFactory& SampFact;
 
+		//Number of value iteration sweeps performed
+		unsigned long NumSimulationsDone;
+
           void updateK(uint state, uint action);
 };
 
@@ -1,6 +1,7 @@
 #include "bamcp.h"
 #include <math.h>
 #include "../../../utils/guez_utils.h"
+#include "../../../../../../../Utils/src/Profiler.h"
 #include <algorithm>
 
 #include <iomanip>
@@ -29,7 +30,9 @@ BAMCP::PARAMS::PARAMS()
     ExplorationConstant(1),
 		ReuseTree(false),
 		RB(-1),
-		eps(1)
+		eps(1),
+		ReuseSamples(false),
+		MsPerAction(0)
 {
 }
 
@@ -38,6 +41,7 @@ BAMCP::BAMCP(const SIMULATOR& simulator, const PARAMS& params,
 :   Params(params),
 		Simulator(simulator),
     TreeDepth(0),
+    NumSimulationsDone(0),
 		SampFact(sampFact)
 {
     VNODE::NumChildren = Simulator.GetNumActions();
@@ -70,6 +74,9 @@ BAMCP::BAMCP(const SIMULATOR& simulator, const PARAMS& params,
 		for (uint i = 0; i < SAS; ++i) { counts[i] = 0; }
           postCounts = sampFact.getPostCounts(counts, S, A);
 	
+		Stale = new bool[SA];
+		std::fill(Stale,Stale+SA,false);
+
 		step = 0;
   
 
@@ -84,6 +91,9 @@ BAMCP::~BAMCP()
  
 	delete[] RLPI;
 	delete[] V;
+
+	ClearSamples(0);
+	delete[] Stale;
 	
 	delete[] Q;
 	for(uint s=0;s<S;++s)
@@ -103,6 +113,12 @@ bool BAMCP::Update(uint ss, uint aa, uint observation, double reward)
 		postCounts[ss*SA+S*aa+observation] += 1;
 		SampFact.updateCounts(ss,aa,observation);	
 
+		//The kept samples of this row are no longer valid
+		if(Params.ReuseSamples && !Stale[ss*A+aa]){
+			Stale[ss*A+aa] = true;
+			StaleRows.push_back(ss*A+aa);
+		}
+
     //Q value update
 		Q[ss*A+aa] += QlearningRate*(reward + Simulator.GetDiscount()*Q[observation*A+GreedyA[observation]->at(0)] - Q[ss*A+aa]);
     //Update GreedyA
@@ -153,14 +169,34 @@ void BAMCP::UCTSearch(uint state)
 		double* parm = 0;
 		double* p_samp = 0;
 		Sampler* MDPSampler = 0;
-		MDPSampler = SampFact.getMDPSampler(counts,S,A,
-				Simulator.R,Simulator.rsas,Simulator.GetDiscount());
+		std::vector<Sampler*> rowSamplers;
+		if(Params.ReuseSamples)
+			rowSamplers.resize(SA,(Sampler*) 0);
+		else{
+			PROFILE_SCOPE("BAMCP::sampling");
+			MDPSampler = SampFact.getMDPSampler(counts,S,A,
+					Simulator.R,Simulator.rsas,Simulator.GetDiscount());
+		}
     
+		//With a time budget, simulate until the deadline (at least once)
+		//instead of NumSimulations times
+		double deadline = 0;
+		if(Params.MsPerAction > 0)
+			deadline = guez_utils::getMonotonicTime() + Params.MsPerAction;
 			
-    for (int n = 0; n < Params.NumSimulations; n++)
+		int n;
+    for (n = 0; Params.MsPerAction > 0 ? (n == 0
+				|| guez_utils::getMonotonicTime() < deadline)
+				: n < Params.NumSimulations; n++)
     {
 				SIMULATOR* mdp;	
-				mdp = MDPSampler->updateMDPSample();
+				{
+					PROFILE_SCOPE("BAMCP::sampling");
+					if(Params.ReuseSamples)
+						mdp = ReuseMDPSample(n,rowSamplers);
+					else
+						mdp = MDPSampler->updateMDPSample();
+				}
 
 				Status.Phase = SIMULATOR::STATUS::TREE;
 
@@ -172,7 +208,11 @@ void BAMCP::UCTSearch(uint state)
         TreeDepth = 0;
         PeakTreeDepth = 0;
         
-				double totalReward = SimulateV(mdp, state, Root);
+				double totalReward;
+				{
+					PROFILE_SCOPE("BAMCP::tree");
+					totalReward = SimulateV(mdp, state, Root);
+				}
         StatTotalReward.Add(totalReward);
         StatTreeDepth.Add(PeakTreeDepth);
 
@@ -183,10 +223,56 @@ void BAMCP::UCTSearch(uint state)
 
         History.Truncate(historyDepth);
 		}
+		NumSimulationsDone += n;
+		PROFILE_COUNT("BAMCP::simulations", n);
 		delete MDPSampler;
+		if(Params.ReuseSamples){
+			for(uint i=0;i<SA;++i)
+				delete rowSamplers[i];
+			//Every kept sample is now up-to-date
+			ClearSamples(n);
+			for(uint j=0;j<StaleRows.size();++j)
+				Stale[StaleRows[j]] = false;
+			StaleRows.clear();
+		}
     DisplayStatistics(cout);
 }
 
+//Return the n-th posterior sample of the search. The kept sample of the
+//previous search is reused, and only its stale rows are redrawn (the rows
+//of a Dirichlet posterior are independent).
+SIMULATOR* BAMCP::ReuseMDPSample(uint n, std::vector<Sampler*>& rowSamplers)
+{
+		bool newSample = (n == SampleMDP.size());
+		if(newSample){
+			SampleT.push_back(new double[SAS]);
+			SampleMDP.push_back(new BasicMDP(S,A,Simulator.GetDiscount(),
+					Simulator.R,Simulator.rsas,SampleT.back()));
+		}
+
+		uint nbRows = newSample ? SA : StaleRows.size();
+		for(uint j=0;j<nbRows;++j){
+			uint i = newSample ? j : StaleRows[j];
+			if(!rowSamplers[i])
+				rowSamplers[i] = SampFact.getTransitionParamSampler(counts+i*S,i/A,i%A,S);
+			rowSamplers[i]->getNextTParamSample(SampleT[n]+i*S);
+		}
+		return SampleMDP[n];
+}
+
+//Forget the kept posterior samples, from the n-th one
+void BAMCP::ClearSamples(uint n)
+{
+		for(uint i=n;i<SampleMDP.size();++i){
+			delete SampleMDP[i];
+			delete[] SampleT[i];
+		}
+		if(n < SampleMDP.size()){
+			SampleMDP.resize(n);
+			SampleT.resize(n);
+		}
+}
+
 double BAMCP::SimulateV(const SIMULATOR* mdp, uint state, VNODE* vnode)
 {
     uint action = GreedyUCB(vnode, true);
@@ -273,7 +359,7 @@ VNODE* BAMCP::ExpandNode()
 
 int BAMCP::GreedyUCB(VNODE* vnode, bool ucb) const
 {
-    static std::vector<int> besta;
+    std::vector<int>& besta = GreedyTies;
     besta.clear();
     double bestq = -Infinity;
     int N = vnode->Value.GetCount();
@@ -306,6 +392,7 @@ int BAMCP::GreedyUCB(VNODE* vnode, bool ucb) const
 
 double BAMCP::Rollout(const SIMULATOR* mdp, uint state)
 {
+    PROFILE_SCOPE("BAMCP::rollout");
     Status.Phase = SIMULATOR::STATUS::ROLLOUT;
     if (Params.Verbose >= 3)
         cout << "Starting rollout" << endl;
@@ -319,11 +406,11 @@ double BAMCP::Rollout(const SIMULATOR* mdp, uint state)
     {
         uint observation;
         double reward;
-				if(guez_utils::rng.rand_closed01() < Params.eps)
+				if(guez_utils::getRNG().rand_closed01() < Params.eps)
 					action = mdp->SelectRandom(state, Status);
 				else{
 
-					action = GreedyA[state]->at(rand() % GreedyA[state]->size());
+					action = GreedyA[state]->at(guez_utils::randInt() % GreedyA[state]->size());
 				}
         terminal = mdp->Step(state, action, observation, reward);
         History.Add(action, observation);
@@ -20,6 +20,7 @@
 class VNODE;
 class QNODE;
 class SamplerFactory;
+class Sampler;
 
 class BAMCP
 {
@@ -38,6 +39,8 @@ public:
         bool ReuseTree;
 				int RB;
 				double eps;
+				bool ReuseSamples;
+				double MsPerAction;
     };
 
     BAMCP(const SIMULATOR& simulator, const PARAMS& params,SamplerFactory& sampFact);
@@ -60,6 +63,8 @@ public:
 
     static void InitFastUCB(double exploration);
 
+    unsigned long GetNumSimulationsDone() const { return NumSimulationsDone; }
+
 private:
 		uint* counts;
 		double* postCounts;
@@ -72,11 +77,19 @@ private:
     HISTORY History;
     SIMULATOR::STATUS Status;
     int TreeDepth, PeakTreeDepth;
+    unsigned long NumSimulationsDone;
 		
 		SamplerFactory& SampFact;
 
 		uint* RLPI;
 		double* V;
+
+		//Posterior samples kept from one search to the next
+		//(ReuseSamples), and the (s,a) rows updated since
+		std::vector<double*> SampleT;
+		std::vector<SIMULATOR*> SampleMDP;
+		std::vector<uint> StaleRows;
+		bool* Stale;
 		
 		double* Q;
     double QlearningRate;
@@ -86,12 +99,18 @@ private:
     STATISTIC StatRolloutDepth;
     STATISTIC StatTotalReward;
 
+    //Ties of GreedyUCB (per planner: several planners may run in
+    //concurrent simulations)
+    mutable std::vector<int> GreedyTies;
+
     int GreedyUCB(VNODE* vnode, bool ucb) const;
     int SelectRandom() const;
     double SimulateV(const SIMULATOR* senv, uint state, VNODE* vnode);
     double SimulateQ(const SIMULATOR* senv, uint state, QNODE& qnode, uint action);
     
     VNODE* ExpandNode();
+    SIMULATOR* ReuseMDPSample(uint n, std::vector<Sampler*>& rowSamplers);
+    void ClearSamples(uint n);
 
     // Fast lookup table for UCB
     //static const int UCB_N = 10000, UCB_n = 100;
@@ -267,7 +267,7 @@ VNODE* BAUCT::ExpandNode()
 
 int BAUCT::GreedyUCB(VNODE* vnode, bool ucb) const
 {
-    static std::vector<int> besta;
+    std::vector<int>& besta = GreedyTies;
     besta.clear();
     double bestq = -Infinity;
     int N = vnode->Value.GetCount();
@@ -313,11 +313,11 @@ double BAUCT::Rollout(uint state)
     {
         uint observation;
         double reward;
-				if(guez_utils::rng.rand_closed01() < Params.eps)
+				if(guez_utils::getRNG().rand_closed01() < Params.eps)
 					action = Simulator.SelectRandom(state, Status);
 				else{
 
-					action = GreedyA[state]->at(rand() % GreedyA[state]->size());
+					action = GreedyA[state]->at(guez_utils::randInt() % GreedyA[state]->size());
 				}
 				
 				uint ii = state*SA+action*S;
@@ -103,6 +103,10 @@ public:
     STATISTIC StatRolloutDepth;
     STATISTIC StatTotalReward;
 
+    //Ties of GreedyUCB (per planner: several planners may run in
+    //concurrent simulations)
+    mutable std::vector<int> GreedyTies;
+
     int GreedyUCB(VNODE* vnode, bool ucb) const;
     int SelectRandom() const;
     double SimulateV(uint state, VNODE* vnode);
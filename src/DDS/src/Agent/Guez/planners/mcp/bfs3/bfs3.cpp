@@ -1,9 +1,9 @@
 #include "bfs3.h"
 #include <math.h>
 #include "../../../utils/guez_utils.h"
+#include "../../../../../../../Utils/src/Profiler.h"
 #include <algorithm>
 
-#include <map>
 #include "../../../samplers/sampler.h"
 #include "../../../envs/simulator.h"
 #include "../../../samplers/samplerFactory.h"
@@ -13,6 +13,9 @@
 using namespace std;
 using namespace UTILS;
 
+//Marks an empty slot of the planning counts overlay
+static const uint NO_KEY = (uint) -1;
+
 //-----------------------------------------------------------------------------
 
 BFS3::PARAMS::PARAMS()
@@ -22,7 +25,8 @@ BFS3::PARAMS::PARAMS()
 		N(10),  //Number of trajectories
 		gamma(0.95),
 		Vmin(0),
-		Vmax(1/(1-0.95))
+		Vmax(1/(1-0.95)),
+		MsPerAction(0)
 {
 }
 
@@ -30,7 +34,9 @@ BFS3::BFS3(const SIMULATOR& simulator, const PARAMS& params, SamplerFactory& sam
 :   Params(params),
 		Simulator(simulator),
 		SampFact(sampFact),
-    TreeDepth(0)
+    TreeDepth(0),
+		FSSSDeadline(0),
+		NumSimulationsDone(0)
 {
     VNODE3::NumChildren = Simulator.GetNumActions();
 		Root = 0;
@@ -44,13 +50,34 @@ BFS3::BFS3(const SIMULATOR& simulator, const PARAMS& params, SamplerFactory& sam
 		for(uint c=0;c<SAS;++c){
 			counts[c] = 0;
 		}
-		pcounts = new uint[SAS];
+		
+		//Planning counts overlay: a rollout touches at most D+1 entries
+		uint maxTouched = min(Params.D, SAS - 1) + 1;
+		uint capacity = 16;
+		while(capacity < 2*maxTouched)
+			capacity <<= 1;
+		deltaKeys = new uint[capacity];
+		std::fill(deltaKeys,deltaKeys+capacity,NO_KEY);
+		deltaCounts = new uint[capacity];
+		deltaTouched = new uint[capacity];
+		nDeltaTouched = 0;
+		deltaMask = capacity - 1;
+		pcountsRow = new uint[S];
+
+		samplers = new Sampler*[SA];
+		std::fill(samplers,samplers+SA,(Sampler*) 0);
 }
 
 BFS3::~BFS3()
 {
 	delete[] counts;
-	delete[] pcounts;
+	delete[] deltaKeys;
+	delete[] deltaCounts;
+	delete[] deltaTouched;
+	delete[] pcountsRow;
+	for(uint i=0;i<SA;++i)
+		delete samplers[i];
+	delete[] samplers;
 	VNODE3::FreeAll();
 }
 
@@ -62,6 +89,9 @@ bool BFS3::Update(uint state, uint action, uint observation, double)
 		//Update posterior
 		counts[state*SA+S*action+observation] += 1;
 		SampFact.updateCounts(state,action,observation);
+
+		delete samplers[state*A+action];
+		samplers[state*A+action] = 0;
     
 		return true;
 }
@@ -79,6 +109,60 @@ bool BFS3::Update(uint state, uint action, uint observation, double)
 //
 //}
 
+//Increment the planning count of entry 'ind' (= s*SA+a*S+sp)
+void BFS3::addPlanningCount(uint ind){
+	uint h = ((ind*2654435761u) ^ (ind >> 16)) & deltaMask;
+	while(deltaKeys[h] != ind && deltaKeys[h] != NO_KEY)
+		h = (h+1) & deltaMask;
+
+	if(deltaKeys[h] == NO_KEY){
+		deltaKeys[h] = ind;
+		deltaCounts[h] = 1;
+		deltaTouched[nDeltaTouched++] = h;
+	}
+	else
+		deltaCounts[h] += 1;
+}
+
+//Planning counts <- real counts
+void BFS3::clearPlanningCounts(){
+	for(uint i=0;i<nDeltaTouched;++i)
+		deltaKeys[deltaTouched[i]] = NO_KEY;
+	nDeltaTouched = 0;
+}
+
+//Whether the planning counts of the S entries starting at 'ii' (= s*SA+a*S)
+//differ from the real counts
+bool BFS3::hasPlanningCounts(uint ii) const{
+	for(uint i=0;i<nDeltaTouched;++i){
+		uint ind = deltaKeys[deltaTouched[i]];
+		if(ind >= ii && ind < ii+S)
+			return true;
+	}
+	return false;
+}
+
+//Planning counts of the S entries starting at 'ii' (= s*SA+a*S)
+//Valid until the next call
+const uint* BFS3::getPlanningCounts(uint ii){
+	memcpy(pcountsRow,counts+ii,S*sizeof(uint));
+	for(uint i=0;i<nDeltaTouched;++i){
+		uint ind = deltaKeys[deltaTouched[i]];
+		if(ind >= ii && ind < ii+S)
+			pcountsRow[ind-ii] += deltaCounts[deltaTouched[i]];
+	}
+	return pcountsRow;
+}
+
+//Next-state sampler of (state,aa) on the real counts
+//Owned by BFS3
+Sampler* BFS3::getTransitionSampler(uint state, uint aa){
+	Sampler*& sampler = samplers[state*A+aa];
+	if(!sampler)
+		sampler = SampFact.getTransitionSampler(counts+state*SA+aa*S,state,aa,S);
+	return sampler;
+}
+
 inline double BFS3::getReward(uint ss, uint aa, uint sp){
 	if(Simulator.rsas)
 		return Simulator.R[ss*SA+aa*S+sp];
@@ -94,14 +178,21 @@ uint BFS3::SelectAction(uint state)
 	std::vector<uint> besta;
 	double bestq = -std::numeric_limits<double>::max();
 
+	//With a time budget, each of the A*C FSSS calls gets an equal slice
+	//of it (the time left by a call is carried over to the next ones)
+	double start = 0, slice = 0;
+	if(Params.MsPerAction > 0){
+		start = guez_utils::getMonotonicTime();
+		slice = Params.MsPerAction/(A*Params.C);
+	}
+
 	for(uint aa=0; aa < A; ++aa){
 
 		double qa = 0;
 
 		//Construct T(s,a) //TODO include prior in counts to avoid doing that?
-		uint ii = state*SA+aa*S;
 		//Get a next-state sampler from the factory
-		Sampler* nextSSampler = SampFact.getTransitionSampler(counts+ii,state,aa,S);
+		Sampler* nextSSampler = getTransitionSampler(state,aa);
 
 		uint sp;
 		for(uint c=0; c < Params.C; ++c){
@@ -118,6 +209,8 @@ uint BFS3::SelectAction(uint state)
 
 			}
 			//MTS using FSSS in belief-MDP
+			if(Params.MsPerAction > 0)
+				FSSSDeadline = start + (aa*Params.C+c+1)*slice;
 			double totalReward = FSSS(state,aa,sp);
 
 			qa += (getReward(state,aa,sp) 
@@ -125,12 +218,10 @@ uint BFS3::SelectAction(uint state)
 			
 			//History.Truncate(historyDepth);
 			// Delete old tree and create new root
-			VNODE3::FreeAll();
+			VNODE3::RecycleAll();
 			Root = 0;
 		}
 
-		delete nextSSampler;
-
 		if(qa > bestq){
 			bestq = qa;
 			besta.clear();
@@ -144,16 +235,24 @@ uint BFS3::SelectAction(uint state)
 			cout << "Reward for action " << aa << " = " << qa << endl;
 
 	}
-	return besta[rand() % besta.size()];	
+	return besta[guez_utils::randInt() % besta.size()];	
 }
 
 double BFS3::FSSS(uint prevs, uint aa, uint state){
-	for(uint n=0;n<Params.N;++n){
-		//Copy current counts into planning counts
-		memcpy(pcounts,counts,SAS*sizeof(uint));
-		pcounts[prevs*SA+aa*S+state] += 1;
+	PROFILE_SCOPE("BFS3::FSSS");
+	//With a time budget, roll out until the deadline (at least once)
+	//instead of N times
+	uint n;
+	for(n=0;Params.MsPerAction > 0 ? (n == 0
+			|| guez_utils::getMonotonicTime() < FSSSDeadline)
+			: n < Params.N;++n){
+		//Reset planning counts to the current counts
+		clearPlanningCounts();
+		addPlanningCount(prevs*SA+aa*S+state);
 		FSSSRollout(Root,state,0);	
 	}
+	NumSimulationsDone += n;
+	PROFILE_COUNT("BFS3::rollouts", n);
 	//return max_a U(s,a) at Root
 	return Root->Us;
 }
@@ -169,16 +268,16 @@ void BFS3::FSSSRollout(VNODE3*& vnode, uint state, uint depth){
 	uint a = vnode->bestA();
 	QNODE3& qnode = vnode->Child(a);
 	//Select transition optimisticaly
-	map<uint,VNODE3Pc>::iterator nextVNode = qnode.selectPath(Params.Vmax,Params.Vmin);
+	VNODE3Pc& nextVNode = qnode.selectPath(Params.Vmax,Params.Vmin);
 
 	if(Params.Verbose >= 2){
 		std::cout << "D: " << depth << " a: " << a << " sp: " 
-			<< nextVNode->first << std::endl; 
+			<< nextVNode.s << std::endl; 
 	}
 
-	//Update pcounts
-	pcounts[state*SA+a*S+nextVNode->first] += 1;
-	FSSSRollout(nextVNode->second.v,nextVNode->first,depth+1);
+	//Update planning counts
+	addPlanningCount(state*SA+a*S+nextVNode.s);
+	FSSSRollout(nextVNode.v,nextVNode.s,depth+1);
 	bellmanBackup(vnode, a, state);
 }
 
@@ -186,16 +285,16 @@ void BFS3::FSSSRollout(VNODE3*& vnode, uint state, uint depth){
 void BFS3::getQNodeValue(QNODE3& qnode, double& Usa, double& Lsa, uint ss, uint aa){
 	Usa = 0;
 	Lsa = 0;
-	map<uint,VNODE3Pc>::iterator it;
+	vector<VNODE3Pc>::iterator it;
 	for(it=qnode.Children.begin();it != qnode.Children.end(); it++){
-		if(it->second.v == 0){
-			Usa += (getReward(ss,aa,it->first)+Params.gamma*Params.Vmax)*it->second.count/qnode.C;
-			Lsa += (getReward(ss,aa,it->first)+Params.gamma*Params.Vmin)*it->second.count/qnode.C;
-			//std::cout << "Not explored: " << it->second.count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
+		if(it->v == 0){
+			Usa += (getReward(ss,aa,it->s)+Params.gamma*Params.Vmax)*it->count/qnode.C;
+			Lsa += (getReward(ss,aa,it->s)+Params.gamma*Params.Vmin)*it->count/qnode.C;
+			//std::cout << "Not explored: " << it->count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
 		}else{
-			Usa += (getReward(ss,aa,it->first)+Params.gamma*it->second.v->Us)*it->second.count/qnode.C;
-			Lsa += (getReward(ss,aa,it->first)+Params.gamma*it->second.v->Ls)*it->second.count/qnode.C;
-			//std::cout << "Explored: " << it->second.count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
+			Usa += (getReward(ss,aa,it->s)+Params.gamma*it->v->Us)*it->count/qnode.C;
+			Lsa += (getReward(ss,aa,it->s)+Params.gamma*it->v->Ls)*it->count/qnode.C;
+			//std::cout << "Explored: " << it->count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
 		}
 	}
 }
@@ -204,7 +303,7 @@ void BFS3::getQNodeValue(QNODE3& qnode, double& Usa, double& Lsa, uint ss, uint
 //void BFS3::bellmanBackup(VNODE3* vnode, int action, uint s){
 void BFS3::bellmanBackup(VNODE3* vnode, int, uint s){
 
-	map<uint,VNODE3Pc>::iterator it;
+	vector<VNODE3Pc>::iterator it;
 	double maxU = Params.Vmin;
 	double maxL = Params.Vmin;
 	for(int aa=0;aa<vnode->NumChildren;++aa){
@@ -212,14 +311,14 @@ void BFS3::bellmanBackup(VNODE3* vnode, int, uint s){
 		qnode.Usa = 0;
 		qnode.Lsa = 0;
 		for(it=qnode.Children.begin();it != qnode.Children.end(); it++){
-			if(it->second.v == 0){
-				qnode.Usa += (getReward(s,aa,it->first)+Params.gamma*Params.Vmax)*it->second.count/qnode.C;
-				qnode.Lsa += (getReward(s,aa,it->first)+Params.gamma*Params.Vmin)*it->second.count/qnode.C;
-				//std::cout << "Not explored: " << it->second.count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
+			if(it->v == 0){
+				qnode.Usa += (getReward(s,aa,it->s)+Params.gamma*Params.Vmax)*it->count/qnode.C;
+				qnode.Lsa += (getReward(s,aa,it->s)+Params.gamma*Params.Vmin)*it->count/qnode.C;
+				//std::cout << "Not explored: " << it->count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
 			}else{
-				qnode.Usa += (getReward(s,aa,it->first)+Params.gamma*it->second.v->Us)*it->second.count/qnode.C;
-				qnode.Lsa += (getReward(s,aa,it->first)+Params.gamma*it->second.v->Ls)*it->second.count/qnode.C;
-				//std::cout << "Explored: " << it->second.count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
+				qnode.Usa += (getReward(s,aa,it->s)+Params.gamma*it->v->Us)*it->count/qnode.C;
+				qnode.Lsa += (getReward(s,aa,it->s)+Params.gamma*it->v->Ls)*it->count/qnode.C;
+				//std::cout << "Explored: " << it->count << " " << qnode.Usa << " " << qnode.Lsa << std::endl;
 			}
 		}
 
@@ -252,7 +351,11 @@ VNODE3* BFS3::ExpandNode(uint state)
 
 		//Construct T(s,a)
 		uint ii = state*SA+aa*S;
-		Sampler* nextSSampler = SampFact.getTransitionSampler(pcounts+ii,state,aa,S);
+		Sampler* nextSSampler;
+		if(hasPlanningCounts(ii))
+			nextSSampler = SampFact.getTransitionSampler(getPlanningCounts(ii),state,aa,S);
+		else
+			nextSSampler = getTransitionSampler(state,aa);
 
 		uint sp;
 		for(uint c=0; c < Params.C; ++c){
@@ -260,7 +363,8 @@ VNODE3* BFS3::ExpandNode(uint state)
 			sp =  nextSSampler->getNextStateSample();
 			vnode->Child(aa).Add(sp);
 		}
-		delete nextSSampler;
+		if(nextSSampler != samplers[state*A+aa])
+			delete nextSSampler;
 	}
 	return vnode;
 }
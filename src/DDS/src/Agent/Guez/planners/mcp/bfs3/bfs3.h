@@ -11,6 +11,7 @@
 
 class SIMULATOR;
 class SamplerFactory;
+class Sampler;
 class VNODE3;
 class QNODE3;
 
@@ -31,6 +32,7 @@ public:
 				double gamma;
 				double Vmin;
 				double Vmax;
+				double MsPerAction;
     };
 
     BFS3(const SIMULATOR& simulator, const PARAMS& params,
@@ -42,6 +44,8 @@ public:
     bool Update(uint state, uint action, uint observation, double reward);
 		void bellmanBackup(VNODE3* vnode, int action, uint s);
 
+		unsigned long GetNumSimulationsDone() const { return NumSimulationsDone; }
+
 
 
 private:
@@ -51,9 +55,30 @@ private:
 		VNODE3* ExpandNode(uint state); 
 	
 		void getQNodeValue(QNODE3& qnode, double& Usa, double& Lsa, uint ss,uint aa);
+
+		//Planning counts: sparse overlay on top of the real counts
+		void addPlanningCount(uint ind);
+		void clearPlanningCounts();
+		bool hasPlanningCounts(uint ii) const;
+		const uint* getPlanningCounts(uint ii);
+
+		Sampler* getTransitionSampler(uint state, uint aa);
 		
 		uint* counts;
-		uint* pcounts;
+
+		//Open-addressed (key,delta) buffer, reset in O(touched)
+		uint* deltaKeys;
+		uint* deltaCounts;
+		uint* deltaTouched;
+		uint nDeltaTouched;
+		uint deltaMask;
+
+		//Planning counts of a single (s,a), materialized on demand
+		uint* pcountsRow;
+
+		//Next-state samplers on the real counts, one per (s,a)
+		//(created on demand, invalidated by Update())
+		Sampler** samplers;
 		//Cached values
 		uint S,A,SA,SAS;
 
@@ -65,5 +90,9 @@ private:
 		SamplerFactory& SampFact;
 
     int TreeDepth, PeakTreeDepth;
+
+		//Deadline of the current FSSS call (MsPerAction > 0 only)
+		double FSSSDeadline;
+		unsigned long NumSimulationsDone;
 };
 
@@ -1,48 +1,65 @@
  #include "node.h"
 #include "../../../utils/utils2.h"
 #include <limits>
+#include <algorithm>
 
 using namespace std;
 
 //-----------------------------------------------------------------------------
 
 
+static bool lessState(const VNODE3Pc& node, uint s){
+	return node.s < s;
+}
+
 void QNODE3::Add(uint child){
 	C++;
-	map<uint,VNODE3Pc>::iterator it;
-	it = Children.find(child);
-	if(it == Children.end()){
+	vector<VNODE3Pc>::iterator it;
+	it = lower_bound(Children.begin(),Children.end(),child,lessState);
+	if(it == Children.end() || it->s != child){
 		VNODE3Pc node;
+		node.s = child;
 		node.v = 0; 
 		node.count = 1;
-		Children.insert(pair<uint,VNODE3Pc>(child,node));
+		Children.insert(it,node);
 	}
 	else
-		it->second.count += 1;
+		it->count += 1;
 }
 
-map<uint,VNODE3Pc>::iterator QNODE3::selectPath(double Vmax,double Vmin){	
+VNODE3Pc& QNODE3::selectPath(double Vmax,double Vmin){	
+	//First pass: best value and number of ties
 	double bestDiff = 0;
-	vector<map<uint,VNODE3Pc>::iterator> bestVNODE3;
-	
-	map<uint,VNODE3Pc>::iterator it;
-	for(it=Children.begin();it != Children.end(); it++){
+	uint nBest = 0;
+	for(uint i=0;i<Children.size();++i){
 		double diff;	
-		if(it->second.v == 0){
-			diff = (Vmax - Vmin)*it->second.count;	
+		if(Children[i].v == 0){
+			diff = (Vmax - Vmin)*Children[i].count;	
 		}else{
-			diff = (it->second.v->Us-it->second.v->Ls)*it->second.count;
+			diff = (Children[i].v->Us-Children[i].v->Ls)*Children[i].count;
 		}	
 		if(diff > bestDiff){
 			bestDiff = diff;
-			bestVNODE3.clear();
-			bestVNODE3.push_back(it);
+			nBest = 1;
 		}
 		else if(diff == bestDiff){
-			bestVNODE3.push_back(it);
+			++nBest;
 		}
 	}
-	return bestVNODE3[rand() % bestVNODE3.size()];
+	//Second pass: pick the k-th tie
+	uint k = guez_utils::randInt() % nBest;
+	uint i = 0;
+	for(;;++i){
+		double diff;	
+		if(Children[i].v == 0){
+			diff = (Vmax - Vmin)*Children[i].count;	
+		}else{
+			diff = (Children[i].v->Us-Children[i].v->Ls)*Children[i].count;
+		}	
+		if(diff == bestDiff && k-- == 0)
+			break;
+	}
+	return Children[i];
 }
 //-----------------------------------------------------------------------------
 
@@ -54,6 +71,11 @@ void VNODE3::Initialise()
 {
     assert(NumChildren);
     Children.resize(VNODE3::NumChildren);
+    for (int action = 0; action < NumChildren; action++)
+    {
+        Children[action].C = 0;
+        Children[action].Children.clear();
+    }
 }
 
 VNODE3* VNODE3::Create()
@@ -65,12 +87,11 @@ VNODE3* VNODE3::Create()
 
 void VNODE3::Free(VNODE3* vnode)
 {
-		map<uint,VNODE3Pc>::iterator it;
     for (int action = 0; action < VNODE3::NumChildren; action++){
 			QNODE3& qnode = Children[action];
-			for(it=qnode.Children.begin();it != qnode.Children.end(); it++){
-        if (it->second.v)
-					Free(it->second.v);
+			for(uint i=0;i<qnode.Children.size();++i){
+        if (qnode.Children[i].v)
+					Free(qnode.Children[i].v);
 				}
 		}
     VNodePool.Free(vnode);
@@ -81,24 +102,34 @@ void VNODE3::FreeAll()
 	VNodePool.DeleteAll();
 }
 
+//Same as FreeAll(), but the memory is kept for the next trees
+void VNODE3::RecycleAll()
+{
+	VNodePool.FreeAll();
+}
+
 uint VNODE3::bestA(){
-	vector<uint> besta;
 	double bestq = -std::numeric_limits<double>::max();
+	uint nBest = 0;
 	for(int aa=0;aa<NumChildren;++aa){
-		QNODE3& qnode = Children[aa];
-		double qa = qnode.Usa;
+		double qa = Children[aa].Usa;
 		if(qa > bestq){
 			bestq = qa;
-			besta.clear();
-			besta.push_back(aa);
+			nBest = 1;
 		}
 		else if(qa == bestq)
-			besta.push_back(aa);
+			++nBest;
 
 		//std::cout << "Us," << aa << ": " << qa << std::endl;
 	}
 	
-	return besta[rand() % besta.size()];
+	uint k = guez_utils::randInt() % nBest;
+	int aa = 0;
+	for(;;++aa){
+		if(Children[aa].Usa == bestq && k-- == 0)
+			break;
+	}
+	return aa;
 }
 
 void VNODE3::SetChildren(double Usa, double Lsa)
@@ -2,7 +2,7 @@
 
 
 #include "../../../utils/utils2.h"
-#include <map>
+#include <vector>
 
 typedef unsigned int uint;
 class HISTORY;
@@ -11,6 +11,7 @@ class QNODE3;
 class VNODE3;
 
 struct VNODE3Pc{
+	uint s;
 	VNODE3* v;
 	uint count;
 };
@@ -28,9 +29,10 @@ public:
 		QNODE3(){C=0;}
 		void Add(uint key);
 		
-		std::map<uint,VNODE3Pc>::iterator selectPath(double max,double min);
+		VNODE3Pc& selectPath(double max,double min);
 
-		std::map<uint,VNODE3Pc> Children;
+		//Sampled next states, sorted by state
+		std::vector<VNODE3Pc> Children;
 
 };
 
@@ -49,6 +51,7 @@ public:
     static VNODE3* Create();
     void Free(VNODE3* vnode);
     static void FreeAll();
+    static void RecycleAll();
 
     QNODE3& Child(int c) { return Children[c]; }
     const QNODE3& Child(int c) const { return Children[c]; }
@@ -15,7 +15,7 @@ FDMTransitionSampler::~FDMTransitionSampler()
 }
 uint FDMTransitionSampler::getNextStateSample(){
 	uint sp;
-	guez_utils::rng.multinom(P,S,sp);
+	guez_utils::getRNG().multinom(P,S,sp);
 	return sp;	
 }
 
@@ -16,7 +16,7 @@ SFDMTransitionSampler::~SFDMTransitionSampler()
 }
 uint SFDMTransitionSampler::getNextStateSample(){
 	uint sp;
-	guez_utils::rng.multinom(P,S,sp);
+	guez_utils::getRNG().multinom(P,S,sp);
 	return sp;	
 }
 
@@ -41,7 +41,7 @@ void SFDMTransitionParamSampler::getNextTParamSample(double* P){
 	
 	//  sample kd ~ PkD
 	uint kd;
-	guez_utils::rng.multinom(pFact->PkD[ind],S,kd);
+	guez_utils::getRNG().multinom(pFact->PkD[ind],S,kd);
 	kd = kd + 1;
 	//  sample Vd 
   //  (i.e. want kd-K0 elements not in SIG0)
@@ -51,7 +51,7 @@ void SFDMTransitionParamSampler::getNextTParamSample(double* P){
 	uint n;
 	uint tmp;
 	for(uint i=0; i < std::min((size_t)S,kd+pFact->SIG0[ind]->size()); i++){
-		n = rand() % (S-i);
+		n = guez_utils::randInt() % (S-i);
 		tmp = pFact->ordering[n];
 		pFact->ordering[n] = pFact->ordering[i];
 		pFact->ordering[i] = tmp;
@@ -112,7 +112,7 @@ SIMULATOR* SFDMMDPSampler::updateMDPSample(){
 			
 			//  sample kd ~ PkD
 			uint kd;
-			guez_utils::rng.multinom(pFact->PkD[ind],S,kd);
+			guez_utils::getRNG().multinom(pFact->PkD[ind],S,kd);
 			kd = kd + 1;
 			//  sample Vd 
 			//  (i.e. want kd-K0 elements not in SIG0)
@@ -121,7 +121,7 @@ SIMULATOR* SFDMMDPSampler::updateMDPSample(){
 			uint n;
 			uint tmp;
 			for(uint i=0; i < std::min((size_t)S,kd+pFact->SIG0[ind]->size()); i++){
-				n = rand() % (S-i);
+				n = guez_utils::randInt() % (S-i);
 				tmp = pFact->ordering[n];
 				pFact->ordering[n] = pFact->ordering[i];
 				pFact->ordering[i] = tmp;
@@ -1,5 +1,10 @@
 #include "guez_utils.h"
 
+#include <new>		//	for the placement 'new'
+#include <time.h>	//	for 'clock_gettime()'
+#include "../../../../../Utils/src/RandomGen.h"
+#include "../../../../../Utils/src/Profiler.h"
+
 //	TODO
 #ifdef BOOST_FOUND
 namespace fs = boost::filesystem;
@@ -12,7 +17,15 @@ using namespace std;
 //	TODO
 
 
-RNG guez_utils::rng;
+//	The generator of each thread and the state of its 'rand_r()' stream
+//	(see 'setSeed()').
+//	RNG has a trivial destructor: it is built in place in the storage of the
+//	thread, so that short-lived threads do not leak it.
+union RNGStorage { ulong align; char data[sizeof(RNG)]; };
+
+static __thread RNGStorage threadRNGStorage;
+static __thread RNG* threadRNG = 0;
+static __thread unsigned int threadRandState = 0;
 
 
 void guez_utils::printA(double*v , size_t s){
@@ -127,7 +140,28 @@ double guez_utils::KLdiv(const vector<double>& p, const vector<double>& q){
 }
 
 
-void guez_utils::setSeed(ulong _x){srand(_x);rng = RNG(_x);}
+void guez_utils::setSeed(ulong _x){
+	threadRNG = new (threadRNGStorage.data) RNG(_x);
+	threadRandState = (unsigned int) _x;
+}
+
+RNG& guez_utils::getRNG(){
+	if(!threadRNG)
+		setSeed(utils::RandomGen::randIntRange_Uniform(0, INT_MAX));
+	return *threadRNG;
+}
+
+int guez_utils::randInt(){
+	if(!threadRNG)
+		getRNG();
+	return rand_r(&threadRandState);
+}
+
+double guez_utils::getMonotonicTime(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000.0 + ts.tv_nsec/1000000.0;
+}
 
 //Hacky way of getting the svn revision
 //int guez_utils::getSvnRevision(){
@@ -154,11 +188,12 @@ void guez_utils::setSeed(ulong _x){srand(_x);rng = RNG(_x);}
  *      Springer-Verlag, 1986
  */
 void guez_utils::sampleDirichlet(double* probs, const uint* params, uint nump, double prior){
+	PROFILE_SCOPE("guez_utils::sampleDirichlet");
 	double gammaSum = 0;
 	double randGamma;
 	bool allZeros = true;
   for (unsigned i = 0; i < nump; i++){
-    randGamma = rng.gamma((double)params[i]+prior, 1);
+    randGamma = getRNG().gamma((double)params[i]+prior, 1);
 		if(randGamma > 0)
 			allZeros = false;
     probs[i] = randGamma;
@@ -168,12 +203,12 @@ void guez_utils::sampleDirichlet(double* probs, const uint* params, uint nump, d
 	{
 		//Handle special case, occurs when params are really small
 		//because of numerical approximation around 0
-		probs[rand() % nump] = 1;
+		probs[randInt() % nump] = 1;
 	}
 	else if(gammaSum < 1e-300){
 		for (unsigned i = 0; i < nump; i++)
 			probs[i] = 0;
-		probs[rand() % nump] = 1;
+		probs[randInt() % nump] = 1;
   }
 	else{
 		//Normalize
@@ -192,11 +227,12 @@ void guez_utils::sampleDirichlet(double* probs, const uint* params, uint nump, d
  *      Springer-Verlag, 1986
  */
 void guez_utils::sampleDirichlet(double* probs, const double* params, uint nump, double prior){
+	PROFILE_SCOPE("guez_utils::sampleDirichlet");
 	double gammaSum = 0;
 	double randGamma;
 	bool allZeros = true;
   for (unsigned i = 0; i < nump; i++){
-    randGamma = rng.gamma(params[i]+prior, 1);
+    randGamma = getRNG().gamma(params[i]+prior, 1);
 		if(randGamma > 0)
 			allZeros = false;
     probs[i] = randGamma;
@@ -206,12 +242,12 @@ void guez_utils::sampleDirichlet(double* probs, const double* params, uint nump,
 	{
 		//Handle special case, occurs when params are really small
 		//because of numerical approximation around 0
-		probs[rand() % nump] = 1;
+		probs[randInt() % nump] = 1;
 	}
 	else if(gammaSum < 1e-300){
 		for (unsigned i = 0; i < nump; i++)
 			probs[i] = 0;
-		probs[rand() % nump] = 1;
+		probs[randInt() % nump] = 1;
   }
 	else{
 		//Normalize
@@ -230,13 +266,14 @@ void guez_utils::sampleDirichlet(double* probs, const double* params, uint nump,
  *      Springer-Verlag, 1986
  */
 void guez_utils::sampleDirichlet(double* probs, double* params, uint nump){
+	PROFILE_SCOPE("guez_utils::sampleDirichlet");
 	double gammaSum = 0;
 	double randGamma;
 	bool allZeros = true;
 
   for (unsigned i = 0; i < nump; i++){
 		if(params[i] > 0){
-			randGamma = rng.gamma(params[i], 1);
+			randGamma = getRNG().gamma(params[i], 1);
 			if(randGamma > 0)
 				allZeros = false;
 			probs[i] = randGamma;
@@ -249,12 +286,12 @@ void guez_utils::sampleDirichlet(double* probs, double* params, uint nump){
 	{
 		//Handle special case, occurs when params are really small
 		//because of numerical approximation around 0
-		probs[rand() % nump] = 1;
+		probs[randInt() % nump] = 1;
 	}
 	else if(gammaSum < 1e-300){
 		for (unsigned i = 0; i < nump; i++)
 			probs[i] = 0;
-		probs[rand() % nump] = 1;
+		probs[randInt() % nump] = 1;
   }
 	else{
 		//Normalize
@@ -273,16 +310,17 @@ void guez_utils::sampleDirichlet(double* probs, double* params, uint nump){
  *      Springer-Verlag, 1986
  */
 void guez_utils::sampleDirichlet(double* probs, const vector<double> &params){
+	PROFILE_SCOPE("guez_utils::sampleDirichlet");
 	double gammaSum = 0;
 	double randGamma;
 	bool allZeros = true;
   for (unsigned i = 0; i < params.size(); i++){
   	//	TODO
 	#ifdef BOOST_FOUND
-    	randGamma = rng.gamma(params(i), 1);
+    	randGamma = getRNG().gamma(params(i), 1);
     	
     	#else
-    	randGamma = rng.gamma(params[i], 1);
+    	randGamma = getRNG().gamma(params[i], 1);
     	
     	#endif
     	//	TODO
@@ -296,12 +334,12 @@ void guez_utils::sampleDirichlet(double* probs, const vector<double> &params){
 	{
 		//Handle special case, occurs when params are really small
 		//because of numerical approximation around 0
-		probs[rand() % params.size()] = 1;
+		probs[randInt() % params.size()] = 1;
 	}
 	else if(gammaSum < 1e-300){
 		for (unsigned i = 0; i < params.size(); i++)
 			probs[i] = 0;
-		probs[rand() % params.size()] = 1;
+		probs[randInt() % params.size()] = 1;
   }
 	else{
 		//Normalize
@@ -318,10 +356,10 @@ vector<double> guez_utils::sampleDirichlet(const vector<double> &params){
   for (unsigned i = 0; i < params.size(); i++){
   	//	TODO
 	#ifdef BOOST_FOUND
-    	randGamma = rng.gamma(params(i), 1);
+    	randGamma = getRNG().gamma(params(i), 1);
     	
     	#else
-    	randGamma = rng.gamma(params[i], 1);
+    	randGamma = getRNG().gamma(params[i], 1);
     	
     	#endif
 	//	TODO
@@ -347,10 +385,10 @@ vector<double> guez_utils::sampleDirichlet(const vector<double> &params){
 		//because of numerical approximation around 0
 		//	TODO
 		#ifdef BOOST_FOUND
-		probs(rand() % params.size()) = 1;
+		probs(randInt() % params.size()) = 1;
 		
 		#else
-		probs[rand() % params.size()] = 1;
+		probs[randInt() % params.size()] = 1;
 		
 		#endif
 		//	TODO
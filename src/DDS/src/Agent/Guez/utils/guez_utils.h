@@ -40,7 +40,13 @@ namespace fs = boost::filesystem;
 typedef unsigned int uint;
 namespace guez_utils{
 
-extern RNG rng;
+//	The generator of the calling thread (seeded by 'setSeed()', or from
+//	'utils::RandomGen' on its first use)
+RNG& getRNG();
+
+//	A number in [0, RAND_MAX] drawn from a 'rand_r()' stream of the calling
+//	thread (seeded along with 'getRNG()'), to use in place of 'rand()'
+int randInt();
 
 void printA(double*v , size_t s);
 
@@ -77,8 +83,14 @@ double KLdiv(const std::vector<double>& p, const std::vector<double>& q);
 
 #endif
 
+//	Seed the generators of the calling thread only (see 'getRNG()' and
+//	'randInt()'), so that concurrent simulations do not share any state
 void setSeed(ulong _x);
 
+//	Milliseconds elapsed on the monotonic clock (only meaningful as a
+//	difference, used for the per-decision deadlines of the planners)
+double getMonotonicTime();
+
 void sampleDirichlet(double* probs, double* params, uint nump);
 void sampleDirichlet(double* probs, const uint* params, uint nump, double prior);
 //   TODO - ADDED
@@ -65,6 +65,21 @@ public:
         NumAllocated--;
     }
     
+    // Free every object but keep the chunks for later allocations
+    void FreeAll()
+    {
+        FreeList.clear();
+        for (ChunkIterator i_chunk = Chunks.begin(); i_chunk != Chunks.end(); ++i_chunk)
+        {
+            for (int i = CHUNK::Size - 1; i >= 0; --i)
+            {
+                FreeList.push_back(&(*i_chunk)->Objects[i]);
+                (*i_chunk)->Objects[i].ClearAllocated();
+            }
+        }
+        NumAllocated = 0;
+    }
+
     void DeleteAll()
     {
         for (ChunkIterator i_chunk = Chunks.begin(); i_chunk != Chunks.end(); ++i_chunk)
@@ -3,6 +3,7 @@
 // file as well as references and credits.
 
 #include <cmath>
+#include <pthread.h>
 #include "rng.h"
 
 #include <iostream>
@@ -74,14 +75,17 @@ double RNG::efix(ulong j, ulong i)
 
 // __________________________________________________________________________
 // This procedure creates the tables used by RNOR and REXP
+// (once, even if the first RNGs are created by several threads at a time)
+
+static pthread_once_t zigsetOnce = PTHREAD_ONCE_INIT;
 
 void RNG::zigset()
 {
-  static bool inited = 0;
-  if (inited)
-    return;
-  inited = 1;
-  
+  pthread_once(&zigsetOnce, &RNG::zigtables);
+}
+
+void RNG::zigtables()
+{
   // Set up tables for RNOR
   const double m1 = 2147483648.0; // 2^31
   const double vn = 9.91256303526217e-3;
@@ -114,7 +118,7 @@ void RNG::zigset()
     te = de;
   }
 
-} // RNG::zigset
+} // RNG::zigtables
 
 // __________________________________________________________________________
 // Generate a gamma variate with parameters 'shape' and 'scale'
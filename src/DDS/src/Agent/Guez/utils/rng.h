@@ -102,6 +102,8 @@ class RNG
   static ulong kn[128], ke[256];
   static double wn[128], fn[128], we[256],fe[256];
 
+  static void zigtables();
+
  public:
   RNG() { init(); zigset(); }
   RNG(ulong x_) :
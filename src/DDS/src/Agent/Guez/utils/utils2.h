@@ -1,11 +1,12 @@
-#ifndef UTILS_H
-#define UTILS_H
+#ifndef UTILS2_H
+#define UTILS2_H
 
 #include <vector>
 #include <stdlib.h>
 #include <math.h>
 #include <assert.h>
 #include "memorypool.h"
+#include "guez_utils.h"
 #include <algorithm>
 
 #define LargeInteger 1000000
@@ -28,27 +29,27 @@ inline int Sign(int x)
 
 inline int Random(int max)
 {
-    return rand() % max;
+    return guez_utils::randInt() % max;
 }
 
 inline int Random(int min, int max)
 {
-    return rand() % (max - min) + min;
+    return guez_utils::randInt() % (max - min) + min;
 }
 
 inline double RandomDouble(double min, double max)
 {
-    return (double) rand() / RAND_MAX * (max - min) + min;
+    return (double) guez_utils::randInt() / RAND_MAX * (max - min) + min;
 }
 
 inline void RandomSeed(int seed)
 {
-    srand(seed);
+    guez_utils::setSeed(seed);
 }
 
 inline bool Bernoulli(double p)
 {
-    return rand() < p * RAND_MAX;
+    return guez_utils::randInt() < p * RAND_MAX;
 }
 
 inline bool Near(double x, double y, double tol)
@@ -70,4 +71,4 @@ void UnitTest();
 
 }
 
-#endif // UTILS_H
+#endif // UTILS2_H
@@ -38,14 +38,8 @@ int OptimalAgent::getAction(int xt) const throw (AgentException)
 	assert(Q.size() == (getMDP()->getNbStates() * getMDP()->getNbActions()));
 	
 	
-	vector<vector<double>::const_iterator> maxList;
-	maxList = utils::search::max<vector<double> >(
+	return utils::search::randMax<vector<double> >(
 			(Q.begin() + nU*xt), (Q.begin() + nU*xt + nU));
-	
-	assert(!maxList.empty());
-
-	int maxI = RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-	return (maxList[maxI] - (Q.begin() + nU*xt));
 }
 
 
@@ -56,7 +50,45 @@ void OptimalAgent::reset() throw (AgentException)
 	
 	double gamma = getGamma();
 	if (gamma == 1.0) { gamma = uGamma; }
-	Q = getMDP()->qIteration(gamma, getT());
+	
+	
+	//	Retrieve the Q-function from the cache (if already computed)
+	//	(the MDP of the entry must be the same, not only its hashes)
+	const MDP* mdp = getMDP();
+	string key = getQCacheKey(mdp, gamma, getT());
+	
+	pthread_mutex_lock(&qCacheMutex);
+	map<string, QCacheEntry>::const_iterator it = qCache.find(key);
+	bool found = ((it != qCache.end())
+	              && (it->second.P == mdp->getP())
+	              && (it->second.R == mdp->getR()));
+	if (found) { Q = it->second.Q; }
+	pthread_mutex_unlock(&qCacheMutex);
+	
+	
+	//	Compute it otherwise
+	//	(not cached in case of collision with another MDP)
+	if (!found)
+	{
+		Q = mdp->qIteration(gamma, getT());
+		
+		pthread_mutex_lock(&qCacheMutex);
+		if (qCache.find(key) == qCache.end())
+		{
+			if (qCacheOrder.size() >= OPTIMAL_Q_CACHE_SIZE)
+			{
+				qCache.erase(qCacheOrder.front());
+				qCacheOrder.pop_front();
+			}
+			
+			QCacheEntry& entry = qCache[key];
+			entry.P = mdp->getP();
+			entry.R = mdp->getR();
+			entry.Q = Q;
+			qCacheOrder.push_back(key);
+		}
+		pthread_mutex_unlock(&qCacheMutex);
+	}
 	
 	
 	//	Check integrity
@@ -134,6 +166,28 @@ void OptimalAgent::deserialize(istream& is) throw (SerializableException)
 
 
 
+// ===========================================================================
+//	Private static methods
+// ===========================================================================
+string OptimalAgent::getQCacheKey(const MDP* mdp,
+                                  double gamma, unsigned int T)
+{
+	//	'Q' only depends on 'P', 'R', 'gamma' and 'T'
+	const vector<double>& P = mdp->getP();
+	const vector<double>& R = mdp->getR();
+	
+	stringstream sstr;
+	sstr << mdp->getNbStates() << "_" << mdp->getNbActions() << "_";
+	sstr << hashing::computeHash((const char*) &P[0],
+	                             P.size()*sizeof(double));
+	sstr << hashing::computeHash((const char*) &R[0],
+	                             R.size()*sizeof(double));
+	sstr << "_" << setprecision(17) << gamma << "_" << T;
+	
+	return sstr.str();
+}
+
+
 // ===========================================================================
 //	Private methods
 // ===========================================================================
@@ -143,3 +197,15 @@ void OptimalAgent::checkIntegrity() const
 	assert((uGamma > 0.0) && (uGamma < 1.0));
 }
 #endif
+
+
+// ===========================================================================
+//	Private static attributes initialization
+// ===========================================================================
+map<string, OptimalAgent::QCacheEntry> OptimalAgent::qCache;
+
+
+deque<string> OptimalAgent::qCacheOrder;
+
+
+pthread_mutex_t OptimalAgent::qCacheMutex = PTHREAD_MUTEX_INITIALIZER;
@@ -175,6 +175,64 @@
 		unsigned int nU;
 		
 		
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		/**
+			\brief	An entry of 'qCache': a Q-function, and the
+					transition matrix and rewards means of its MDP
+					(compared to the ones of the MDP looked up, since
+					the key only holds their hashes).
+		*/
+		struct QCacheEntry
+		{
+			std::vector<double> P, R, Q;
+		};
+		
+		
+		// =================================================================
+		//	Private static attributes
+		// =================================================================
+		/**
+			\brief	The Q-functions already computed, shared by all the
+					OptimalAgents (and all the threads).
+					They are indexed by the content of their MDP, so that
+					the copies of a same MDP share the same entry.
+		*/
+		static std::map<std::string, QCacheEntry> qCache;
+		
+		
+		/**
+			\brief	The keys of 'qCache', from the oldest to the newest
+					(the oldest entry is discarded once the cache holds
+					'OPTIMAL_Q_CACHE_SIZE' entries).
+		*/
+		static std::deque<std::string> qCacheOrder;
+		
+		
+		/**
+			\brief	The mutex protecting 'qCache' and 'qCacheOrder'.
+		*/
+		static pthread_mutex_t qCacheMutex;
+		
+		
+		// =================================================================
+		//	Private static methods
+		// =================================================================
+		/**
+			\brief		Return the key of the Q-function of 'mdp' in
+						'qCache'.
+			
+			\param[mdp	A MDP.
+			\param[gamma	The discount factor.
+			\param[T		The horizon limit.
+			
+			\return		The key of the Q-function of 'mdp' in 'qCache'.
+		*/
+		static std::string getQCacheKey(const MDP* mdp,
+		                                double gamma, unsigned int T);
+		
+		
 		// =================================================================
 		//	Private methods
 		// =================================================================	
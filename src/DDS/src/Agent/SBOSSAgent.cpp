@@ -10,21 +10,23 @@ using namespace utils;
 //	Public Constructors/Destructor
 // ===========================================================================
 SBOSSAgent::SBOSSAgent(std::istream& is) :
-          Agent(), sboss(0), simulator(0), samplerFact(0)
+          Agent(), sboss(0), simulator(0), samplerFact(0),
+          nbSimulations(0)
 {
 	try							{ dDeserialize(is);	}
 	catch (SerializableException e)	{ deserialize(is);	}
 }
 
 
-SBOSSAgent::SBOSSAgent(double epsilon_, double delta_) :
-          epsilon(epsilon_), delta(delta_),
-          sboss(0), simulator(0), samplerFact(0)
+SBOSSAgent::SBOSSAgent(double epsilon_, double delta_, double msPerAction_) :
+          epsilon(epsilon_), delta(delta_), msPerAction(msPerAction_),
+          sboss(0), simulator(0), samplerFact(0), nbSimulations(0)
 {
      stringstream sstr;
 	sstr << "SBOSS (";
 	sstr << "epsilon = " << setprecision(ceil(log10(epsilon) + 2)) << epsilon;
 	sstr << ", delta = " << setprecision(ceil(log10(delta)   + 2)) << delta;
+	if (msPerAction > 0) { sstr << ", " << msPerAction << " ms/action"; }
 	sstr << ", no model)";
 	setName(sstr.str());
      
@@ -75,11 +77,13 @@ void SBOSSAgent::reset() throw (AgentException)
      SBOSS::PARAMS searchParamsSBOSS;
 	searchParamsSBOSS.epsilon = epsilon;
 	searchParamsSBOSS.delta = delta;
+	searchParamsSBOSS.MsPerAction = msPerAction;
 	
      
      unsigned int s = getMDP()->getCurrentState();     
      simulator      = new MDPSimulator(s, nX, nU, R, getGamma());     
      samplerFact    = new PCSamplerFactory(priorcountList);
+     nbSimulations  = 0;
      sboss = new SBOSS(*simulator, searchParamsSBOSS, *samplerFact);
 	
 	
@@ -92,6 +96,9 @@ void SBOSSAgent::reset() throw (AgentException)
 
 void SBOSSAgent::freeData()
 {
+     if (sboss)
+          nbSimulations = sboss->GetNumSimulationsDone();
+     
      if (sboss)          { delete sboss;       sboss       = 0; }
      if (simulator)      { delete simulator;   simulator   = 0; }
      if (samplerFact)    { delete samplerFact; samplerFact = 0; }
@@ -104,13 +111,20 @@ void SBOSSAgent::freeData()
 }
 
 
+unsigned long SBOSSAgent::getNbSimulations() const
+{
+     if (sboss) { return sboss->GetNumSimulationsDone(); }
+     return nbSimulations;
+}
+
+
 void SBOSSAgent::serialize(ostream& os) const
 {
 	Agent::serialize(os);
 	
 	
 	os << SBOSSAgent::toString() << "\n";
-     os << 6 << "\n";
+     os << 7 << "\n";
 
 
 	//  'epsilon'
@@ -153,6 +167,10 @@ void SBOSSAgent::serialize(ostream& os) const
 				else				{ os << "\n"; }
 			}
 		}
+	
+	
+	//  'msPerAction'
+	os << msPerAction << "\n";
 }
 
 
@@ -241,6 +259,16 @@ void SBOSSAgent::deserialize(istream& is) throw (SerializableException)
 		}
 	}
 	++i;
+	
+	
+	//  'msPerAction' (absent from the files saved before its addition)
+	msPerAction = 0.0;
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("msPerAction"); }
+		msPerAction = atof(tmp.c_str());
+		++i;
+	}
      
      
      //   'SBOSS', 'simulator' and 'samplerFact'
@@ -286,6 +314,7 @@ void SBOSSAgent::learnOffline_aux(const MDPDistribution* mdpDistrib)
 	     sstr << epsilon;
 	     sstr << ", delta = " << setprecision(ceil(log10(delta)   + 2));
 	     sstr << delta;
+		if (msPerAction > 0) { sstr << ", " << msPerAction << " ms/action"; }
 		sstr << ", " << dirDistrib->getShortName() << ")";
 		setName(sstr.str());
 	}
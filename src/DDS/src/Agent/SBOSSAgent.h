@@ -49,8 +49,12 @@
 			\param[epsilon_  Defines the maximal error on sampling estimate.
                \param[delta_    The maximal threshold on the posterior
                                 deviation before resampling.
+               \param[msPerAction_
+                                The time budget of a decision (in ms).
+                                If > 0, the value iteration on the merged
+                                model stops at the deadline.
 		*/
-		SBOSSAgent(double epsilon_, double delta_);
+		SBOSSAgent(double epsilon_, double delta_, double msPerAction_ = 0.0);
 		
 		
 		/**
@@ -114,6 +118,17 @@
 		void freeData();
 
 
+		/**
+			\brief	Return the number of simulations performed by this
+					Agent on the last MDP it has interacted with.
+					(one simulation = one value iteration sweep)
+			
+			\return	The number of simulations performed by this Agent
+					on the last MDP it has interacted with.
+		*/
+		unsigned long getNbSimulations() const;
+
+
 		/**
 			\brief	Return a clone of this Agent.
 			
@@ -178,6 +193,13 @@
 		double delta;
 		
 		
+		/**
+               \brief    The time budget of a decision (in ms).
+                         (0: no time budget)
+		*/
+		double msPerAction;
+		
+		
 		/**
                \brief    The BFS3 algorithm (implemented by Guez).
 		*/
@@ -196,6 +218,13 @@
 		SamplerFactory* samplerFact;
 		
 		
+		/**
+               \brief    The number of simulations performed on the last
+                         MDP (saved when 'sboss' is deleted).
+		*/
+		unsigned long nbSimulations;
+		
+		
 		/**
                \brief    The number of states of the MDPs to be played.
 		*/
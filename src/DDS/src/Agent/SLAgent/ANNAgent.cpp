@@ -21,6 +21,9 @@ ANNAgent::ANNAgent(const vector<unsigned int>& hiddenLayers_,
 		         bool decreasingLR_,
 		         unsigned int maxEpoch_,
 		         unsigned int epochRange_,
+		         unsigned int batchSize_,
+		         unsigned int nbThreads_,
+		         unsigned int nbNetworks_,
                    Agent* agent,
 		         unsigned int nbOfMDPs, double simGamma, unsigned int T,
 		         string SLModelFileName) :
@@ -30,7 +33,9 @@ ANNAgent::ANNAgent(const vector<unsigned int>& hiddenLayers_,
 		               hiddenLayers(hiddenLayers_),
 		               learningRate(learningRate_),
 		               decreasingLR(decreasingLR_),
-		               maxEpoch(maxEpoch_), epochRange(epochRange_)
+		               maxEpoch(maxEpoch_), epochRange(epochRange_),
+		               batchSize(batchSize_), nbThreads(nbThreads_),
+		               nbNetworks(nbNetworks_)
 {
      stringstream sstr;
      sstr << "ANN (";
@@ -66,7 +71,7 @@ void ANNAgent::serialize(ostream& os) const
 	
 	
 	os << ANNAgent::toString() << "\n";
-	os << 7 << "\n";
+	os << 9 << "\n";
 	
 	
 	//   'hiddenLayers'
@@ -108,6 +113,14 @@ void ANNAgent::serialize(ostream& os) const
           for (unsigned int j = 0; j < stDevs.size(); ++j)
                os << stDevs[j] << "\n";
      }
+
+
+     //   'batchSize'
+     os << batchSize << "\n";
+
+
+     //   'nbNetworks'
+     os << nbNetworks << "\n";
 }
 
 
@@ -204,6 +217,28 @@ void ANNAgent::deserialize(istream& is) throw (SerializableException)
           }
      }
      i += 2;
+     
+     
+     //   'batchSize' (absent from the files saved before mini-batch
+     //   training, which are trained incrementally)
+     batchSize = 0;
+     nbThreads = 1;
+     if (n > i)
+     {
+          if (!getline(is, tmp)) { throwEOFMsg("batchSize"); }
+          batchSize = atoi(tmp.c_str());
+          ++i;
+     }
+     
+     
+     //   'nbNetworks' (absent from the files saved before ensembles)
+     nbNetworks = 1;
+     if (n > i)
+     {
+          if (!getline(is, tmp)) { throwEOFMsg("nbNetworks"); }
+          nbNetworks = atoi(tmp.c_str());
+          ++i;
+     }
 	
 	
 	//	Number of parameters check
@@ -314,36 +349,22 @@ void ANNAgent::loadFANNData(const vector<vector<double> >& inputs,
      if (dataWeights) { delete[] dataWeights;     }
 
 
-     //   Gather the LS samples
-     vector<vector<double > > sInputs, sOutputs;
-     vector<double> sWeights;
+     //   Build the 'fann_train_data' structure directly from the samples
+     //   (FANN stores them in two contiguous blocks, which are shuffled in
+     //   place at each epoch)
+     unsigned int nbInputs  = (s.empty() ? 0 : inputs[s[0]].size());
+     unsigned int nbOutputs = (s.empty() ? 0 : outputs[s[0]].size());
+     data = fann_create_train(s.size(), nbInputs, nbOutputs);
+
+     dataWeights = new double[s.size()];
      for (unsigned int i = 0; i < s.size(); ++i)
      {
-          sInputs.push_back(inputs[s[i]]);
-          sOutputs.push_back(outputs[s[i]]);
-          sWeights.push_back(weights[s[i]]);
+          std::copy(inputs[s[i]].begin(),  inputs[s[i]].end(),
+                    data->input[i]);
+          std::copy(outputs[s[i]].begin(), outputs[s[i]].end(),
+                    data->output[i]);
+          dataWeights[i] = weights[s[i]];
      }
-
-
-     //   Save the LS samples into a temporary file
-     char tmpFileName[] = "data/agents/tmp.XXXXXX";
-     close(mkstemp(tmpFileName));
-
-     ofstream os(tmpFileName);
-     saveSLSamples(sInputs, sOutputs, sWeights,
-                   vector<unsigned int>(), os);
-     os.close();
-
-
-     //   Load the LS samples from the temporary file
-     data = fann_read_train_from_file(tmpFileName);
-     unlink(tmpFileName);
-
-
-     //   Load the weights into a C array
-     dataWeights = new double[sWeights.size()];
-     for (unsigned int i = 0; i < sWeights.size(); ++i)
-          dataWeights[i] = sWeights[i];
 }
 
 
@@ -453,8 +474,12 @@ vector<double> ANNAgent::predict(
                inputFANN[i] = input[i];
      
      //   Compute FANN output
-     fann_type* outputFANN = fann_run(ann, inputFANN);
-     delete inputFANN;
+     fann_type* outputFANN;
+     {
+          PROFILE_SCOPE("fann_run");
+          outputFANN = fann_run(ann, inputFANN);
+     }
+     delete[] inputFANN;
      
      //   Store the FANN output into a vector
      vector<double> output(fann_get_num_output(ann));
@@ -487,12 +512,6 @@ void ANNAgent::train(vector<vector<double> >& inputs,
                      vector<double>& weights,
                      vector<unsigned int>& indexes)
 {
-     //   Parameters
-     unsigned int nANN             = 1;
-     bool verbose                  = true;
-     double accuracy               = 1e-3;
-
-     
      //   Free previous NNs
      for (unsigned int i = 0; i < annList.size(); ++i)
           if (annList[i] != 0) { fann_destroy(annList[i]); }
@@ -502,39 +521,42 @@ void ANNAgent::train(vector<vector<double> >& inputs,
      stDevsList.clear();
 
 
-     //   Create new NNs
-     for (unsigned int n = 0; n < nANN; ++n)
-     {
-          annList.push_back(0);
-          struct fann*& ann = annList.back();
+     //   Pack the samples (remove duplicates)
+     vector<vector<unsigned int> > packedIndexes;
+     packSamples(inputs, outputs, weights, indexes, packedIndexes);
 
 
-          //   Pack the samples (remove duplicates)
-          vector<vector<unsigned int> > packedIndexes;
-          packSamples(inputs, outputs, weights, indexes, packedIndexes);
+     //   Prepare the NNs to train
+     //   (sequentially, since it relies on the global RNG)
+     unsigned int nANN = (nbNetworks == 0) ? 1 : nbNetworks;
+     annList.resize(nANN, 0);
+     
+     vector<TrainingJob> jobList(nANN);
+     for (unsigned int n = 0; n < nANN; ++n)
+     {
+          TrainingJob& job = jobList[n];
 
 
           //   Split the samples in LS, VS and TS
           double pLS = 0.5, pVS = 0.25, pTS = 0.25;
-          vector<unsigned int> ls, vs, ts;
           splitSamples(inputs, outputs, weights, packedIndexes,
-                       pLS, pVS, pTS, ls,  vs,  ts);
+                       pLS, pVS, pTS, job.ls,  job.vs,  job.ts);
 
 
           //   Compute the standardization of the features
-          computeStandardizationParameters(n, inputs, ls);
+          computeStandardizationParameters(n, inputs, job.ls);
 
 
           //   Standardize the inputs
-          vector<vector<double> > nInputs;
           for (unsigned int i = 0; i < inputs.size(); ++i)
-               nInputs.push_back(standardizeInput(n, inputs[i]));
+               job.nInputs.push_back(standardizeInput(n, inputs[i]));
 
 
           //   Load the LS samples          
-          fann_train_data* data = 0;
-          double* dataWeights   = 0;
-          loadFANNData(nInputs, outputs, weights, ls, data, dataWeights);
+          job.data        = 0;
+          job.dataWeights = 0;
+          loadFANNData(job.nInputs, outputs, weights, job.ls,
+                       job.data, job.dataWeights);
 
 
           //   Build a NN
@@ -548,7 +570,7 @@ void ANNAgent::train(vector<vector<double> >& inputs,
           layers[2 + hiddenLayers.size() - 1] = outputs[0].size();
      
                //   NN
-          struct fann* cAnn = fann_create_standard_array(
+          job.cAnn = fann_create_standard_array(
                2 + hiddenLayers.size(), layers);
           delete[] layers;
           
@@ -556,138 +578,203 @@ void ANNAgent::train(vector<vector<double> >& inputs,
                
                //   Initialize the weights
           s = RandomGen::randIntRange_Uniform(0, INT_MAX);
-          fann_init_weights(cAnn, data);
+          fann_init_weights(job.cAnn, job.data);
           
           RandomGen::setSeed(s);
 
 
           //   Set the activation functions
-          fann_set_activation_function_hidden(cAnn, FANN_SIGMOID_SYMMETRIC);
-          fann_set_activation_function_output(cAnn, FANN_SIGMOID_SYMMETRIC);
+          fann_set_activation_function_hidden(
+                    job.cAnn, FANN_SIGMOID_SYMMETRIC);
+          fann_set_activation_function_output(
+                    job.cAnn, FANN_SIGMOID_SYMMETRIC);
 
 
           //   Set the training algorithm
-          fann_set_training_algorithm(cAnn, FANN_TRAIN_INCREMENTAL);
-          
+          //   (mini-batches are handled by 'fann_train_epoch_minibatch_w()')
+          fann_set_training_algorithm(job.cAnn, (batchSize == 0) ?
+                    FANN_TRAIN_INCREMENTAL : FANN_TRAIN_BATCH);
+
+
+          //   Seed of the RNG stream of this NN (shuffling of LS)
+          job.seed = RandomGen::randIntRange_Uniform(0, INT_MAX);
+     }
 
-          //   Train on LS and minimize the error on VS
-          if (verbose)
+
+     //   Train the NNs
+     //   (the remaining threads compute the gradients of the mini-batches)
+     unsigned int nbWorkers = (nbThreads < nANN) ? nbThreads : nANN;
+     if (nbWorkers <= 1)
+     {
+          for (unsigned int n = 0; n < nANN; ++n)
           {
-               cout << "\n";
-               cout << setprecision(3) << fixed;
+               trainNetwork(n, jobList[n], outputs, weights,
+                            (nbThreads == 0) ? 1 : nbThreads, cout);
+          }
+     }
+     
+     else
+     {
+          unsigned int nextJob = 0;
+          vector<TrainingThread*> threadList;
+          for (unsigned int i = 0; i < nbWorkers; ++i)
+          {
+               threadList.push_back(new TrainingThread(
+                         this, &jobList, &outputs, &weights,
+                         &nextJob, nbThreads / nbWorkers));
+               threadList.back()->start();
           }
-
-          unsigned int epochPerStep = (epochRange / 5);
-          epochPerStep = (epochPerStep == 0 ? 1 : epochPerStep);
           
-          unsigned int minEpoch;
-          double minVsMSE = 0.0;
-          for (unsigned int epoch = 0; epoch <= maxEpoch; ++epoch)
+          for (unsigned int i = 0; i < nbWorkers; ++i)
           {
-               if (epoch % epochPerStep == 0)
-               {
-                    //   Evaluate performance on VS
-                    double vsMSE =
-                              computeMSE(cAnn, nInputs, outputs, weights, vs);
+               threadList[i]->join();
+               delete threadList[i];
+          }
+          
+          
+          //   Output the logs of the NNs, in order
+          for (unsigned int n = 0; n < nANN; ++n)
+               cout << jobList[n].log;
+     }
+}
 
-               
-                    //   Check if better than the current best one
-                    if (ann == 0 ||
-                         ((vsMSE < minVsMSE)
-                              && fabs(vsMSE - minVsMSE) > accuracy))
-                    {                    
-                         //   Save the current NN into a temporary file
-                         char tmpFileName[] = "data/agents/tmp.XXXXXX";
-                         close(mkstemp(tmpFileName));
-                         fann_save(cAnn, tmpFileName);
-                    
-                         //   Copy the NN
-                         if (ann != 0) { fann_destroy(ann); }
-                         ann = fann_create_from_file(tmpFileName);
-                         unlink(tmpFileName);
-
-                         //   Update 'max info'
-                         minEpoch = epoch;
-                         minVsMSE = vsMSE;
-                    }
-                    
-                    else if (epoch != minEpoch) { learningRate /= 10.0; }
-               
-               
-                    //   Output the current results
-                    if (verbose)
-                    {
-                         double lsMSE =
-                              computeMSE(cAnn, nInputs, outputs, weights, ls);
-               
-                         cout << "\t\t[" << epoch;
-                         cout << "]\tLS (mse = " << lsMSE << ")";
-                         cout <<  "\tVS (mse = " << vsMSE << ")";
-                         if (ann) { cout << "\t(*" << minEpoch << ")"; }
-                         
-                         cout << "\n";
-                    }
-               
-               
-                    //   Stopping condition
-                    if (ann != 0
-                              && (epoch-minEpoch+epochPerStep) >= epochRange)
-                         break;
-               }
 
+void ANNAgent::trainNetwork(unsigned int n, TrainingJob& job,
+                            const vector<vector<double> >& outputs,
+                            const vector<double>& weights,
+                            unsigned int nbBatchThreads,
+                            ostream& os)
+{
+     //   Parameters
+     bool verbose                  = true;
+     double accuracy               = 1e-3;
+     double lr                     = learningRate;
 
-               //   Train
-               fann_shuffle_train_data_w(data, dataWeights);
-               
-               fann_set_learning_rate(cAnn,
-                         decreasingLR ?
-                              learningRate / sqrt(epoch + 1) :
-                              learningRate);
+     struct fann*& ann = annList[n];
+     struct fann* cAnn = job.cAnn;
+     const vector<vector<double> >& nInputs = job.nInputs;
+     const vector<unsigned int>& ls = job.ls;
+     const vector<unsigned int>& vs = job.vs;
+     const vector<unsigned int>& ts = job.ts;
 
-               if (fann_train_epoch_w(cAnn, data, dataWeights) == -1)
+
+     //   Train on LS and minimize the error on VS
+     if (verbose)
+     {
+          os << "\n";
+          os << setprecision(3) << fixed;
+     }
+
+     unsigned int epochPerStep = (epochRange / 5);
+     epochPerStep = (epochPerStep == 0 ? 1 : epochPerStep);
+     
+     unsigned int minEpoch;
+     double minVsMSE = 0.0;
+     for (unsigned int epoch = 0; epoch <= maxEpoch; ++epoch)
+     {
+          if (epoch % epochPerStep == 0)
+          {
+               //   Evaluate performance on VS
+               double vsMSE =
+                         computeMSE(cAnn, nInputs, outputs, weights, vs);
+
+          
+               //   Check if better than the current best one
+               if (ann == 0 ||
+                    ((vsMSE < minVsMSE)
+                         && fabs(vsMSE - minVsMSE) > accuracy))
+               {                    
+                    //   Snapshot the current NN
+                    if (ann != 0) { fann_destroy(ann); }
+                    ann = fann_copy(cAnn);
+
+                    //   Update 'max info'
+                    minEpoch = epoch;
+                    minVsMSE = vsMSE;
+               }
+               
+               else if (epoch != minEpoch) { lr /= 10.0; }
+          
+          
+               //   Output the current results
+               if (verbose)
+               {
+                    double lsMSE =
+                         computeMSE(cAnn, nInputs, outputs, weights, ls);
+          
+                    os << "\t\t[" << epoch;
+                    os << "]\tLS (mse = " << lsMSE << ")";
+                    os <<  "\tVS (mse = " << vsMSE << ")";
+                    if (ann) { os << "\t(*" << minEpoch << ")"; }
+                    
+                    os << "\n";
+               }
+          
+          
+               //   Stopping condition
+               if (ann != 0
+                         && (epoch-minEpoch+epochPerStep) >= epochRange)
                     break;
           }
 
 
-          //   Free
-          fann_destroy(cAnn);
-          delete[] dataWeights;
+          //   Train
+          fann_shuffle_train_data_w_r(job.data, job.dataWeights, &job.seed);
+          
+          fann_set_learning_rate(cAnn,
+                    decreasingLR ? lr / sqrt(epoch + 1) : lr);
+
+          float mse = (batchSize == 0) ?
+               fann_train_epoch_w(cAnn, job.data, job.dataWeights) :
+               fann_train_epoch_minibatch_w(cAnn, job.data, job.dataWeights,
+                                            batchSize, nbBatchThreads);
+          if (mse == -1) { break; }
+     }
 
 
-          /*
-               TODO
-                    - If we use a threshold for modifying the output
-                      (see 'predict()'), we could consider it to be equal to 0.0
-                      (no threshold) for the training phase and optimize it
-                      right here (dichotomic search should be enough).
-          */
+     //   Free
+     fann_destroy(cAnn);
+     fann_destroy_train(job.data);
+     delete[] job.dataWeights;
+     
+     job.cAnn        = 0;
+     job.data        = 0;
+     job.dataWeights = 0;
 
 
-          //   Output the performance of the selected ANN on LS, VS and TS
-          if (verbose)
-          {
-               double lsER  = computeER( ann, nInputs, outputs, weights, ls);
-               double lsMSE = computeMSE(ann, nInputs, outputs, weights, ls);
-
-               double vsER  = computeER( ann, nInputs, outputs, weights, vs);
-               double vsMSE = computeMSE(ann, nInputs, outputs, weights, vs);
-
-               double tsER  = computeER( ann, nInputs, outputs, weights, ts);
-               double tsMSE = computeMSE(ann, nInputs, outputs, weights, ts);
-
-               cout << "\n";
-               cout << "\t\t[F]";
-               cout << "\tLS (";
-               cout << "error rate = " << 100*lsER << "%, ";
-               cout << "mse = " << lsMSE << ")";
-               cout << " VS (";
-               cout << "error rate = " << 100*vsER << "%, ";
-               cout << "mse = " << vsMSE << ")";
-               cout << " TS (";
-               cout << "error rate = " << 100*tsER << "%, ";
-               cout << "mse = " << tsMSE << ")";
-               cout << "\n\t";
-          }
+     /*
+          TODO
+               - If we use a threshold for modifying the output
+                 (see 'predict()'), we could consider it to be equal to 0.0
+                 (no threshold) for the training phase and optimize it
+                 right here (dichotomic search should be enough).
+     */
+
+
+     //   Output the performance of the selected ANN on LS, VS and TS
+     if (verbose)
+     {
+          double lsER  = computeER( ann, nInputs, outputs, weights, ls);
+          double lsMSE = computeMSE(ann, nInputs, outputs, weights, ls);
+
+          double vsER  = computeER( ann, nInputs, outputs, weights, vs);
+          double vsMSE = computeMSE(ann, nInputs, outputs, weights, vs);
+
+          double tsER  = computeER( ann, nInputs, outputs, weights, ts);
+          double tsMSE = computeMSE(ann, nInputs, outputs, weights, ts);
+
+          os << "\n";
+          os << "\t\t[F]";
+          os << "\tLS (";
+          os << "error rate = " << 100*lsER << "%, ";
+          os << "mse = " << lsMSE << ")";
+          os << " VS (";
+          os << "error rate = " << 100*vsER << "%, ";
+          os << "mse = " << vsMSE << ")";
+          os << " TS (";
+          os << "error rate = " << 100*tsER << "%, ";
+          os << "mse = " << tsMSE << ")";
+          os << "\n\t";
      }
 }
 
@@ -761,23 +848,52 @@ void ANNAgent::computeStandardizationParameters(
 }
   
           
-vector<double> ANNAgent::predict(const vector<double>& input) const
+void ANNAgent::predict(const vector<double>& input,
+                       vector<double>& output) const
+{
+     //   Sum the predictions of the networks
+     output.assign(fann_get_num_output(annList[0]), 0.0);
+     for (unsigned int n = 0; n < annList.size(); ++n)
+          accumulatePrediction(n, input, output);
+}
+
+
+void ANNAgent::predict(const vector<vector<double> >& inputs,
+                       vector<vector<double> >& outputs) const
 {
-     //   Predict and return
-     vector<double> output = predict(
-               annList[0], standardizeInput(0, input));
+     outputs.resize(inputs.size());
+     for (unsigned int i = 0; i < inputs.size(); ++i)
+          outputs[i].assign(fann_get_num_output(annList[0]), 0.0);
      
-     for (unsigned int i = 1; i < annList.size(); ++i)
+     //   Sum the predictions of the networks (one network at a time)
+     for (unsigned int n = 0; n < annList.size(); ++n)
      {
-          //   Standardization of the features
-          vector<double> nInput = standardizeInput(i, input);
-     
-          vector<double> tmp = predict(annList[i], nInput);
-          for (unsigned int j = 0; j < output.size(); ++j)
-               output[j] += tmp[j];
+          for (unsigned int i = 0; i < inputs.size(); ++i)
+               accumulatePrediction(n, inputs[i], outputs[i]);
+     }
+}
+
+
+void ANNAgent::accumulatePrediction(unsigned int n,
+                                    const vector<double>& input,
+                                    vector<double>& output) const
+{
+     //   Standardization of the features (directly into the FANN input)
+     inputFANN.resize(input.size());
+     for (unsigned int k = 0; k < input.size(); ++k)
+     {
+          if (stDevsList[n][k] == 0.0) { inputFANN[k] = 0.0; continue; }
+          inputFANN[k] = ((input[k] - meansList[n][k]) / stDevsList[n][k]);
      }
      
-     return output;
+     //   Compute FANN output
+     const fann_type* outputFANN;
+     {
+          PROFILE_SCOPE("fann_run");
+          outputFANN = fann_run(annList[n], &inputFANN[0]);
+     }
+     for (unsigned int j = 0; j < output.size(); ++j)
+          output[j] += outputFANN[j];
 }
 
 
@@ -795,6 +911,30 @@ vector<double> ANNAgent::standardizeInput(unsigned int n,
 }
 
 
+// ===========================================================================
+//	Private Classes - TrainingThread
+// ===========================================================================
+void* ANNAgent::TrainingThread::run()
+{
+     for (;;)
+     {
+          //   Get the next NN to train
+          unsigned int n = __sync_fetch_and_add(nextJob, 1);
+          if (n >= jobList->size()) { break; }
+          
+          
+          //   Train it (its log is output once all the NNs are trained)
+          stringstream sstr;
+          agent->trainNetwork(n, (*jobList)[n], *outputs, *weights,
+                              (nbBatchThreads == 0) ? 1 : nbBatchThreads,
+                              sstr);
+          (*jobList)[n].log = sstr.str();
+     }
+     
+     return 0;
+}
+
+
 #ifndef NDEBUG
 void ANNAgent::checkIntegrity() const
 {
@@ -52,6 +52,13 @@
                \param[maxEpoch_         The maximal number of iterations.
                \param[epochRange_       The maximal number of iterations for
                                         which the VS error can increase.
+               \param[batchSize_        The number of samples per mini-batch
+                                        (0 for incremental training).
+               \param[nbThreads_        The number of threads training the
+                                        NNs of the ensemble concurrently
+                                        (the remaining ones compute the
+                                        gradient of the mini-batches).
+               \param[nbNetworks_       The number of NNs of the ensemble.
                
                \param[agent             The agent to copy.
                \param[nbOfMDPs          The number of MDPs on which the agent
@@ -72,6 +79,9 @@
 		         bool decreasingLR_,
 		         unsigned int maxEpoch_,
 		         unsigned int epochRange_,
+		         unsigned int batchSize_,
+		         unsigned int nbThreads_,
+		         unsigned int nbNetworks_,
 		         Agent* agent,
 		         unsigned int nbOfMDPs, double simGamma, unsigned int T,
 		         std::string SLModelFileName);
@@ -146,6 +156,63 @@
 
 
      private:
+          // =================================================================
+		//	Private structures
+		// =================================================================
+		/**
+		     \brief    The data needed to train one NN of the ensemble.
+		*/
+		struct TrainingJob
+		{
+		     /**
+		          \brief    The indexes of the samples in LS, VS & TS.
+		     */
+		     std::vector<unsigned int> ls, vs, ts;
+		     
+		     
+		     /**
+		          \brief    The inputs standardized w.r.t. LS.
+		     */
+		     std::vector<std::vector<double> > nInputs;
+		     
+		     
+		     /**
+		          \brief    The NN to train.
+		     */
+		     struct fann* cAnn;
+		     
+		     
+		     /**
+		          \brief    The LS samples and their weights.
+		     */
+		     fann_train_data* data;
+		     double* dataWeights;
+		     
+		     
+		     /**
+		          \brief    The state of the RNG stream of this NN.
+		     */
+		     unsigned int seed;
+		     
+		     
+		     /**
+		          \brief    The output of the training, when it is
+		                    performed by a TrainingThread.
+		     */
+		     std::string log;
+		};
+		
+		
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		/**
+			\brief	A thread training the NNs of the ensemble, one after
+					another, until none is left.
+		*/
+		class TrainingThread;
+
+
           // =================================================================
 		//	Private attributes
 		// =================================================================
@@ -187,6 +254,30 @@
                          error can increase.
           */
           unsigned int epochRange;
+          
+          
+          /**
+               \brief    The number of samples per mini-batch.
+                         If 0, the NN is trained incrementally (one update
+                         per sample).
+          */
+          unsigned int batchSize;
+          
+          
+          /**
+               \brief    The number of threads training the NNs of the
+                         ensemble concurrently (the remaining ones compute
+                         the gradient of the mini-batches).
+                         (not serialized)
+          */
+          unsigned int nbThreads;
+          
+          
+          /**
+               \brief    The number of NNs of the ensemble (their outputs
+                         are summed).
+          */
+          unsigned int nbNetworks;
 
           
           /**
@@ -201,6 +292,13 @@
                          vectors coming from the learning set.
           */
           std::vector<std::vector<double> > stDevsList;
+
+
+          /**
+               \brief    The FANN input buffer, reused by each prediction in
+                         order to avoid allocations.
+          */
+          mutable std::vector<fann_type> inputFANN;
                
 
           // =================================================================
@@ -376,6 +474,34 @@
                      std::vector<unsigned int>& indexes);
 
 
+          /**
+               \brief                   Train the n-th NN of the ensemble,
+                                        and store the NN minimizing the MSE
+                                        on VS in 'annList[n]'.
+                                        
+                                        Only reads the shared data, and can
+                                        thus be called concurrently for
+                                        different NNs.
+
+               \param[n                 The index of the NN.
+               \param[job               The data needed to train the NN
+                                        (freed, except 'nInputs' and the
+                                        sets, when the training is over).
+               \param[outputs           The outputs of the SL samples.
+               \param[weights           The weights of the SL samples.
+               \param[nbBatchThreads    The number of threads computing the
+                                        gradient of a mini-batch.
+               \param[os                The stream where to output the
+                                        progress of the training.
+          */
+          void trainNetwork(unsigned int n, TrainingJob& job,
+                            const std::vector<
+                                   std::vector<double> >& outputs,
+                            const std::vector<double>& weights,
+                            unsigned int nbBatchThreads,
+                            std::ostream& os);
+
+
           /**
                \brief              Save the current SL model into a file.
                
@@ -424,12 +550,39 @@
 
                \param[input   A vector where each column corresponds to an
                               input feature.
+               \param[output  The vector in which to store the prediction
+                              (one column per output feature).
+          */
+          void predict(const std::vector<double>& input,
+                       std::vector<double>& output) const;
 
-               \return        A vector where each column corresponds to a
-                              prediction an output feature.
+
+          /**
+               \brief         Predict the score of each action for each of
+                              the given input vectors.
+                              The networks are run one after another on
+                              the whole batch, so that the weights of a
+                              network stay in cache.
+
+               \param[inputs  The input vectors.
+               \param[outputs The vector in which to store the predictions.
           */
-          std::vector<double> predict(
-                    const std::vector<double>& input) const;
+          void predict(const std::vector<std::vector<double> >& inputs,
+                       std::vector<std::vector<double> >& outputs) const;
+
+
+          /**
+               \brief         Standardize 'input' w.r.t. the statistics of
+                              the n-th network, run this network on it and
+                              add its prediction to 'output'.
+
+               \param[n       The index of the network.
+               \param[input   The input vector (not standardized).
+               \param[output  The vector to which the prediction is added.
+          */
+          void accumulatePrediction(unsigned int n,
+                                    const std::vector<double>& input,
+                                    std::vector<double>& output) const;
 
 
           /**
@@ -456,6 +609,76 @@
 		*/
 		void checkIntegrity() const;
 		#endif
+
+
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		class TrainingThread : public utils::Thread
+		{			
+			public:
+				// =======================================================
+				//	Public Constructors
+				// =======================================================
+				/**
+					\brief	Constructor.
+					
+					\param[agent_			The ANNAgent to train.
+					\param[jobList_			The NNs to train.
+					\param[outputs_			The outputs of the SL
+											samples.
+					\param[weights_			The weights of the SL
+											samples.
+					\param[nextJob_			The index of the next NN
+											to train (shared by all
+											the TrainingThreads).
+					\param[nbBatchThreads_	The number of threads
+											computing the gradient of
+											a mini-batch.
+				*/
+				TrainingThread(ANNAgent* agent_,
+				               std::vector<TrainingJob>* jobList_,
+				               const std::vector<
+				                    std::vector<double> >* outputs_,
+				               const std::vector<double>* weights_,
+				               unsigned int* nextJob_,
+				               unsigned int nbBatchThreads_) :
+						Thread(),
+						agent(agent_), jobList(jobList_),
+						outputs(outputs_), weights(weights_),
+						nextJob(nextJob_),
+						nbBatchThreads(nbBatchThreads_) {}
+			
+				
+				// =======================================================
+				//	Public methods
+				// =======================================================
+				/**
+					\brief	Run the TrainingThread.
+				*/
+				void* run();
+
+
+			private:				
+				// =======================================================
+				//	Private attributes
+				// =======================================================
+				ANNAgent* agent;
+				std::vector<TrainingJob>* jobList;
+				const std::vector<std::vector<double> >* outputs;
+				const std::vector<double>* weights;
+				unsigned int* nextJob;
+				unsigned int nbBatchThreads;
+		};
+
+
+		// =================================================================
+		//	Friendships
+		// =================================================================
+		/**
+			\brief	Allow the TrainingThreads to train the NNs.
+		*/
+		friend class TrainingThread;
 };
 
 #endif
@@ -101,53 +101,28 @@ void SLAgent::generateSLSamples(
      double sumWeights = 0.0;
      for (unsigned int i = 0; i < simRecList.size(); ++i)
      {
-          //   Retrieve the list of transitions from this trajectory
-          vector<simulation::Transition> transitionList;
-          transitionList = simRecList[i].getTransitionList();
-
-          //   Reset 'agent'
-          if (agent) { agent->setMDP(mdpList[i], simGamma, T); }
-
-          //   Reset the variables of 'varList'
-          for (unsigned int j = 0; j < varList.size(); ++j)
-               varList[j]->reset(mdpList[i], simGamma, T);
-
-          //   Browse the trajectory
-          for (unsigned int j = 0; j < transitionList.size(); ++j)
+          //   Replay the trajectory
+          vector<vector<double> > tInputs;
+          vector<unsigned int> tActions;
+          buildTrajectorySamples(agent, varList, mdpList[i], simGamma, T,
+                                 simRecList[i], tInputs, tActions);
+
+          //   Build <input, output> pairs
+          for (unsigned int j = 0; j < tInputs.size(); ++j)
           {
-               //   Retrieve the current transition
-               simulation::Transition t = transitionList[j];
-               unsigned int uP = t.u;
-               
-               //   Replace the action in this transition by the one that would
-               //   have been chosen by 'agent'
-               if (agent) { uP = agent->getAction(t.x); }
-               
-               //   Build <input, output> pair
-               vector<double> input;
-               input = buildInput(
-                         j, varList, dirDistrib->getNbActions(), t.x);
-               
                vector<double> output;
                for (int u = 0; u < dirDistrib->getNbActions(); ++u)
                {
-                    if (u == uP) { output.push_back( 1.0); }
-                    else         { output.push_back(-1.0); }
+                    if (u == (int) tActions[j]) { output.push_back( 1.0); }
+                    else                        { output.push_back(-1.0); }
                }
                
-               inputs.push_back(input);
+               inputs.push_back(tInputs[j]);
                outputs.push_back(output);
                weights.push_back(pow(simGamma, j));               
                indexes.push_back(i);
 
                sumWeights += weights.back();
-
-               //   Update 'agent'
-               if (agent) { agent->learnOnline(t.x, t.u, t.y, t.r); }
-
-               //   Update the variables
-               for (unsigned int i = 0; i < varList.size(); ++i)
-                    varList[i]->update(t.x, t.u, t.y, t.r);
           }
      }
      
@@ -166,6 +141,62 @@ void SLAgent::generateSLSamples(
 }
 
 
+vector<string> SLAgent::generateSLSamples(
+          Agent* agent,
+          const DirMultiDistribution* dirDistrib,
+          unsigned int nbOfMDPs, double simGamma, unsigned int T,
+          string shardPrefix,
+          unsigned int nbThreads) throw (AgentException)
+{
+     if (nbThreads == 0) { nbThreads = 1; }
+     
+     
+     //   Initialize 'agent' (each thread works on its own copy)
+     if (agent) { agent->learnOffline(dirDistrib); }
+
+
+     //   Start the threads
+     unsigned int nextMDP = 0;
+     vector<string> shardFileList;
+     vector<GenerationThread*> threadList;
+     for (unsigned int k = 0; k < nbThreads; ++k)
+     {
+          stringstream sstr;
+          sstr << shardPrefix << "_" << k;
+          shardFileList.push_back(sstr.str());
+          
+          threadList.push_back(new GenerationThread(
+                    (agent ? agent->clone() : 0), dirDistrib,
+                    nbOfMDPs, simGamma, T, &nextMDP, shardFileList.back()));
+          threadList.back()->start();
+     }
+
+
+     //   Wait for the threads
+     bool failed = false;
+     for (unsigned int k = 0; k < nbThreads; ++k)
+     {
+          threadList[k]->join();
+          failed = (failed || threadList[k]->hasFailed());
+          
+          delete threadList[k];
+     }
+     
+     if (failed)
+     {
+          string msg;
+          msg += "Unable to write the SL samples shards '";
+          msg += shardPrefix + "_*'!\n";
+          
+          throw AgentException(msg);
+     }
+     
+     
+     //   Return
+     return shardFileList;
+}
+
+
 void SLAgent::saveSLSamples(const vector<vector<double> >& inputs,
                             const vector<vector<double> >& outputs,
                             const vector<double>& weights,
@@ -285,6 +316,112 @@ void SLAgent::loadSLSamples(istream& is,
 }
 
 
+void SLAgent::loadSLSamples(const vector<string>& shardFileList,
+                            vector<vector<double> >& inputs,
+                            vector<vector<double> >& outputs,
+                            vector<double>& weights,
+                            vector<unsigned int>& indexes)
+                                                  throw (AgentException)
+{
+     //   Clear 'inputs', 'outputs', 'weights' and 'indexes'
+     inputs.clear();
+     outputs.clear();
+     weights.clear();
+     indexes.clear();
+
+
+     //   Load the trajectories of each shard
+     //   (<MDP index, first sample, length>)
+     vector<vector<double> > sInputs;
+     vector<unsigned int> sActions;
+     vector<pair<unsigned int, pair<unsigned int, unsigned int> > > trajList;
+     
+     unsigned int nbActions = 0;
+     double simGamma = 0.0;
+     for (unsigned int k = 0; k < shardFileList.size(); ++k)
+     {
+          ifstream is(shardFileList[k].c_str(), ios::binary);
+          
+          char magic[8];
+          unsigned int nbInputs, nU;
+          double gamma;
+          if (!is.read(magic, 8)
+                    || string(magic, 8) != "SLSHARD1"
+                    || !is.read((char*) &nbInputs, sizeof(nbInputs))
+                    || !is.read((char*) &nU,       sizeof(nU))
+                    || !is.read((char*) &gamma,    sizeof(gamma)))
+          {
+               string msg;
+               msg += "Unable to read the SL samples shard '";
+               msg += shardFileList[k] + "'!\n";
+               
+               throw AgentException(msg);
+          }
+          nbActions = nU;
+          simGamma  = gamma;
+          
+          unsigned int index, length;
+          while (is.read((char*) &index, sizeof(index)))
+          {
+               bool truncated = !is.read((char*) &length, sizeof(length));
+               
+               trajList.push_back(make_pair(index,
+                         make_pair((unsigned int) sInputs.size(),
+                                   (unsigned int) length)));
+               
+               for (unsigned int j = 0; !truncated && j < length; ++j)
+               {
+                    sInputs.push_back(vector<double>(nbInputs));
+                    
+                    unsigned int u = 0;
+                    truncated = (!is.read((char*) &sInputs.back()[0],
+                                          nbInputs*sizeof(double))
+                                 || !is.read((char*) &u, sizeof(u))
+                                 || u >= nU);
+                    sActions.push_back(u);
+               }
+               
+               if (truncated)
+               {
+                    string msg;
+                    msg += "The SL samples shard '";
+                    msg += shardFileList[k] + "' is truncated!\n";
+                    
+                    throw AgentException(msg);
+               }
+          }
+     }
+     sort(trajList.begin(), trajList.end());
+
+
+     //   Build the samples (ordered by MDP)
+     double sumWeights = 0.0;
+     for (unsigned int i = 0; i < trajList.size(); ++i)
+     {
+          unsigned int first  = trajList[i].second.first;
+          unsigned int length = trajList[i].second.second;
+          for (unsigned int j = 0; j < length; ++j)
+          {
+               vector<double> output(nbActions, -1.0);
+               output[sActions[first + j]] = 1.0;
+               
+               inputs.push_back(vector<double>());
+               inputs.back().swap(sInputs[first + j]);
+               outputs.push_back(output);
+               weights.push_back(pow(simGamma, j));
+               indexes.push_back(trajList[i].first);
+               
+               sumWeights += weights.back();
+          }
+     }
+     
+     
+     //   Adjust the weights
+     for (unsigned int i = 0; i < weights.size(); ++i)
+          weights[i] *= (inputs.size() / sumWeights);
+}
+
+
 // ===========================================================================
 //	Public methods
 // ===========================================================================
@@ -294,23 +431,26 @@ int SLAgent::getAction(int xt) const throw (AgentException)
 
 
      //   Build the input
-     vector<double> input = buildInput(xt);
+     buildInput(xt, inputWS);
      
 
      //   Make a prediction of the output
-     vector<double> output = predict(input);
-     assert(output.size() == getMDP()->getNbActions());
+     predict(inputWS, outputWS);
+     assert(outputWS.size() == getMDP()->getNbActions());
 
      
      //   Select the best action according to the SLAgent
-     vector<vector<double>::const_iterator> maxList;
-	maxList =
-	     utils::search::max<vector<double> >(output.begin(), output.end());
-	
-	assert(!maxList.empty());
+     return utils::search::randMax<vector<double> >(
+	          outputWS.begin(), outputWS.end());
+}
+
 
-	int maxI = RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-	return (maxList[maxI] - output.begin());
+void SLAgent::predictBatch(const vector<vector<double> >& inputs,
+                           vector<vector<double> >& outputs) const
+{
+     assert(isSLModelLoaded());
+     
+     predict(inputs, outputs);
 }
 
 
@@ -682,18 +822,73 @@ vector<double> SLAgent::buildInput(
           unsigned int x)
 {
      vector<double> input;
+     buildInput(t, varList, nU, x, input);
+     
+     return input;
+}
+
+
+void SLAgent::buildInput(
+          unsigned int t,
+          const vector<FVariable*>& varList,
+          unsigned int nU,
+          unsigned int x,
+          vector<double>& input)
+{
+     input.resize(varList.size() * nU);
      
      
      //   'varList'
      for (unsigned int i = 0; i < varList.size(); ++i)
      {
           for (unsigned int u = 0; u < nU; ++u)
-               input.push_back((*varList[i])(x, u));
+               input[i*nU + u] = (*varList[i])(x, u);
      }
+}
 
 
-     //   Return
-     return input;
+void SLAgent::buildTrajectorySamples(
+          Agent* agent,
+          const vector<FVariable*>& varList,
+          MDP* mdp, double simGamma, unsigned int T,
+          const simulation::SimulationRecord& simRec,
+          vector<vector<double> >& inputs,
+          vector<unsigned int>& actions)
+{
+     //   Retrieve the list of transitions from this trajectory
+     vector<simulation::Transition> transitionList;
+     transitionList = simRec.getTransitionList();
+
+     //   Reset 'agent'
+     if (agent) { agent->setMDP(mdp, simGamma, T); }
+
+     //   Reset the variables of 'varList'
+     for (unsigned int j = 0; j < varList.size(); ++j)
+          varList[j]->reset(mdp, simGamma, T);
+
+     //   Browse the trajectory
+     for (unsigned int j = 0; j < transitionList.size(); ++j)
+     {
+          //   Retrieve the current transition
+          simulation::Transition t = transitionList[j];
+          unsigned int uP = t.u;
+          
+          //   Replace the action in this transition by the one that would
+          //   have been chosen by 'agent'
+          if (agent) { uP = agent->getAction(t.x); }
+          
+          //   Build the input
+          inputs.push_back(
+                    buildInput(j, varList, mdp->getNbActions(), t.x));
+          actions.push_back(uP);
+
+          //   Update 'agent'
+          if (agent) { agent->learnOnline(t.x, t.u, t.y, t.r); }
+
+          //   Update the variables
+          for (unsigned int i = 0; i < varList.size(); ++i)
+               varList[i]->update(t.x, t.u, t.y, t.r);
+     }
 }
 
 
@@ -753,9 +948,93 @@ void SLAgent::learnOffline_aux(const MDPDistribution* mdpDistrib)
 }
 
 
-vector<double> SLAgent::buildInput(unsigned int x) const
+void SLAgent::buildInput(unsigned int x, vector<double>& input) const
+{
+     buildInput(t, varList, getMDP()->getNbActions(), x, input);
+}
+
+
+void SLAgent::predict(const vector<vector<double> >& inputs,
+                      vector<vector<double> >& outputs) const
 {
-     return buildInput(t, varList, getMDP()->getNbActions(), x);
+     outputs.resize(inputs.size());
+     for (unsigned int i = 0; i < inputs.size(); ++i)
+          predict(inputs[i], outputs[i]);
+}
+
+
+// ===========================================================================
+//	Private Classes - GenerationThread
+// ===========================================================================
+void* SLAgent::GenerationThread::run()
+{
+     ofstream os(shardFile.c_str(), ios::binary);
+
+
+     //   Header
+     vector<FVariable*> varList = buildVarList(dirDistrib);
+     
+     unsigned int nU       = dirDistrib->getNbActions();
+     unsigned int nbInputs = varList.size() * nU;
+     os.write("SLSHARD1", 8);
+     os.write((const char*) &nbInputs, sizeof(nbInputs));
+     os.write((const char*) &nU,       sizeof(nU));
+     os.write((const char*) &simGamma, sizeof(simGamma));
+
+
+     //   Draw the trajectories, one after another
+     for (;;)
+     {
+          unsigned int i = __sync_fetch_and_add(nextMDP, 1);
+          if (i >= nbOfMDPs) { break; }
+
+
+          //   Draw a trajectory
+               //   Agent
+          double epsilon = i / (double) (nbOfMDPs - 1);
+          Agent* eAgent  = new EAgent(epsilon, new OptimalAgent());
+          eAgent->learnOffline(dirDistrib);
+
+               //   MDP
+          MDP* mdp = dirDistrib->draw();
+          
+               //   Simulation
+          simulation::SimulationRecord simRec =
+                    simulation::simulate(eAgent, mdp, simGamma, T, false);
+          
+          delete eAgent;
+
+
+          //   Build its samples
+          vector<vector<double> > inputs;
+          vector<unsigned int> actions;
+          buildTrajectorySamples(agent, varList, mdp, simGamma, T, simRec,
+                                 inputs, actions);
+          
+          delete mdp;
+
+
+          //   Append them to the shard
+          unsigned int length = inputs.size();
+          os.write((const char*) &i,      sizeof(i));
+          os.write((const char*) &length, sizeof(length));
+          for (unsigned int j = 0; j < inputs.size(); ++j)
+          {
+               unsigned int u = actions[j];
+               os.write((const char*) &inputs[j][0],
+                        nbInputs*sizeof(double));
+               os.write((const char*) &u, sizeof(u));
+          }
+     }
+     os.close();
+     failed = os.fail();
+
+
+     //   Free
+     for (unsigned int i = 0; i < varList.size(); ++i)
+          delete varList[i];
+     
+     return 0;
 }
 
 
@@ -147,6 +147,45 @@ class dds::SLAgent : public dds::Agent
                                         std::vector<unsigned int>& indexes);
 
 
+          /**
+		     \brief              Generate SL samples from trajectories drawn
+		                         by several threads, and stream them into
+		                         binary shards (one per thread) as soon as
+		                         each trajectory is simulated.
+		                         
+		                         Each thread only keeps the trajectory it is
+		                         working on in memory. The shards can be
+		                         loaded back with 'loadSLSamples()'.
+               
+               \param[agent        If specified, uses 'agent' to associate an
+                                   action to each sample (the same as those
+                                   that would have been taken by 'agent').
+                                   
+                                   If not specified, associate the optimal
+                                   action.
+
+               \param[dirDistrib   The distribution on which the agent to copy
+                                   has been trained on.
+               \param[nbOfMDPs     The number of MDPs to draw
+                                   (1 trajectory per MDP).
+               \param[simGamma	The discount factor to use for the
+							simulations.
+			\param[T			The horizon limit.
+			\param[shardPrefix  The prefix of the shard files
+			                    ('<shardPrefix>_<thread index>').
+			\param[nbThreads    The number of threads to use.
+			
+			\return             The list of the shard files.
+		*/
+          static std::vector<std::string> generateSLSamples(
+                    Agent* agent,
+                    const DirMultiDistribution* dirDistrib,
+                    unsigned int nbOfMDPs,
+                    double simGamma, unsigned int T,
+                    std::string shardPrefix,
+                    unsigned int nbThreads) throw (AgentException);
+
+
           /**
                \brief              Save the inputs/outputs of the given
                                    SL samples into a file.
@@ -191,6 +230,34 @@ class dds::SLAgent : public dds::Agent
                                     std::vector<unsigned int>& indexes);
 
 
+          /**
+               \brief                   Load the SL samples from binary
+                                        shards (see 'generateSLSamples()').
+                                        
+                                        The samples are sorted by MDP, and
+                                        their weights are normalized as by
+                                        the in-memory 'generateSLSamples()'.
+
+               \param[shardFileList     The list of the shard files.
+               \param[inputs            The vector in which to store inputs 
+                                        of the SL samples.
+               \param[outputs           The vector in which to store outputs 
+                                        of the SL samples.
+               \param[weights           The vector in which to store the
+                                        weights of the SL samples.
+               \param[indexes           The vector in which to store the
+                                        indexes of the MDPs from which each
+                                        sample is from.
+          */
+          static void loadSLSamples(
+                    const std::vector<std::string>& shardFileList,
+                    std::vector<std::vector<double> >& inputs,
+                    std::vector<std::vector<double> >& outputs,
+                    std::vector<double>& weights,
+                    std::vector<unsigned int>& indexes)
+                                                  throw (AgentException);
+
+
 		// =================================================================
 		//	Public methods
 		// =================================================================	
@@ -207,6 +274,20 @@ class dds::SLAgent : public dds::Agent
 		int getAction(int xt) const throw (AgentException);
 
 
+          /**
+               \brief         Predict the score of each action for each of
+                              the given input vectors, in a single pass
+                              through the SL model.
+
+               \param[inputs  The input vectors (see 'buildInput()').
+               \param[outputs The vector in which to store the score of
+                              each action, for each input vector.
+          */
+          void predictBatch(
+                    const std::vector<std::vector<double> >& inputs,
+                    std::vector<std::vector<double> >& outputs) const;
+
+
           /**
 			\brief	Learn from <x, u, y, r> transition (online).
 			
@@ -358,6 +439,17 @@ class dds::SLAgent : public dds::Agent
 
 
 	private:
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		/**
+			\brief	A thread drawing trajectories and streaming their SL
+					samples into its own shard, until the requested
+					number of trajectories has been reached.
+		*/
+		class GenerationThread;
+
+
 		// =================================================================
 		//	Private attributes
 		// =================================================================	
@@ -409,6 +501,13 @@ class dds::SLAgent : public dds::Agent
           std::string slModelFileName;
 
 
+          /**
+               \brief    The inference workspace, reused by each call to
+                         'getAction()' in order to avoid allocations.
+          */
+          mutable std::vector<double> inputWS, outputWS;
+
+
           // =================================================================
 		//	Private static methods
 		// =================================================================
@@ -457,6 +556,52 @@ class dds::SLAgent : public dds::Agent
 		          const std::vector<FVariable*>& varList,
 		          unsigned int nU,
 		          unsigned int x);
+
+
+          /**
+               \brief         Build the input vector (for SL predictions)
+                              w.r.t. the list of 'FVariable's, the number
+                              of actions, and a state, into 'input'.
+               
+               \param[t       The current time-step.
+               \param[varList The list of 'FVariable's.
+               \param[nU      The number of actions.
+               \param[x       A state.
+               \param[input   The vector in which to store the input vector
+                              (its previous content is overwritten).
+          */
+		static void buildInput(
+		          unsigned int t,
+		          const std::vector<FVariable*>& varList,
+		          unsigned int nU,
+		          unsigned int x,
+		          std::vector<double>& input);
+
+
+          /**
+               \brief              Replay a trajectory through the variables
+                                   and build the input and the action of
+                                   each of its transitions.
+               
+               \param[agent        If specified, the agent whose actions are
+                                   associated to the samples (otherwise,
+                                   the actions of the trajectory).
+               \param[varList      The list of 'FVariable's.
+               \param[mdp          The MDP of the trajectory.
+               \param[simGamma	The discount factor used for the
+							simulation.
+			\param[T			The horizon limit.
+               \param[simRec       The trajectory.
+               \param[inputs       The vector in which to store the inputs.
+               \param[actions      The vector in which to store the actions.
+          */
+		static void buildTrajectorySamples(
+		          Agent* agent,
+		          const std::vector<FVariable*>& varList,
+		          MDP* mdp, double simGamma, unsigned int T,
+		          const simulation::SimulationRecord& simRec,
+		          std::vector<std::vector<double> >& inputs,
+		          std::vector<unsigned int>& actions);
 		
 		
 		// =================================================================
@@ -475,14 +620,14 @@ class dds::SLAgent : public dds::Agent
 
 		
 		/**
-		     \brief    Build the input vector (for SL predictions) w.r.t.
-		               the given state.
+		     \brief        Build the input vector (for SL predictions) w.r.t.
+		                   the given state, into 'input'.
 
-		     \param[x  A state.
-		     
-		     \return   The input vector (for SL predictions).
+		     \param[x      A state.
+		     \param[input  The vector in which to store the input vector
+		                   (its previous content is overwritten).
 		*/
-		std::vector<double> buildInput(unsigned int x) const;
+		void buildInput(unsigned int x, std::vector<double>& input) const;
 
           
           /**
@@ -532,12 +677,26 @@ class dds::SLAgent : public dds::Agent
 
                \param[input   A vector where each column corresponds to an
                               input feature.
+               \param[output  The vector in which to store the prediction
+                              (one column per output feature). It is resized
+                              if needed, so that it can be reused from one
+                              call to another without any allocation.
+          */
+          virtual void predict(const std::vector<double>& input,
+                               std::vector<double>& output) const = 0;
 
-               \return        A vector where each column corresponds to a
-                              prediction an output feature.
+
+          /**
+               \brief         Predict the score of each action for each of
+                              the given input vectors.
+                              By default, calls 'predict()' for each input.
+
+               \param[inputs  The input vectors.
+               \param[outputs The vector in which to store the predictions.
           */
-          virtual std::vector<double> predict(
-                    const std::vector<double>& input) const = 0;
+          virtual void predict(
+                    const std::vector<std::vector<double> >& inputs,
+                    std::vector<std::vector<double> >& outputs) const;
 
 		
 		#ifndef NDEBUG
@@ -548,6 +707,96 @@ class dds::SLAgent : public dds::Agent
 		*/
 		virtual void checkIntegrity() const;
 		#endif
+
+
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		class GenerationThread : public utils::Thread
+		{			
+			public:
+				// =======================================================
+				//	Public Constructors
+				// =======================================================
+				/**
+					\brief	Constructor.
+					
+					\param[agent_		The agent whose actions are
+										associated to the samples
+										(0 for the optimal actions).
+										It is owned by this thread.
+					\param[dirDistrib_	The distribution from which
+										to draw the MDPs.
+					\param[nbOfMDPs_		The number of MDPs to draw
+										(shared by all the threads).
+					\param[simGamma_		The discount factor.
+					\param[T_			The horizon limit.
+					\param[nextMDP_		The index of the next MDP to
+										draw (shared by all the
+										threads).
+					\param[shardFile_	The file of the shard of this
+										thread.
+				*/
+				GenerationThread(Agent* agent_,
+				                 const DirMultiDistribution* dirDistrib_,
+				                 unsigned int nbOfMDPs_,
+				                 double simGamma_, unsigned int T_,
+				                 unsigned int* nextMDP_,
+				                 std::string shardFile_) :
+						Thread(),
+						agent(agent_), dirDistrib(dirDistrib_),
+						nbOfMDPs(nbOfMDPs_),
+						simGamma(simGamma_), T(T_),
+						nextMDP(nextMDP_), shardFile(shardFile_),
+						failed(false) {}
+				
+				
+				/**
+					\brief	Destructor.
+				*/
+				~GenerationThread() { if (agent) { delete agent; } }
+			
+				
+				// =======================================================
+				//	Public methods
+				// =======================================================
+				/**
+					\brief	Run the GenerationThread.
+				*/
+				void* run();
+				
+				
+				/**
+					\brief	Return true if the shard could not be
+							written.
+					
+					\return	True if the shard could not be written.
+				*/
+				bool hasFailed() const { return failed; }
+
+
+			private:				
+				// =======================================================
+				//	Private attributes
+				// =======================================================
+				Agent* agent;
+				const DirMultiDistribution* dirDistrib;
+				unsigned int nbOfMDPs;
+				double simGamma;
+				unsigned int T;
+				unsigned int* nextMDP;
+				std::string shardFile;
+				bool failed;
+		};
+
+
+		// =================================================================
+		//	Friendships
+		// =================================================================
+		/**
+			\brief	Allow the GenerationThreads to build the SL samples.
+		*/
+		friend class GenerationThread;
 };
 
 #endif
@@ -62,7 +62,6 @@ int VDBEEGreedyAgent::getAction(int xt) const throw (AgentException)
 	assert(Q.size() == (getMDP()->getNbStates() * getMDP()->getNbActions()));
 
 	
-	double epsilon = epsilonList[xt];
 	double f = RandomGen::rand01_Uniform();
 	
 	//	'random' case
@@ -72,14 +71,8 @@ int VDBEEGreedyAgent::getAction(int xt) const throw (AgentException)
 	//	'greedy' case
 	else
 	{		
-		vector<vector<double>::const_iterator> maxList;
-		maxList = utils::search::max<vector<double> >(
+		return utils::search::randMax<vector<double> >(
 				(Q.begin() + nU*xt), (Q.begin() + nU*xt + nU));
-		
-		assert(!maxList.empty());
-
-		int maxI = RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-		return (maxList[maxI] - (Q.begin() + nU*xt));
 	}
 }
 
@@ -90,17 +83,17 @@ void VDBEEGreedyAgent::learnOnline(int x, int u, int y, double r)
 	assert(cModel);
 	
 	
-	vector<double> pQ = Q;
+	//	Only the Q-value of <x, u> is needed to update the epsilon's
+	//	(no copy of the whole Q-function, 'qIteration()' does not use it)
+	double pQxu = Q[nU*x + u];
 	
 	cModel->update(x, u, y, r);
-	Q = cModel->qIteration(getGamma(), getT(), pQ);
+	Q = cModel->qIteration(getGamma(), getT());
 	
 	
-	for (unsigned int i = 0; i < nX; ++i)
-	{
-		epsilonList[i] = ((delta * f(x, u, sigma, pQ, Q))
-				+ ((1.0 - delta) * epsilonList[i]));
-	}
+	//	The same value difference is applied to each state
+	epsilon = ((delta * f(pQxu, Q[nU*x + u], sigma))
+	           + ((1.0 - delta) * epsilon));
 }
 
 
@@ -110,9 +103,7 @@ void VDBEEGreedyAgent::reset() throw (AgentException)
 	nU = getMDP()->getNbActions();
 	
 	
-	epsilonList.resize(nX);
-	for (unsigned int x = 0; x < nX; ++x)
-		epsilonList[x] = iniEpsilon;
+	epsilon = iniEpsilon;
 	
 	
 	assert(iniModel);
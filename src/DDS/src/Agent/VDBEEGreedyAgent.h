@@ -199,9 +199,12 @@
 		
 		
 		/**
-			\brief	The current value of 'epsilon' for each state.
+			\brief	The current value of 'epsilon', shared by all
+					states (each transition applies the same value
+					difference to every state, so that they never
+					differ).
 		*/
-		std::vector<double> epsilonList;
+		double epsilon;
 
 
 		/**
@@ -243,13 +246,16 @@
 		// =================================================================
 		/**
 			\brief	Used to update the epsilon's with respect to the
-					value differences between the current and previous
-					Q-functions.
+					value difference between the current and previous
+					Q-values of the last state-action pair.
+			
+			\param[pQxu	The previous Q-value.
+			\param[Qxu	The current Q-value.
+			\param[sigma	The inverse sensitivity.
 		*/
-		double f(	double x, double u, double sigma,
-				std::vector<double>& pQ, std::vector<double>& Q)
+		double f(double pQxu, double Qxu, double sigma) const
 		{
-			double eDiff = exp(-fabs(Q[nU*x + u] - pQ[nU*x + u]) / sigma);
+			double eDiff = exp(-fabs(Qxu - pQxu) / sigma);
 			return ((1.0 - eDiff) / (1.0 + eDiff));
 		}
 
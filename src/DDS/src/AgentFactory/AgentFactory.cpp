@@ -157,6 +157,34 @@ dds::AgentFactory* dds::AgentFactory::parse(
                //   Get 'epochRange'
                tmp = parsing::getValue(argc, argv, "--epoch_range");
                unsigned int epochRange = atoi(tmp.c_str());
+               
+               
+               //   Get 'batchSize' (optional, incremental training if
+               //   not specified)
+               unsigned int batchSize = 0;
+               if (parsing::hasFlag(argc, argv, "--batch_size"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--batch_size");
+                    batchSize = atoi(tmp.c_str());
+               }
+               
+               
+               //   Get 'nbThreads' (optional)
+               unsigned int nbThreads = 1;
+               if (parsing::hasFlag(argc, argv, "--n_threads"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--n_threads");
+                    nbThreads = atoi(tmp.c_str());
+               }
+               
+               
+               //   Get 'nbNetworks' (optional)
+               unsigned int nbNetworks = 1;
+               if (parsing::hasFlag(argc, argv, "--n_networks"))
+               {
+                    tmp = parsing::getValue(argc, argv, "--n_networks");
+                    nbNetworks = atoi(tmp.c_str());
+               }
           
           
                //   Get 'base agent factory'
@@ -212,6 +240,7 @@ dds::AgentFactory* dds::AgentFactory::parse(
                          hiddenLayers,
                          learningRate, decreasingLearningRate,
                          maxEpoch, epochRange,
+                         batchSize, nbThreads, nbNetworks,
                          baseAgentFactory,
                          nbOfMDPs, simGamma, T, SLModelFileName);
           }
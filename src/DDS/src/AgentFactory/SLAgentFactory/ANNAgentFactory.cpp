@@ -20,6 +20,9 @@ dds::ANNAgentFactory::ANNAgentFactory(
           bool decreasingLearningRate_,
           unsigned int maxEpoch_,
           unsigned int epochRange_,
+          unsigned int batchSize_,
+          unsigned int nbThreads_,
+          unsigned int nbNetworks_,
           AgentFactory* agentFactory_,
           unsigned int nbOfMDPs_,
           double simGamma_,
@@ -27,7 +30,13 @@ dds::ANNAgentFactory::ANNAgentFactory(
           std::string SLModelFileName_) :
                SLAgentFactory(agentFactory_,
                               nbOfMDPs_, simGamma_, T_,
-                              SLModelFileName_) {}
+                              SLModelFileName_),
+               hiddenLayers(hiddenLayers_),
+               learningRate(learningRate_),
+               decreasingLearningRate(decreasingLearningRate_),
+               maxEpoch(maxEpoch_), epochRange(epochRange_),
+               batchSize(batchSize_), nbThreads(nbThreads_),
+               nbNetworks(nbNetworks_) {}
 
 
 dds::ANNAgentFactory::~ANNAgentFactory() {}
@@ -42,7 +51,7 @@ void dds::ANNAgentFactory::serialize(ostream& os) const
 	
 	
 	os << ANNAgentFactory::toString() << "\n";
-	os << 5 << "\n";
+	os << 8 << "\n";
 	
 	
 	//   'hiddenLayers'
@@ -65,6 +74,18 @@ void dds::ANNAgentFactory::serialize(ostream& os) const
 
      //   'epochRange'
      os << epochRange << "\n";
+
+
+     //   'batchSize'
+     os << batchSize << "\n";
+
+
+     //   'nbThreads'
+     os << nbThreads << "\n";
+
+
+     //   'nbNetworks'
+     os << nbNetworks << "\n";
 }
 
 
@@ -127,6 +148,27 @@ void dds::ANNAgentFactory::deserialize(istream& is)
      if (!getline(is, tmp)) { throwEOFMsg("epochRange"); }
      epochRange = atoi(tmp.c_str());
      ++i;
+     
+     
+     //   'batchSize', 'nbThreads' & 'nbNetworks' (absent from the files
+     //   saved before mini-batch training and ensembles)
+     batchSize  = 0;
+     nbThreads  = 1;
+     nbNetworks = 1;
+     if (n > i)
+     {
+          if (!getline(is, tmp)) { throwEOFMsg("batchSize"); }
+          batchSize = atoi(tmp.c_str());
+          ++i;
+          
+          if (!getline(is, tmp)) { throwEOFMsg("nbThreads"); }
+          nbThreads = atoi(tmp.c_str());
+          ++i;
+          
+          if (!getline(is, tmp)) { throwEOFMsg("nbNetworks"); }
+          nbNetworks = atoi(tmp.c_str());
+          ++i;
+     }
 	
 	
 	//	Number of parameters check
@@ -150,5 +192,6 @@ dds::ANNAgent* dds::ANNAgentFactory::getSLAgent(Agent* agent,
      return new dds::ANNAgent(hiddenLayers,
                               learningRate, decreasingLearningRate,
                               maxEpoch, epochRange,
+                              batchSize, nbThreads, nbNetworks,
                               agent, nbOfMDPs, simGamma, T, SLModelFileName);
 }
@@ -50,6 +50,12 @@
 
                //   TODO
 
+               \param[batchSize_        The number of samples per mini-batch
+                                        (0 for incremental training).
+               \param[nbThreads_        The number of threads training the
+                                        NNs of each ensemble concurrently.
+               \param[nbNetworks_       The number of NNs of each ensemble.
+
 		     \param[agentFactory_     The AgentFactory whose agent will be
 		                              copied.
                \param[nbOfMDPs_         The number of MDPs on which the agent
@@ -70,6 +76,9 @@
 		                bool decreasingLearningRate_,
 		                unsigned int maxEpoch_,
 		                unsigned int epochRange_,
+		                unsigned int batchSize_,
+		                unsigned int nbThreads_,
+		                unsigned int nbNetworks_,
 		                AgentFactory* agentFactory_,
 		                unsigned int nbOfMDPs_,
 		                double simGamma_,
@@ -149,6 +158,9 @@
           bool decreasingLearningRate;
           unsigned int maxEpoch;
           unsigned int epochRange;
+          unsigned int batchSize;
+          unsigned int nbThreads;
+          unsigned int nbNetworks;
 
      
           // =================================================================
@@ -1,5 +1,6 @@
 
 #include "Experiment.h"
+#include "../Agent/Guez/utils/guez_utils.h"
 
 using namespace std;
 using namespace dds;
@@ -30,7 +31,26 @@ Experiment::Experiment(	string name, vector<MDP*>& mdpList,
 	assert((simGamma > 0.0) && (simGamma <= 1.0));
 	assert(T > 0);
 	
+	nbSimulationsList.resize(getNbOfMDPs() * nbSimPerMDP, 0.0);
 	
+	
+	//	Check integrity
+	#ifndef NDEBUG
+	checkIntegrity();
+	#endif
+}
+
+
+Experiment::Experiment(const Experiment& exp, ShareMDPs) :
+						IExperiment<	Agent, MDP,
+									simulation::SimulationRecord>(
+								exp, ShareMDPs()),
+						simGamma(exp.simGamma), T(exp.T),
+						safeSim(exp.safeSim),
+						optimalValueList(exp.optimalValueList),
+						nbSimulationsList(exp.nbSimulationsList.size(), 0.0),
+						profile()
+{
 	//	Check integrity
 	#ifndef NDEBUG
 	checkIntegrity();
@@ -55,8 +75,22 @@ Experiment* Experiment::parse(int argc, char* argv[])
           if (is.fail()) //   Unable to open the file
                throw parsing::ParsingException("--experiment_file");
           
-          return dynamic_cast<Experiment*>(
-                    Serializable::createInstance("Experiment", is));
+          //   (compressed or not, see 'Experiment(istream&)')
+          Experiment* experiment = 0;
+          try
+          {
+               experiment = dynamic_cast<Experiment*>(
+                         Serializable::createInstance("Experiment", is));
+          }
+          catch (SerializableException&)
+          {
+               throw parsing::ParsingException("--experiment_file");
+          }
+          
+          if (!experiment)
+               throw parsing::ParsingException("--experiment_file");
+          
+          return experiment;
      }
 
      
@@ -71,9 +105,11 @@ void Experiment::serialize(ostream& os) const
 {
 	IExperiment<Agent, MDP, simulation::SimulationRecord>::serialize(os);
 	
+	streamsize precision = os.precision();
+	
 	
 	os << Experiment::toString() << "\n";
-	os << 3;
+	os << 6;
 	os << "\n";
 	
 	
@@ -81,6 +117,102 @@ void Experiment::serialize(ostream& os) const
 	os << simGamma << "\n";
 	os << T << "\n";
 	os << safeSim << "\n";
+	
+	
+	//	'optimalValueList'
+	os << optimalValueList.size() << "\n";
+	for (unsigned int j = 0; j < optimalValueList.size(); ++j)
+	{
+		os << setprecision(17) << optimalValueList[j];
+		if (j < (optimalValueList.size() - 1))	{ os << "\t"; }
+		else								{ os << "\n"; }
+	}
+	
+	
+	//	'nbSimulationsList'
+	os << nbSimulationsList.size() << "\n";
+	for (unsigned int j = 0; j < nbSimulationsList.size(); ++j)
+	{
+		os << setprecision(17) << nbSimulationsList[j];
+		if (j < (nbSimulationsList.size() - 1))	{ os << "\t"; }
+		else								{ os << "\n"; }
+	}
+	
+	
+	//	'profile'
+	os << profile.size() << "\n";
+	Profiler::Profile::const_iterator it;
+	for (it = profile.begin(); it != profile.end(); ++it)
+	{
+		os << it->first << "\t" << it->second.count << "\t";
+		os << setprecision(17) << it->second.time << "\n";
+	}
+	
+	os.precision(precision);
+}
+
+
+void Experiment::computeOptimalValues(unsigned int nbThreads)
+{
+	optimalValueList.clear();
+	if (mdpList.empty()) { computeMetrics(); return; }
+	
+	if (nbThreads == 0) { nbThreads = 1; }
+	if (nbThreads > mdpList.size()) { nbThreads = mdpList.size(); }
+	
+	
+	//	Solve the test MDPs
+	optimalValueList.resize(mdpList.size());
+	
+	unsigned int nextMDP = 0;
+	vector<OptimalValueThread*> threadList;
+	for (unsigned int k = 0; k < nbThreads; ++k)
+	{
+		threadList.push_back(new OptimalValueThread(this, &nextMDP));
+		threadList.back()->start();
+	}
+	
+	for (unsigned int k = 0; k < nbThreads; ++k)
+	{
+		threadList[k]->join();
+		delete threadList[k];
+	}
+	
+	
+	//	Update the regrets of the metrics
+	computeMetrics();
+}
+
+
+void Experiment::merge(
+		const IExperiment<Agent, MDP, simulation::SimulationRecord>& exp)
+											throw (ExperimentException)
+{
+	const Experiment* e = dynamic_cast<const Experiment*>(&exp);
+	if (!e || (e->simGamma != simGamma) || (e->T != T)
+			|| (e->safeSim != safeSim))
+	{
+		string msg;
+		msg += "Cannot merge the results of '" + exp.getName() + "': ";
+		msg += "the simulations are not the same!\n";
+		
+		throw ExperimentException(msg);
+	}
+	
+	IExperiment<Agent, MDP, simulation::SimulationRecord>::merge(exp);
+	
+	
+	//	'nbSimulationsList' (no simulation has been performed in both)
+	if (e->nbSimulationsList.size() == nbSimulationsList.size())
+	{
+		for (unsigned int t = 0; t < nbSimulationsList.size(); ++t)
+			if (e->nbSimulationsList[t] > 0.0)
+				nbSimulationsList[t] = e->nbSimulationsList[t];
+	}
+	
+	
+	//	'profile'
+	Profiler::merge(profile, e->profile);
 }
 
 
@@ -124,6 +256,71 @@ void Experiment::deserialize(istream& is) throw (SerializableException)
 	if (!getline(is, tmp)) { throwEOFMsg("safeSim"); }
 	safeSim = atoi(tmp.c_str());
 	++i;
+	
+	
+	//	'optimalValueList' (optional)
+	optimalValueList.clear();
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("optimalValueList"); }
+		unsigned int nbValues = atoi(tmp.c_str());
+		
+		optimalValueList.resize(nbValues);
+		for (unsigned int j = 0; j < nbValues; ++j)
+		{
+			char delim = ((j < (nbValues - 1)) ? '\t' : '\n');
+			if (!getline(is, tmp, delim))
+				throwEOFMsg("optimalValueList");
+			
+			optimalValueList[j] = atof(tmp.c_str());
+		}
+		++i;
+	}
+	
+	
+	//	'nbSimulationsList' (absent from the files saved before its
+	//	addition)
+	nbSimulationsList.clear();
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("nbSimulationsList"); }
+		unsigned int nbValues = atoi(tmp.c_str());
+		
+		nbSimulationsList.resize(nbValues);
+		for (unsigned int j = 0; j < nbValues; ++j)
+		{
+			char delim = ((j < (nbValues - 1)) ? '\t' : '\n');
+			if (!getline(is, tmp, delim))
+				throwEOFMsg("nbSimulationsList");
+			
+			nbSimulationsList[j] = atof(tmp.c_str());
+		}
+		++i;
+	}
+	nbSimulationsList.resize(mdpList.size() * nbSimPerMDP, 0.0);
+	
+	
+	//	'profile' (absent from the files saved before its addition)
+	profile.clear();
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("profile"); }
+		unsigned int nbEntries = atoi(tmp.c_str());
+		
+		for (unsigned int j = 0; j < nbEntries; ++j)
+		{
+			string name;
+			if (!getline(is, name, '\t')) { throwEOFMsg("profile"); }
+			
+			Profiler::Entry& entry = profile[name];
+			if (!getline(is, tmp, '\t')) { throwEOFMsg("profile"); }
+			entry.count = strtoul(tmp.c_str(), 0, 10);
+			
+			if (!getline(is, tmp)) { throwEOFMsg("profile"); }
+			entry.time = atof(tmp.c_str());
+		}
+		++i;
+	}
 
 
 	//	Number of parameters check
@@ -134,6 +331,10 @@ void Experiment::deserialize(istream& is) throw (SerializableException)
 	}
 	
 	
+	//	Update the regrets of the metrics
+	computeMetrics();
+	
+	
 	//	Check integrity
 	#ifndef NDEBUG
 	checkIntegrity();
@@ -141,10 +342,105 @@ void Experiment::deserialize(istream& is) throw (SerializableException)
 }
 
 
+// ===========================================================================
+//	Private methods
+// ===========================================================================
+void Experiment::initRNG(unsigned int seed) const
+{
+	utils::RandomGen::setThreadSeed(seed);
+	guez_utils::setSeed(utils::RandomGen::randIntRange_Uniform(0, INT_MAX));
+}
+
+
+void Experiment::saveTaskData(unsigned int t, const Agent* agent)
+{
+	unsigned int nbDecisions = (saveTraj ? simRecList[t]->getRewardList().size()
+	                                     : rList[t].size());
+	if (nbDecisions == 0) { return; }
+	
+	nbSimulationsList[t] = (agent->getNbSimulations() / (double) nbDecisions);
+}
+
+
+bool Experiment::getOptimalValue(unsigned int j, double& value) const
+{
+	if (optimalValueList.size() != mdpList.size()) { return false; }
+	
+	value = optimalValueList[j];
+	return true;
+}
+
+
+void Experiment::serializeMDP(ostream& os, unsigned int j) const
+{
+	if ((j > 0) && (mdpList[j]->getClassName() == MDP::toString()))
+		mdpList[j]->serialize(os, mdpList[0]);
+	
+	else { mdpList[j]->serialize(os); }
+}
+
+
+MDP* Experiment::deserializeMDP(istream& is, unsigned int j) const
+{
+	MDP* mdp;
+	try { mdp = new MDP(is, (j > 0) ? mdpList[0] : 0); }
+	
+	//	Not a plain MDP
+	catch (SerializableException e)
+	{
+		is.clear();
+		is.seekg(0);
+		
+		mdp = dynamic_cast<MDP*>(Serializable::createInstance<MDP>(is));
+	}
+	
+	
+	//	Share the reward tables with the first MDP (if equal), which also
+	//	deduplicates them in the files saved before their sharing
+	if (j > 0) { mdp->shareTables(*mdpList[0]); }
+	
+	return mdp;
+}
+
+
 #ifndef NDEBUG
 void Experiment::checkIntegrity() const
 {
 	assert((simGamma > 0.0) && (simGamma <= 1.0));
 	assert(T > 0);
+	assert(optimalValueList.empty()
+			|| (optimalValueList.size() == mdpList.size()));
+	assert(nbSimulationsList.size() == (mdpList.size() * nbSimPerMDP));
 }
 #endif
+
+
+// ===========================================================================
+//	Private Classes - OptimalValueThread
+// ===========================================================================
+void* Experiment::OptimalValueThread::run()
+{
+	for (;;)
+	{
+		//	Get the next test MDP to solve
+		unsigned int j = __sync_fetch_and_add(nextMDP, 1);
+		if (j >= exp->mdpList.size()) { break; }
+		
+		
+		//	Solve it
+		//	(over the 'T' steps of a simulation, whether they are
+		//	discounted or not)
+		const MDP* mdp = exp->mdpList[j];
+		vector<double> V = mdp->computeTStepValues(exp->simGamma, exp->T);
+		
+		
+		//	Average it over the initial state distribution
+		vector<double> p = mdp->getIniStateDistribution();
+		
+		double v = 0.0;
+		for (unsigned int x = 0; x < V.size(); ++x) { v += (p[x] * V[x]); }
+		exp->optimalValueList[j] = v;
+	}
+	
+	return 0;
+}
@@ -64,7 +64,7 @@
 		
 		/**
 			\brief	Destructor.
-			          'mdpList' is freed.
+			          'mdpList' is freed (unless it is shared).
 		*/
 		~Experiment() {}
 
@@ -100,6 +100,22 @@
 			\return	The name of the class of this object.
 		*/
 		std::string getClassName() const { return Experiment::toString(); }
+		
+		
+		/**
+			\brief	Create an Experiment performing the same simulations
+					as this Experiment, on the same test MDPs, without
+					any result.
+					The test MDPs are shared, not copied: this Experiment
+					keeps the responsibility to delete them (and must
+					outlive the returned Experiment).
+			
+			\return	The Experiment created.
+		*/
+		Experiment* emptyCopy() const
+		{
+			return new Experiment(*this, ShareMDPs());
+		}
 
 
           /**
@@ -118,6 +134,91 @@
                \return   The horizon limit used during the simulations.
 		*/
 		unsigned int getT() const { return T; }
+		
+		
+		/**
+			\brief	Return the optimal value of each test MDP, i.e. the
+					expected discounted sum of rewards of an agent
+					knowing the MDP (empty if not computed, see
+					'computeOptimalValues()').
+			
+			\return	The optimal value of each test MDP.
+		*/
+		const std::vector<double>& getOptimalValueList() const
+		{
+			return optimalValueList;
+		}
+		
+		
+		/**
+			\brief	Return the mean number of simulations per decision
+					performed by the agent during each simulation of
+					this Experiment (0 if not performed yet, or if the
+					agent does not plan, see 'Agent::getNbSimulations()').
+			
+			\return	The mean number of simulations per decision
+					performed during each simulation.
+		*/
+		const std::vector<double>& getNbSimulationsList() const
+		{
+			return nbSimulationsList;
+		}
+		
+		
+		/**
+			\brief	Return the time spent in each instrumented phase, and
+					the instrumented counters, over the runs of this
+					Experiment (empty unless compiled with PROFILING, see
+					'utils::Profiler').
+			
+			\return	The profile of the runs of this Experiment.
+		*/
+		const utils::Profiler::Profile& getProfile() const
+		{
+			return profile;
+		}
+		
+		
+		/**
+			\brief			Add the data of 'profile_' to the profile of
+							this Experiment.
+			
+			\param[profile_	The data to add (see
+							'utils::Profiler::collect()').
+		*/
+		void addProfile(const utils::Profiler::Profile& profile_)
+		{
+			utils::Profiler::merge(profile, profile_);
+		}
+		
+		
+		/**
+			\brief			Compute the optimal value of each test MDP
+							(the optimal expected sum of rewards over
+							the 'T' steps of a simulation, discounted by
+							'simGamma'), which allows to report the
+							regret of the agents without solving the
+							test MDPs again (see 'computeRegretList()').
+							The value is averaged over the initial state
+							distribution of each MDP.
+			
+			\param[nbThreads	The number of threads solving the test
+							MDPs concurrently.
+		*/
+		void computeOptimalValues(unsigned int nbThreads = 1);
+		
+		
+		/**
+			\brief		Add the results of 'exp' to this Experiment.
+						Throw an ExperimentException if 'exp' is not
+						defined on the same simulations, or if a
+						simulation has been performed in both.
+			
+			\param[exp	The Experiment whose results to add.
+		*/
+		void merge(const IExperiment<	Agent, MDP,
+								simulation::SimulationRecord>& exp)
+									throw (ExperimentException);
 
 		
 		/**
@@ -159,6 +260,56 @@
 					to access MDP data (e.g.: the transition matrix).
 		*/
 		bool safeSim;
+		
+		
+		/**
+			\brief	The optimal value of each test MDP
+					(see 'computeOptimalValues()').
+		*/
+		std::vector<double> optimalValueList;
+		
+		
+		/**
+			\brief	The mean number of simulations per decision performed
+					by the agent during each simulation
+					(see 'getNbSimulationsList()').
+		*/
+		std::vector<double> nbSimulationsList;
+		
+		
+		/**
+			\brief	The profile of the runs of this Experiment
+					(see 'getProfile()').
+		*/
+		utils::Profiler::Profile profile;
+
+		
+		// =================================================================
+		//	Private Constructors
+		// =================================================================
+		/**
+			\brief		Constructor (see 'emptyCopy()').
+			
+			\param[exp	The Experiment whose test MDPs are shared.
+		*/
+		Experiment(const Experiment& exp, ShareMDPs);
+		
+		
+		/**
+			\brief	Not implemented: an Experiment cannot be copied
+					(see 'emptyCopy()').
+		*/
+		Experiment(const Experiment&);
+
+		
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		/**
+			\brief	A thread solving the test MDPs, one after another,
+					until none is left.
+		*/
+		class OptimalValueThread;
 
 		
 		// =================================================================
@@ -177,6 +328,65 @@
 		{
 			return simulation::simulate(agent, mdp, simGamma, T, safeSim);
 		}
+		
+		
+		/**
+			\brief		Reseed the RNGs used by the calling thread during
+						the simulations (including the ones of A. Guez's
+						agents, see 'guez_utils::setSeed()').
+			
+			\param[seed	The seed to use.
+		*/
+		void initRNG(unsigned int seed) const;
+		
+		
+		/**
+			\brief		Save the mean number of simulations per
+						decision performed by 'agent' during task 't'
+						(see 'nbSimulationsList').
+			
+			\param[t		The task which has just been performed.
+			\param[agent	The agent used to perform it.
+		*/
+		void saveTaskData(unsigned int t, const Agent* agent);
+		
+		
+		/**
+			\brief		Retrieve the optimal value of the j-th test MDP
+						(see 'optimalValueList').
+			
+			\param[j		The index of the MDP in 'mdpList'.
+			\param[value	The optimal value of the MDP (output).
+			
+			\return		True if the optimal values have been computed,
+						false else.
+		*/
+		bool getOptimalValue(unsigned int j, double& value) const;
+
+		
+		/**
+			\brief		Serialize the j-th test MDP.
+						The MDPs sharing their reward tables with the
+						first one are serialized without them.
+			
+			\param[os	The stream in which to serialize the MDP.
+			\param[j		The index of the MDP in 'mdpList'.
+		*/
+		void serializeMDP(std::ostream& os, unsigned int j) const;
+		
+		
+		/**
+			\brief		Deserialize the j-th test MDP (see
+						'serializeMDP()').
+						The reward tables of the MDP are shared with the
+						first one when they are equal.
+			
+			\param[is	The stream from which to deserialize the MDP.
+			\param[j		The index of the MDP in 'mdpList'.
+			
+			\return		The deserialized MDP.
+		*/
+		MDP* deserializeMDP(std::istream& is, unsigned int j) const;
 
 		
 		
@@ -188,6 +398,57 @@
 		*/
 		void checkIntegrity() const;
 		#endif
+
+
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		class OptimalValueThread : public utils::Thread
+		{			
+			public:
+				// =======================================================
+				//	Public Constructors
+				// =======================================================
+				/**
+					\brief	Constructor.
+					
+					\param[exp_		The Experiment whose test MDPs to
+								solve.
+					\param[nextMDP_	The index of the next test MDP to
+								solve (shared by all the
+								OptimalValueThreads).
+				*/
+				OptimalValueThread(Experiment* exp_,
+				                   unsigned int* nextMDP_) :
+						Thread(), exp(exp_), nextMDP(nextMDP_) {}
+			
+				
+				// =======================================================
+				//	Public methods
+				// =======================================================
+				/**
+					\brief	Run the OptimalValueThread.
+				*/
+				void* run();
+
+
+			private:				
+				// =======================================================
+				//	Private attributes
+				// =======================================================
+				Experiment* exp;
+				unsigned int* nextMDP;
+		};
+
+
+		// =================================================================
+		//	Friendships
+		// =================================================================
+		/**
+			\brief	Allow the OptimalValueThreads to fill
+					'optimalValueList'.
+		*/
+		friend class OptimalValueThread;
 };
 
 #endif
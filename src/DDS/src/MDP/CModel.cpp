@@ -102,18 +102,31 @@ void CModel::updateP(unsigned int x, unsigned int u)
 	assert(u < nU);
 	
 	
+	assert(Np[nU*x + u] > 0.0);
+	
+	
+	//	'connexityMap' (the states which were not reachable yet)
 	for (unsigned int y = 0; y < nX; ++y)
 	{
-		assert(Np[nU*x + u] > 0.0);
-		
-		P[nX*nU*x + nX*u + y]
-				= (N[nX*nU*x + nX*u + y] / Np[nU*x + u]);
-				
-		if (N[nX*nU*x + nX*u + y]  != 0)
+		if ((N[nX*nU*x + nX*u + y] != 0) && (P[nX*nU*x + nX*u + y] == 0.0))
 			connexityMap[nU*x + u].insert(y);
 	}
 	
 	
+	//	'P'
+	if (kernels)
+		kernels->computeP(&N[nX*nU*x + nX*u], Np[nU*x + u], &P[nX*nU*x + nX*u]);
+	
+	else
+	{
+		for (unsigned int y = 0; y < nX; ++y)
+		{
+			P[nX*nU*x + nX*u + y]
+					= (N[nX*nU*x + nX*u + y] / Np[nU*x + u]);
+		}
+	}
+	
+	
 	//	Check integrity
 	#ifndef NDEBUG
 	checkIntegrity();
@@ -16,6 +16,12 @@ MDP::MDP(std::istream& is) : IMDP()
 }
 
 
+MDP::MDP(std::istream& is, const MDP* mdp) : IMDP()
+{
+	deserialize(is, mdp);
+}
+
+
 MDP::MDP(	string name,
 		unsigned int nX_, unsigned int nU_,
 		int iniState_,
@@ -37,6 +43,46 @@ MDP::MDP(	string name,
 	connexityMap = computeConnexityMap(nX, nU, P);
 	
 	
+	//	'kernels'
+	kernels = MDPKernels::get(nX, nU);
+	
+	
+	//	Reset
+	reset();
+	
+	
+	//	Check integrity
+	#ifndef NDEBUG
+	checkIntegrity();
+	#endif
+}
+
+
+MDP::MDP(	string name,
+		unsigned int nX_, unsigned int nU_,
+		int iniState_,
+		const vector<double>& P_,
+		RewardType rType_,
+		const SharedVector<double>& R_, const SharedVector<double>& V_) :
+			IMDP(name),
+			nX(nX_), nU(nU_), iniState(iniState_),
+			P(P_), rType(rType_), R(R_), V(V_),
+			known(true)
+{
+	assert((iniState == -1) || ((iniState >= 0) && (iniState < (int) nX)));
+	assert(P.size() == (nX * nU * nX));
+	assert(R.size() == (nX * nU * nX));
+	assert(V.empty() || (V.size() == (nX * nU * nX)));
+	
+	
+	//	'connexityMap'
+	connexityMap = computeConnexityMap(nX, nU, P);
+	
+	
+	//	'kernels'
+	kernels = MDPKernels::get(nX, nU);
+	
+	
 	//	Reset
 	reset();
 	
@@ -91,12 +137,15 @@ void MDP::perform(unsigned int u, unsigned int& y, double& r)
 	
 	//	Compute 'y'
 	double s = RandomGen::rand01_Uniform();
-	double cumul = 0.0;
-	
-	for (y = 0; y < nX; ++y)
+	if (kernels) { y = kernels->drawState(&P[nX*nU*xt + nX*u], s); }
+	else
 	{
-		cumul += P[nX*nU*xt + nX*u + y];
-		if (s <= cumul) { break; }
+		double cumul = 0.0;
+		for (y = 0; y < nX; ++y)
+		{
+			cumul += P[nX*nU*xt + nX*u + y];
+			if (s <= cumul) { break; }
+		}
 	}
 	y %= nX;	//	WARNING:	In rare cases, due to imprecision in number
 			//			representation, the sum of probabilities could
@@ -142,6 +191,7 @@ void MDP::perform(unsigned int u, unsigned int& y, double& r)
 
 void MDP::reset()
 {
+	//	(uniform draw if 'iniState' = -1, see 'getIniStateDistribution()')
 	if (iniState != -1) { xt = iniState; }
 	else { xt = RandomGen::randIntRange_Uniform(0, (nX - 1)); }
 	
@@ -153,9 +203,36 @@ void MDP::reset()
 }
 
 
+vector<double> MDP::getIniStateDistribution() const throw (MDPException)
+{
+	if (!isKnown())
+	{
+		std::string msg;
+		msg += "Cannot retrieve the initial state distribution of an ";
+		msg += "unknown MDP!\n";
+		
+		throw MDPException(msg);
+	}
+	
+	
+	//	Either a fixed initial state, or a uniform draw (see 'reset()')
+	if (iniState != -1)
+	{
+		vector<double> p(nX, 0.0);
+		p[iniState] = 1.0;
+		
+		return p;
+	}
+	
+	return vector<double>(nX, (1.0 / nX));
+}
+
+
 vector<double> MDP::valueIteration(double gamma, unsigned int T,
 						vector<double> pV) const throw (MDPException)
 {
+	PROFILE_SCOPE("MDP::valueIteration");
+	
 	if (!isKnown())
 	{
 		std::string msg;
@@ -171,6 +248,12 @@ vector<double> MDP::valueIteration(double gamma, unsigned int T,
 	if (pV.size() != nX) { pV.clear(); pV.resize(nX); }
 	vector<double> V(nX);
 	
+	if (kernels)
+	{
+		kernels->valueIteration(&P[0], &R[0], gamma, T, &pV[0], &V[0]);
+		return V;
+	}
+	
 	bool hasConverged;
 	unsigned int t = 0;
 	do
@@ -180,31 +263,29 @@ vector<double> MDP::valueIteration(double gamma, unsigned int T,
 		
 		
 		//	Update 'V'
+		//	(only the reachable states are browsed, see 'connexityMap')
 		hasConverged = true;
 		for (unsigned int x = 0; x < nX; ++x)
 		{
 			//	Get 'max_u sum_y P(x, u, y) (R(x, u, y)+ gamma pV(y))'
 			double max = 0.0;
-			for (unsigned int y = 0; y < nX; ++y)
-			{
-				unsigned int i = (nX*nU*x + y);
-				max += (P[i] * (R[i] + (gamma * pV[y])));
-			}
-			
-			
-			for (unsigned int u = 1; u < nU; ++u)
+			for (unsigned int u = 0; u < nU; ++u)
 			{
 				//	Compute the current value
 				double cur = 0.0;
-				for (unsigned int y = 0; y < nX; ++y)
+				
+				set<unsigned int>::const_iterator it, end;
+				it	= connexityMap[nU*x + u].begin();
+				end	= connexityMap[nU*x + u].end();
+				for (; it != end; ++it)
 				{
-					unsigned int i = (nX*nU*x + nX*u + y);
-					cur += (P[i] * (R[i] + (gamma * pV[y])));
+					unsigned int i = (nX*nU*x + nX*u + *it);
+					cur += (P[i] * (R[i] + (gamma * pV[*it])));
 				}
 				
 				
 				//	Update the maximum
-				if (max < cur) { max = cur; }
+				if ((u == 0) || (max < cur)) { max = cur; }
 			}
 			
 			
@@ -223,9 +304,76 @@ vector<double> MDP::valueIteration(double gamma, unsigned int T,
 }
 
 
+vector<double> MDP::computeTStepValues(double gamma, unsigned int T) const
+											throw (MDPException)
+{
+	PROFILE_SCOPE("MDP::computeTStepValues");
+	
+	if (!isKnown())
+	{
+		std::string msg;
+		msg += "Cannot compute the T-step values of an unknown MDP!\n";
+		
+		throw MDPException(msg);
+	}
+	
+	assert((gamma > 0.0) && (gamma <= 1.0));
+
+
+	vector<double> pV(nX, 0.0), V(nX, 0.0);
+	
+	if (kernels)
+	{
+		kernels->computeTStepValues(&P[0], &R[0], gamma, T, &pV[0], &V[0]);
+		return V;
+	}
+	
+	for (unsigned int t = 0; t < T; ++t)
+	{
+		//	Save the previous 'V'
+		pV.swap(V);
+		
+		
+		//	Update 'V'
+		//	(only the reachable states are browsed, see 'connexityMap')
+		for (unsigned int x = 0; x < nX; ++x)
+		{
+			//	Get 'max_u sum_y P(x, u, y) (R(x, u, y)+ gamma pV(y))'
+			double max = 0.0;
+			for (unsigned int u = 0; u < nU; ++u)
+			{
+				//	Compute the current value
+				double cur = 0.0;
+				
+				set<unsigned int>::const_iterator it, end;
+				it	= connexityMap[nU*x + u].begin();
+				end	= connexityMap[nU*x + u].end();
+				for (; it != end; ++it)
+				{
+					unsigned int i = (nX*nU*x + nX*u + *it);
+					cur += (P[i] * (R[i] + (gamma * pV[*it])));
+				}
+				
+				
+				//	Update the maximum
+				if ((u == 0) || (max < cur)) { max = cur; }
+			}
+			
+			
+			//	Update 'V(x)'
+			V[x] = max;
+		}
+	}
+	
+	return V;
+}
+
+
 vector<double> MDP::qIteration(double gamma, unsigned int T,
 						vector<double> pQ) const throw (MDPException)
 {
+	PROFILE_SCOPE("MDP::qIteration");
+	
 	if (!isKnown())
 	{
 		std::string msg;
@@ -241,6 +389,14 @@ vector<double> MDP::qIteration(double gamma, unsigned int T,
 	if (pQ.size() != (nX * nU)) { pQ.clear(); pQ.resize(nX * nU); }
 	vector<double> Q(nX * nU);
 	
+	if (kernels)
+	{
+		kernels->qIteration(&P[0], &R[0], gamma, T, &pQ[0], &Q[0]);
+		return Q;
+	}
+	
+	vector<double> maxV(nX);
+	
 	bool hasConverged;
 	unsigned int t = 0;
 	do
@@ -251,6 +407,15 @@ vector<double> MDP::qIteration(double gamma, unsigned int T,
 				pQ[nU*x + u] = Q[nU*x + u];
 		
 		
+		//	'max_v pQ(y, v)' (shared by every <x, u> pair)
+		for (unsigned int y = 0; y < nX; ++y)
+		{
+			maxV[y] = pQ[nU*y];
+			for (unsigned int v = 1; v < nU; ++v)
+				if (maxV[y] < pQ[nU*y + v]) { maxV[y] = pQ[nU*y + v]; }
+		}
+		
+		
 		//	Update 'Q'
 		hasConverged = true;
 		for (unsigned int x = 0; x < nX; ++x)
@@ -264,17 +429,10 @@ vector<double> MDP::qIteration(double gamma, unsigned int T,
 				set<unsigned int>::iterator it, end;
 				it	= connexityMap[nU*x + u].begin();
 				end	= connexityMap[nU*x + u].end();
-				for (unsigned int y = *it; it != end; ++it, y = *it)
-				{					
-					//	'max_v pQ(y, v)'
-					double maxV = pQ[nU*y];
-					for (unsigned int v = 1; v < nU; ++v)
-						if (maxV < pQ[nU*y + v]) { maxV = pQ[nU*y + v]; }
-					
-					
-					//	Update 'Q(x, u)'
-					unsigned int j = (nX*nU*x + nX*u + y);
-					Q[i] += (P[j] * (R[j] + (gamma * maxV)));
+				for (; it != end; ++it)
+				{
+					unsigned int j = (nX*nU*x + nX*u + *it);
+					Q[i] += (P[j] * (R[j] + (gamma * maxV[*it])));
 				}
 				
 				
@@ -288,13 +446,34 @@ vector<double> MDP::qIteration(double gamma, unsigned int T,
 }
 
 
-void MDP::serialize(ostream& os) const
+bool MDP::shareTables(const MDP& mdp)
+{
+	if (sharesTablesWith(mdp))	{ return true; }
+	if ((nX != mdp.nX) || (nU != mdp.nU)
+			|| (R.get() != mdp.R.get()) || (V.get() != mdp.V.get()))
+	{
+		return false;
+	}
+
+	R = mdp.R;
+	V = mdp.V;
+	
+	return true;
+}
+
+
+void MDP::serialize(ostream& os, const MDP* mdp) const
 {
 	IMDP::serialize(os);
 	
 	
+	//	If the reward tables are shared with 'mdp', they are replaced
+	//	by a single '=' line
+	bool shared = (mdp && sharesTablesWith(*mdp));
+	
 	os << MDP::toString() << "\n";
-	os << (3 + P.size() + 1 + R.size() + 1 + V.size()) << "\n";
+	if (shared)	{ os << (3 + P.size() + 1 + 1) << "\n";						}
+	else			{ os << (3 + P.size() + 1 + R.size() + 1 + V.size()) << "\n";	}
 
 
 	//	'nX', 'nU', 'xt'
@@ -317,7 +496,13 @@ void MDP::serialize(ostream& os) const
 
 	
 	//	'rType', 'R', 'V'
-	os << rType << "\n";	
+	os << rType << "\n";
+	if (shared)
+	{
+		os << "=\n";
+		return;
+	}
+	
 	for (unsigned int u = 0; u < nU; ++u)
 		for (unsigned int x = 0; x < nX; ++x)
 		{
@@ -346,7 +531,8 @@ void MDP::serialize(ostream& os) const
 }
 
 
-void MDP::deserialize(istream& is) throw (SerializableException)
+void MDP::deserialize(istream& is, const MDP* mdp)
+											throw (SerializableException)
 {
 	IMDP::deserialize(is);
 	
@@ -412,51 +598,74 @@ void MDP::deserialize(istream& is) throw (SerializableException)
 	++i;
 	
 	
-	R.resize(nX * nU * nX);
-	for (unsigned int u = 0; u < nU; ++u)
-	{		
-		for (unsigned int x = 0; x < nX; ++x)
+	//	'R' and 'V' shared with 'mdp'
+	if (is.peek() == '=')
+	{
+		if (!mdp || (mdp->nX != nX) || (mdp->nU != nU))
 		{
-			for (unsigned int y = 0; y < (nX - 1); ++y)
-			{
-				if (!getline(is, tmp, '\t')) { throwEOFMsg("R value"); }
-				R[nX*nU*x + nX*u + y] = atof(tmp.c_str());
-				++i;
-			}
-			
-			if (!getline(is, tmp)) { throwEOFMsg("R value"); }
-			R[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
-			++i;
+			string msg;
+			msg += "Error with 'R': the reward tables are shared with an ";
+			msg += "MDP which has not been provided.\n";
+			throw SerializableException(msg);
 		}
+		
+		getline(is, tmp);
+		R = mdp->R;
+		V = mdp->V;
+		++i;
 	}
 	
-	if (!getline(is, tmp)) { throwEOFMsg("has a V matrix"); }
-	bool hasV = atoi(tmp.c_str());
-	++i;
-	
-	if (hasV)
+	else
 	{
-		V.resize(nX * nU * nX);
+		vector<double> newR(nX * nU * nX);
 		for (unsigned int u = 0; u < nU; ++u)
 		{		
 			for (unsigned int x = 0; x < nX; ++x)
 			{
 				for (unsigned int y = 0; y < (nX - 1); ++y)
 				{
-					if (!getline(is, tmp, '\t'))
-						throwEOFMsg("V value");
-
-					V[nX*nU*x + nX*u + y] = atof(tmp.c_str());
+					if (!getline(is, tmp, '\t')) { throwEOFMsg("R value"); }
+					newR[nX*nU*x + nX*u + y] = atof(tmp.c_str());
 					++i;
 				}
-				
-				if (!getline(is, tmp)) { throwEOFMsg("V value"); }
-				V[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
+			
+				if (!getline(is, tmp)) { throwEOFMsg("R value"); }
+				newR[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
 				++i;
 			}
 		}
+	
+		R = SharedVector<double>(newR);
+	
+		if (!getline(is, tmp)) { throwEOFMsg("has a V matrix"); }
+		bool hasV = atoi(tmp.c_str());
+		++i;
+	
+		vector<double> newV;
+		if (hasV)
+		{
+			newV.resize(nX * nU * nX);
+			for (unsigned int u = 0; u < nU; ++u)
+			{		
+				for (unsigned int x = 0; x < nX; ++x)
+				{
+					for (unsigned int y = 0; y < (nX - 1); ++y)
+					{
+						if (!getline(is, tmp, '\t'))
+							throwEOFMsg("V value");
+
+						newV[nX*nU*x + nX*u + y] = atof(tmp.c_str());
+						++i;
+					}
+				
+					if (!getline(is, tmp)) { throwEOFMsg("V value"); }
+					newV[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
+					++i;
+				}
+			}
+		}
+		V = SharedVector<double>(newV);
 	}
-	else { V.clear(); }
 	
 	
 	//	Number of parameters check
@@ -472,6 +681,10 @@ void MDP::deserialize(istream& is) throw (SerializableException)
 	connexityMap = computeConnexityMap(nX, nU, P);
 	
 	
+	//	'kernels'
+	kernels = MDPKernels::get(nX, nU);
+	
+	
 	//	'known'
 	known = true;
 	
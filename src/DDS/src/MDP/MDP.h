@@ -3,6 +3,7 @@
 #define MDP_H
 
 #include "../dds.h"
+#include "MDPKernels.h"
 #include "../../ExternalLibs.h"
 
 
@@ -46,6 +47,19 @@ class dds::MDP : public IMDP
 		MDP(std::istream& is);
 		
 		
+		/**
+			\brief		Constructor.
+			
+			\param[is	The 'ifstream' containting the data representing
+						the MDP to load.
+						(can either be compressed or uncompressed)
+			\param[mdp	The MDP whose reward tables are shared by the MDP
+						to load, if they have been serialized with
+						'serialize(os, mdp)'. (can be 0)
+		*/
+		MDP(std::istream& is, const MDP* mdp);
+		
+		
 		/**
 			\brief			Constructor.
 			
@@ -68,6 +82,29 @@ class dds::MDP : public IMDP
 			const std::vector<double>& R_, const std::vector<double>& V_);
 
 
+		/**
+			\brief			Constructor.
+			
+			\param[name		The name of this MDP.
+			\param[nX_		The number of states.
+			\param[nU_		The number of actions.
+			\param[iniState_	The initial state. (-1: drawn randomly)
+			\param[P_			The probability matrix. (size: nX * nU * nX)
+			\param[rType_		The type of rewards.
+			\param[R_			The list of rewards means, shared with this MDP.
+							(size: nX * nU * nX)
+			\param[V_			The list of rewards variances, shared with this
+							MDP. (size: nX * nU * nX or 0; if 0: no variance)
+		*/
+		MDP(	std::string name,
+			unsigned int nX_, unsigned int nU_,
+			int iniState_,
+			const std::vector<double>& P_,
+			RewardType rType_,
+			const utils::SharedVector<double>& R_,
+			const utils::SharedVector<double>& V_);
+
+
 		/**
 			\brief	Destructor.
 		*/
@@ -186,6 +223,23 @@ class dds::MDP : public IMDP
 											throw (MDPException);
 		
 		
+		/**
+			\brief		Compute the optimal expected sum of rewards over
+						'T' steps, discounted by 'gamma', from each state
+						of this MDP, by backward induction ('T' backups
+						exactly, unlike 'valueIteration()' which performs
+						'T' + 1 of them and may stop earlier).
+			
+			\param[gamma	The discount factor. (in ]0; 1])
+			\param[T		The number of steps.
+			
+			\return		The optimal 'T'-step value of each state.
+						(size: nX)
+		*/
+		std::vector<double> computeTStepValues(double gamma,
+				unsigned int T) const throw (MDPException);
+		
+		
 		/**
 			\brief	Return true if this MDP is 'known', false else.
 			
@@ -215,6 +269,18 @@ class dds::MDP : public IMDP
 		}
 		
 		
+		/**
+			\brief	If 'known', return the probability of each state to
+					be the initial state of this MDP (see 'reset()'),
+					throw a MDPException else.
+			
+			\return	The initial state distribution of this MDP.
+					(size: nX)
+		*/
+		std::vector<double> getIniStateDistribution() const
+											throw (MDPException);
+		
+		
 		/**
 			\brief	If 'known', return the transition matrix of this
 					MDP, throw a MDPException else.
@@ -277,7 +343,7 @@ class dds::MDP : public IMDP
 				throw MDPException(msg);
 			}
 			
-			return R;
+			return R.get();
 		}
 		
 		
@@ -300,7 +366,7 @@ class dds::MDP : public IMDP
 				throw MDPException(msg);
 			}
 			
-			return V;
+			return V.get();
 		}
 
 
@@ -310,16 +376,47 @@ class dds::MDP : public IMDP
 			\param[name	The new name of this MDP.
 		*/
 		void setName(std::string name) { IMDP::setName(name); }
+
+
+		/**
+			\brief		If the reward tables of 'mdp' are equal to the ones
+						of this MDP, share them with this MDP.
+			
+			\param[mdp	An MDP.
+			
+			\return		True if the reward tables of 'mdp' are now shared
+						with this MDP, false else.
+		*/
+		bool shareTables(const MDP& mdp);
+
+
+		/**
+			\brief		Return true if this MDP shares its reward tables
+						with 'mdp', false else.
+			
+			\param[mdp	An MDP.
+			
+			\return		True if this MDP shares its reward tables with
+						'mdp', false else.
+		*/
+		bool sharesTablesWith(const MDP& mdp) const
+		{
+			return (R.isSharedWith(mdp.R) && V.isSharedWith(mdp.V));
+		}
 		
 		
 		/**
-			\brief	Return a clone of this MDP.
+			\brief	Return a clone of this MDP (which shares the reward
+					tables of this MDP).
 			
 			\return	A clone of this MDP.
 		*/
 		virtual MDP* clone() const
 		{
-			return cloneInstance<MDP>(this);
+			std::stringstream sstr;
+			serialize(sstr, this);
+			
+			return new MDP(sstr, this);
 		}
 
 		
@@ -338,7 +435,19 @@ class dds::MDP : public IMDP
 					call the 'serialize()' method of the base class
 					before doing anything else.
 		*/
-		virtual void serialize(std::ostream& os) const;
+		virtual void serialize(std::ostream& os) const { serialize(os, 0); }
+		
+		
+		/**
+			\brief		Serialize this Object.
+						If this MDP shares its reward tables with 'mdp',
+						they are not serialized. The resulting data can
+						only be loaded with 'MDP(is, mdp)'.
+			
+			\param[os	The stream in which to serialize this Object.
+			\param[mdp	An MDP. (can be 0)
+		*/
+		void serialize(std::ostream& os, const MDP* mdp) const;
 		
 		
 		/**
@@ -348,7 +457,10 @@ class dds::MDP : public IMDP
 					before doing anything else.
 		*/
 		virtual void deserialize(std::istream& is)
-									throw (SerializableException);
+									throw (SerializableException)
+		{
+			deserialize(is, 0);
+		}
 		
 		
 	protected:
@@ -358,7 +470,7 @@ class dds::MDP : public IMDP
 		/**
 			\brief	Constructor.
 		*/
-		MDP() : IMDP() {}
+		MDP() : IMDP(), kernels(0) {}
 		
 		
 		// =================================================================
@@ -396,15 +508,17 @@ class dds::MDP : public IMDP
 		
 		/**
 			\brief	The list of rewards means. (size: nX * nU * nX)
+					(shared with the MDPs drawn from the same distribution)
 		*/
-		std::vector<double> R;
+		utils::SharedVector<double> R;
 		
 		
 		/**
 			\brief	The list of rewards variances
 					(size: nX * nU * nX or 0; if 0: no variance).
+					(shared with the MDPs drawn from the same distribution)
 		*/
-		std::vector<double> V;
+		utils::SharedVector<double> V;
 		
 		
 		/**
@@ -420,6 +534,13 @@ class dds::MDP : public IMDP
 					algorithms.
 		*/
 		std::vector<std::set<unsigned int> > connexityMap;
+		
+		
+		/**
+			\brief	The kernels compiled for the size of this MDP, used
+					instead of the generic loops. (0 if there are none)
+		*/
+		const MDPKernels* kernels;
 
 
 	private:
@@ -436,6 +557,18 @@ class dds::MDP : public IMDP
 		// =================================================================
 		//	Private methods
 		// =================================================================
+		/**
+			\brief		Deserialize this Object.
+			
+			\param[is	The stream from which to deserialize this Object.
+			\param[mdp	The MDP whose reward tables are shared by this
+						Object, if they have been serialized with
+						'serialize(os, mdp)'. (can be 0)
+		*/
+		void deserialize(std::istream& is, const MDP* mdp)
+									throw (SerializableException);
+		
+		
 		/**
 			\brief	Set this MDP as 'known'.
 		*/
@@ -0,0 +1,177 @@
+
+#include "MDPKernels.h"
+
+using namespace std;
+using namespace dds;
+
+
+// ===========================================================================
+//	Compiled kernels
+// ===========================================================================
+namespace
+{
+	/**
+		\brief	The MDPKernels of the MDPs of NX states and NU actions.
+	*/
+	template<unsigned int NX, unsigned int NU>
+	class SMDPKernels : public MDPKernels
+	{
+		public:
+			SMDPKernels() {}
+
+
+			unsigned int drawState(const double* Pxu, double s) const
+			{
+				double cumul = 0.0;
+
+				unsigned int y;
+				for (y = 0; y < NX; ++y)
+				{
+					cumul += Pxu[y];
+					if (s <= cumul) { break; }
+				}
+
+				return y;
+			}
+
+
+			void valueIteration(
+					const double* P, const double* R, double gamma,
+					unsigned int T, double* pV, double* V) const
+			{
+				bool hasConverged;
+				unsigned int t = 0;
+				do
+				{
+					//	Save the previous 'V'
+					for (unsigned int x = 0; x < NX; ++x) { pV[x] = V[x]; }
+
+
+					//	Update 'V'
+					hasConverged = true;
+					for (unsigned int x = 0; x < NX; ++x)
+					{
+						double max = 0.0;
+						for (unsigned int u = 0; u < NU; ++u)
+						{
+							const double* Pxu = &P[NX*NU*x + NX*u];
+							const double* Rxu = &R[NX*NU*x + NX*u];
+
+							double cur = 0.0;
+							for (unsigned int y = 0; y < NX; ++y)
+								cur += (Pxu[y] * (Rxu[y] + (gamma * pV[y])));
+
+							if ((u == 0) || (max < cur)) { max = cur; }
+						}
+
+						V[x] = max;
+						if (fabs(V[x] - pV[x]) > ACCURACY) { hasConverged = false; }
+					}
+				}
+				while ((t++ < T) && !hasConverged);
+			}
+
+
+			void qIteration(
+					const double* P, const double* R, double gamma,
+					unsigned int T, double* pQ, double* Q) const
+			{
+				bool hasConverged;
+				unsigned int t = 0;
+				do
+				{
+					//	Save the previous 'Q'
+					for (unsigned int i = 0; i < NX*NU; ++i) { pQ[i] = Q[i]; }
+
+
+					//	'max_v pQ(y, v)' (shared by every <x, u> pair)
+					double maxV[NX];
+					for (unsigned int y = 0; y < NX; ++y)
+					{
+						maxV[y] = pQ[NU*y];
+						for (unsigned int v = 1; v < NU; ++v)
+							if (maxV[y] < pQ[NU*y + v]) { maxV[y] = pQ[NU*y + v]; }
+					}
+
+
+					//	Update 'Q'
+					hasConverged = true;
+					for (unsigned int i = 0; i < NX*NU; ++i)
+					{
+						const double* Pxu = &P[NX*i];
+						const double* Rxu = &R[NX*i];
+
+						double cur = 0.0;
+						for (unsigned int y = 0; y < NX; ++y)
+							cur += (Pxu[y] * (Rxu[y] + (gamma * maxV[y])));
+
+						Q[i] = cur;
+						if (fabs(Q[i] - pQ[i]) > ACCURACY) { hasConverged = false; }
+					}
+				}
+				while ((t++ < T) && !hasConverged);
+			}
+
+
+			void computeTStepValues(
+					const double* P, const double* R, double gamma,
+					unsigned int T, double* pV, double* V) const
+			{
+				for (unsigned int t = 0; t < T; ++t)
+				{
+					//	Save the previous 'V'
+					for (unsigned int x = 0; x < NX; ++x) { pV[x] = V[x]; }
+
+
+					//	Update 'V'
+					for (unsigned int x = 0; x < NX; ++x)
+					{
+						double max = 0.0;
+						for (unsigned int u = 0; u < NU; ++u)
+						{
+							const double* Pxu = &P[NX*NU*x + NX*u];
+							const double* Rxu = &R[NX*NU*x + NX*u];
+
+							double cur = 0.0;
+							for (unsigned int y = 0; y < NX; ++y)
+								cur += (Pxu[y] * (Rxu[y] + (gamma * pV[y])));
+
+							if ((u == 0) || (max < cur)) { max = cur; }
+						}
+
+						V[x] = max;
+					}
+				}
+			}
+
+
+			void computeP(const double* Nxu, double Np, double* Pxu) const
+			{
+				for (unsigned int y = 0; y < NX; ++y) { Pxu[y] = (Nxu[y] / Np); }
+			}
+	};
+
+
+	//	GC and UGC (5 states, 3 actions)
+	const SMDPKernels<5, 3> kernels_5_3;
+
+	//	GDL and UGDL (9 states, 2 actions)
+	const SMDPKernels<9, 2> kernels_9_2;
+
+	//	Note:	Grid and UGrid (25 states, 4 actions) are not compiled, since
+	//		their transition matrices are sparse (2 reachable states per
+	//		<state, action> pair): browsing the 'connexityMap' is faster
+	//		than browsing the 25 states of each pair.
+}
+
+
+// ===========================================================================
+//	Public static methods
+// ===========================================================================
+const MDPKernels* MDPKernels::get(unsigned int nX, unsigned int nU)
+{
+	if ((nX == 5) && (nU == 3))	{ return &kernels_5_3;	}
+	if ((nX == 9) && (nU == 2))	{ return &kernels_9_2;	}
+
+	return 0;
+}
@@ -0,0 +1,138 @@
+
+#ifndef MDPKERNELS_H
+#define MDPKERNELS_H
+
+#include "../dds.h"
+#include "../../ExternalLibs.h"
+
+
+// ===========================================================================
+/*
+	\class 	MDPKernels
+
+	\brief 	The hot loops of an MDP ('perform()', 'valueIteration()',
+			'qIteration()', 'computeTStepValues()' and
+			'CModel::updateP()'), compiled for a given number of states
+			and actions.
+
+			The loops have constant bounds and constant strides, so that
+			they can be fully unrolled and vectorized by the compiler.
+			The matrices are browsed densely (the null transitions add
+			'0.0' to the sums), in the same order as the generic code
+			of MDP, so that the results are exactly the same.
+
+			Only instantiated for the sizes of the small benchmark
+			problems, whose transition matrices are dense (see 'get()');
+			the other MDPs use the generic code.
+*/
+// ===========================================================================
+class dds::MDPKernels
+{
+	public:
+		// =================================================================
+		//	Public Constructors/Destructors
+		// =================================================================
+		/**
+			\brief	Destructor.
+		*/
+		virtual ~MDPKernels() {}
+
+
+		// =================================================================
+		//	Public static methods
+		// =================================================================
+		/**
+			\brief		Return the kernels compiled for MDPs of 'nX' states
+						and 'nU' actions, or 0 if there are none.
+
+			\param[nX		The number of states.
+			\param[nU		The number of actions.
+
+			\return		The kernels compiled for MDPs of 'nX' states and
+						'nU' actions, or 0 if there are none.
+		*/
+		static const MDPKernels* get(unsigned int nX, unsigned int nU);
+
+
+		// =================================================================
+		//	Public methods
+		// =================================================================
+		/**
+			\brief		Return the state drawn from the probability row
+						'Pxu' (see 'MDP::perform()').
+
+			\param[Pxu	The transition probabilities of a <state, action>
+						pair. (size: nX)
+			\param[s		A number drawn uniformly in [0; 1].
+
+			\return		The drawn state. (nX if the sum of 'Pxu' is lower
+						than 's')
+		*/
+		virtual unsigned int drawState(const double* Pxu, double s) const = 0;
+
+
+		/**
+			\brief		Compute the V-function of an MDP (see
+						'MDP::valueIteration()').
+
+			\param[P		The probability matrix. (size: nX * nU * nX)
+			\param[R		The list of rewards means. (size: nX * nU * nX)
+			\param[gamma	The discount factor.
+			\param[T		The maximal number of iterations.
+			\param[pV		The initial V-function, overwritten by the
+						previous iterate. (size: nX)
+			\param[V		The computed V-function. (size: nX)
+		*/
+		virtual void valueIteration(
+				const double* P, const double* R, double gamma,
+				unsigned int T, double* pV, double* V) const = 0;
+
+
+		/**
+			\brief		Compute the Q-function of an MDP (see
+						'MDP::qIteration()').
+
+			\param[P		The probability matrix. (size: nX * nU * nX)
+			\param[R		The list of rewards means. (size: nX * nU * nX)
+			\param[gamma	The discount factor.
+			\param[T		The maximal number of iterations.
+			\param[pQ		The initial Q-function, overwritten by the
+						previous iterate. (size: nX * nU)
+			\param[Q		The computed Q-function. (size: nX * nU)
+		*/
+		virtual void qIteration(
+				const double* P, const double* R, double gamma,
+				unsigned int T, double* pQ, double* Q) const = 0;
+
+
+		/**
+			\brief		Compute the optimal 'T'-step values of an MDP (see
+						'MDP::computeTStepValues()').
+
+			\param[P		The probability matrix. (size: nX * nU * nX)
+			\param[R		The list of rewards means. (size: nX * nU * nX)
+			\param[gamma	The discount factor.
+			\param[T		The number of steps.
+			\param[pV		A buffer for the previous iterate. (size: nX)
+			\param[V		The computed values, initially null.
+						(size: nX)
+		*/
+		virtual void computeTStepValues(
+				const double* P, const double* R, double gamma,
+				unsigned int T, double* pV, double* V) const = 0;
+
+
+		/**
+			\brief		Compute the probability row of a <state, action>
+						pair from its counters (see 'CModel::updateP()').
+
+			\param[Nxu	The counters of the <state, action> pair.
+						(size: nX)
+			\param[Np		The sum of the counters of 'Nxu'.
+			\param[Pxu	The computed probability row. (size: nX)
+		*/
+		virtual void computeP(
+				const double* Nxu, double Np, double* Pxu) const = 0;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 using namespace std;
 using namespace dds;
+using namespace utils;
 
 
 // ===========================================================================
@@ -45,6 +46,8 @@ DirMultiDistribution::DirMultiDistribution(
 // ===========================================================================
 MDP* DirMultiDistribution::draw() const
 {
+	PROFILE_SCOPE("DirMultiDistribution::draw");
+	
 	vector<double> P(nX * nU * nX);
 	
 	for (unsigned int x = 0; x < nX; ++x)
@@ -56,6 +59,7 @@ MDP* DirMultiDistribution::draw() const
 					nX);
 		}
 
+	//	('R' and 'V' are shared with the MDP)
 	return (new MDP("", nX, nU, iniState, P, rType, R, V));
 }
 
@@ -197,7 +201,7 @@ void DirMultiDistribution::deserialize(istream& is) throw (SerializableException
 	++i;
 	
 	
-	R.resize(nX * nU * nX);
+	vector<double> newR(nX * nU * nX);
 	for (unsigned int u = 0; u < nU; ++u)
 	{		
 		for (unsigned int x = 0; x < nX; ++x)
@@ -205,23 +209,26 @@ void DirMultiDistribution::deserialize(istream& is) throw (SerializableException
 			for (unsigned int y = 0; y < (nX - 1); ++y)
 			{
 				if (!getline(is, tmp, '\t')) { throwEOFMsg("R value"); }
-				R[nX*nU*x + nX*u + y] = atof(tmp.c_str());
+				newR[nX*nU*x + nX*u + y] = atof(tmp.c_str());
 				++i;
 			}
 			
 			if (!getline(is, tmp)) { throwEOFMsg("R value"); }
-			R[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
+			newR[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
 			++i;
 		}
 	}
 	
+	R = SharedVector<double>(newR);
+	
 	if (!getline(is, tmp)) { throwEOFMsg("has a V matrix"); }
 	bool hasV = atoi(tmp.c_str());
 	++i;
 	
+	vector<double> newV;
 	if (hasV)
 	{
-		V.resize(nX * nU * nX);
+		newV.resize(nX * nU * nX);
 		for (unsigned int u = 0; u < nU; ++u)
 		{		
 			for (unsigned int x = 0; x < nX; ++x)
@@ -231,17 +238,17 @@ void DirMultiDistribution::deserialize(istream& is) throw (SerializableException
 					if (!getline(is, tmp, '\t'))
 						throwEOFMsg("V value");
 
-					V[nX*nU*x + nX*u + y] = atof(tmp.c_str());
+					newV[nX*nU*x + nX*u + y] = atof(tmp.c_str());
 					++i;
 				}
 				
 				if (!getline(is, tmp)) { throwEOFMsg("V value"); }
-				V[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
+				newV[nX*nU*x + nX*u + (nX - 1)] = atof(tmp.c_str());
 				++i;
 			}
 		}
 	}
-	else { V.clear(); }
+	V = SharedVector<double>(newV);
 	
 	
 	//	Number of parameters check
@@ -174,7 +174,7 @@
 		*/
 		const std::vector<double>& getR() const throw (MDPException)
 		{
-			return R;
+			return R.get();
 		}
 		
 		
@@ -187,7 +187,7 @@
 		const std::vector<double>& getV() const
 									throw (MDPDistributionException)
 		{
-			return V;
+			return V.get();
 		}
 
 		
@@ -259,15 +259,17 @@
 		
 		/**
 			\brief	The list of rewards means. (size: nX * nU * nX)
+					(shared with the MDPs drawn from this distribution)
 		*/
-		std::vector<double> R;
+		utils::SharedVector<double> R;
 		
 		
 		/**
 			\brief	The list of rewards variances
 					(size: nX * nU * nX or 0; if 0: no variance).
+					(shared with the MDPs drawn from this distribution)
 		*/
-		std::vector<double> V;
+		utils::SharedVector<double> V;
 		
 		
 		// =================================================================
@@ -159,6 +159,8 @@ dds::simulation::SimulationRecord dds::simulation::simulate(
 	assert(agent);
 	assert(mdp);
 	assert((gamma > 0.0) && (gamma <= 1.0));
+	
+	PROFILE_SCOPE("simulate");
 
 
 	//	Create a SimulationRecord
@@ -182,7 +184,11 @@ dds::simulation::SimulationRecord dds::simulation::simulate(
 	for (unsigned int t = 0; t < T; ++t)
 	{
 		//	Retrieve the action to perform
-		unsigned int u = agent->getAction(x);
+		unsigned int u;
+		{
+			PROFILE_SCOPE("Agent::getAction");
+			u = agent->getAction(x);
+		}
 		
 		
 		//	Perform the selected action
@@ -196,7 +202,10 @@ dds::simulation::SimulationRecord dds::simulation::simulate(
 		
 		
 		//	Online learning of the agent
-		agent->learnOnline(x, u, y, r);
+		{
+			PROFILE_SCOPE("Agent::learnOnline");
+			agent->learnOnline(x, u, y, r);
+		}
 		
 		
 		//	Update of the data
@@ -40,6 +40,13 @@ namespace dds
 	const double ZERO_ACCURACY = 1e-9;
 	
 	
+	/**
+		\brief	The maximal number of Q-functions kept in the cache of
+				the OptimalAgents (see 'OptimalAgent::reset()').
+	*/
+	const unsigned int OPTIMAL_Q_CACHE_SIZE = 1024;
+	
+	
 	// ======================================================================
 	//	Functions
 	// ======================================================================
@@ -317,6 +324,14 @@ namespace dds
 	class MDP;
 	
 	
+	/**
+          \class    MDPKernels
+          \brief 	The hot loops of a MDP, compiled for a given number of
+	               states and actions.
+	*/
+	class MDPKernels;
+	
+	
 	/**
           \class    MDPDistribution
           \brief 	Interface of a MDP distribution.
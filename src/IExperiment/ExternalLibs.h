@@ -1,4 +1,9 @@
 
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "../RLUtils/RLUtilsLib.h"
 #include "../Serializable/SerializableLib.h"
 #include "../Utils/UtilsLib.h"
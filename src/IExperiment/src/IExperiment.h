@@ -1,7 +1,6 @@
 
 #ifndef IEXPERIMENT_H
 #define IEXPERIMENT_H
-#include <unistd.h>
 #include "ExperimentException.h"
 #include "../ExternalLibs.h"
 
@@ -20,6 +19,34 @@ template<typename AgentType, typename MDPType, typename SimulationRecordType>
 class IExperiment : public Serializable
 {
 	public:
+		// =================================================================
+		//	Public Classes
+		// =================================================================
+		/**
+			\brief	A snapshot of the running metrics of an IExperiment
+					(see 'getMetrics()').
+		*/
+		struct Metrics
+		{
+			//	The discounted sums of rewards of the simulations
+			//	performed (see 'computeDSRList()')
+			utils::RunningStatistics dsr;
+			
+			//	Their regrets (see 'computeRegretList()'), if the optimal
+			//	values of the test MDPs are known (see 'getOptimalValue()')
+			utils::RunningStatistics regret;
+			
+			//	The time spent in each simulation performed since this
+			//	IExperiment has been created or loaded (in ms)
+			utils::RunningStatistics taskTime;
+			
+			//	The number of simulations performed by each
+			//	SimulationThread, and the time spent in them (in ms)
+			std::vector<unsigned int> nbTasksList;
+			std::vector<double> threadTimeList;
+		};
+		
+		
 		// =================================================================
 		//	Public Constructors/Destructors
 		// =================================================================
@@ -28,7 +55,12 @@ class IExperiment : public Serializable
 			
 			\param[name_	The name of this IExperiment.
 		*/
-		IExperiment(std::string name_ = "") : Serializable(), name(name_) {}
+		IExperiment(std::string name_ = "") :
+				Serializable(), name(name_), ownMDPs(true),
+				shardIndex(0), nbShards(1), taskSeed(0), orderSeed(0)
+		{
+			pthread_mutex_init(&m_metrics, NULL);
+		}
 		
 		
 		/**
@@ -50,7 +82,8 @@ class IExperiment : public Serializable
 		
 		/**
 			\brief	Destructor.
-			          'mdpList' is freed.
+			          'mdpList' is freed (unless it is shared).
+			          The SimulationThreads are stopped (if any).
 		*/
 		virtual ~IExperiment();
 
@@ -64,6 +97,51 @@ class IExperiment : public Serializable
 			\return	The string representation of this class name.
 		*/
 		static std::string toString() { return "IExperiment"; }
+		
+		
+		/**
+			\brief			Run several experiments, each one with its
+							own agent, for a certain amount of time
+							'timeLimit'.
+							Continue from when they stop since the last
+							call of 'runAll()'.
+							
+							The simulations of all the experiments are
+							performed by a single set of
+							SimulationThreads (hosted by the first
+							IExperiment of 'expList'), so that the
+							threads stay busy as long as any experiment
+							has simulations left.
+							The time elapsed of each IExperiment is
+							increased by its share of the time spent
+							in the simulations.
+			
+			\param[expList	The IExperiments to run.
+			\param[agentList	The Agent to test on each IExperiment of
+							'expList'.
+			\param[timeLimit	The time limit (in ms)
+							(0: perform all simulations without
+							stopping)
+			\param[nThreads	The number of threads to use to perform
+							the simulations.
+		*/
+		static void runAll(	std::vector<IExperiment*>& expList,
+						std::vector<AgentType*>& agentList,
+						double timeLimit_ = 0.0,
+						unsigned int nbThreads = 1);
+		
+		
+		/**
+			\brief		Add 'dir' to the directories searched for the
+						files of the test-set store referenced by the
+						IExperiments loaded from now on, when the
+						referenced path cannot be opened (e.g.: the
+						experiment file has been created from another
+						working directory or on another machine).
+			
+			\param[dir	A directory of a test-set store.
+		*/
+		static void addTestSetStoreDir(const std::string& dir);
 
 
 		// =================================================================
@@ -74,6 +152,18 @@ class IExperiment : public Serializable
 							of time 'timeLimit'.
 							Continue from when it stops since the last
 							call of 'run()'.
+							
+							In the multi-thread case, the
+							SimulationThreads (and their copy of 'agent')
+							are kept from one call to another, as long
+							as the same agent and number of threads are
+							used.
+							The simulations are distributed one by one
+							(a task is a single (MDP, simulation) pair),
+							and idle threads steal the remaining tasks
+							of the other ones.
+							The time limit is checked after each
+							simulation.
 			
 			\param[agent		The Agent to test.
 			\param[timeLimit	The time limit (in ms)
@@ -92,6 +182,114 @@ class IExperiment : public Serializable
 		void clear();
 		
 		
+		/**
+			\brief			Restrict this IExperiment to the simulations
+							't' such that 't % nbShards_ == shardIndex_'
+							(simulation 't' being the simulation
+							't % nbSimPerMDP' of MDP 't / nbSimPerMDP').
+							The progress is then relative to these
+							simulations only.
+							
+							The results of the different shards can be
+							gathered with 'merge()'.
+			
+			\param[shardIndex_	The index of the shard
+							(in [0; nbShards_[).
+			\param[nbShards_	The number of shards.
+		*/
+		void setShard(unsigned int shardIndex_, unsigned int nbShards_);
+		
+		
+		/**
+			\brief			If 'taskSeed_' > 0, the RNGs are reseeded
+							before each simulation 't' with a seed
+							derived from 'taskSeed_' and 't'.
+							
+							The result of a simulation then only depends
+							on 't' and 'taskSeed_', and not on the order
+							in which the simulations are performed, nor on
+							the thread or the process performing them
+							(each thread reseeds its own stream, see
+							'initRNG()').
+			
+			\param[taskSeed_	The seed from which the seed of each
+							simulation is derived (0: disabled).
+		*/
+		void setTaskSeed(unsigned int taskSeed_) { taskSeed = taskSeed_; }
+		
+		
+		/**
+			\brief			If 'orderSeed_' > 0, the test MDPs are
+							processed in a random order (a permutation
+							drawn from 'orderSeed_') instead of their
+							order in 'mdpList'. The simulations of the
+							same MDP remain contiguous.
+							
+							The simulations performed at any time are
+							then a random sample of the test MDPs, so
+							that the Experiment can be stopped before
+							its end without bias.
+			
+			\param[orderSeed_	The seed of the permutation (0: disabled).
+		*/
+		void setRandomOrder(unsigned int orderSeed_)
+		{
+			orderSeed = orderSeed_;
+		}
+		
+		
+		/**
+			\brief		Add the results of 'exp' to this IExperiment.
+						Throw an ExperimentException if 'exp' is not
+						defined on the same simulations, if it has not
+						been seeded the same way (see 'setShard()' and
+						'setTaskSeed()'), or if a simulation has been
+						performed in both.
+						
+						If overloaded, the new 'merge()' method should
+						call the 'merge()' method of the base class
+						after its own checks.
+			
+			\param[exp	The IExperiment whose results to add.
+		*/
+		virtual void merge(const IExperiment& exp)
+									throw (ExperimentException);
+		
+		
+		/**
+			\brief			Serialize the test MDPs once in the test-set
+							store 'storeDir', under a file named after
+							the hash of their content.
+							The file is referenced by its path as given
+							by 'storeDir' (usually relative to the
+							working directory), and found back by its
+							name in the directories of the test-set
+							store otherwise (see 'addTestSetStoreDir()').
+							From now on, this IExperiment (and the
+							results derived from it) only references
+							this file instead of embedding the MDPs.
+							
+							If the same test set has already been
+							stored, the existing file is reused.
+			
+			\param[storeDir	The directory of the test-set store
+							(created, with its parent directories, if
+							it does not exist).
+		*/
+		void storeTestSet(std::string storeDir)
+									throw (SerializableException);
+		
+		
+		/**
+			\brief	Return the file of the test-set store referenced by
+					this IExperiment (empty if the test MDPs are embedded).
+			
+			\return	The file of the test-set store referenced by
+					this IExperiment.
+		*/
+		std::string getTestSetFile() const { return testSetFile; }
+		
+		
 		/**
 			\brief	Return the number of test MDPs used in this
 					Experiment.
@@ -117,7 +315,7 @@ class IExperiment : public Serializable
 		*/
 		double getProgress() const
 		{
-			return (nextMDP / ((double) mdpList.size()));
+			return (nbDone / ((double) getNbTasks()));
 		}
 
 	
@@ -130,6 +328,19 @@ class IExperiment : public Serializable
 		double getTimeElapsed() const { return timeElapsed; }
 		
 		
+		/**
+			\brief	Return a snapshot of the running metrics of this
+					IExperiment, which are updated at the end of each
+					call of 'run()' with the metrics accumulated by each
+					thread (in O(1) with respect to the number of
+					simulations, and without pausing the threads).
+			
+			\return	A snapshot of the running metrics of this
+					IExperiment.
+		*/
+		Metrics getMetrics() const;
+		
+		
 		/**
 			\brief	Compute and return the list of discounted sum of
 					rewards of the simulations discounted by 'gamma'
@@ -148,6 +359,45 @@ class IExperiment : public Serializable
 		std::vector<double> computeDSRList(double gamma = -1.0) const;
 		
 		
+		/**
+			\brief				Compute and return the list of regrets
+								of the simulations, i.e. the optimal
+								value of their test MDP minus their
+								discounted sum of rewards (see
+								'computeDSRList()').
+			
+			\param[optimalValueList	The optimal value of each test MDP
+								(under the discount factor used during
+								the simulations).
+			
+			\return				The list of regrets of the simulations.
+		*/
+		std::vector<double> computeRegretList(
+				const std::vector<double>& optimalValueList) const;
+		
+		
+		/**
+			\brief			Compute the discounted sums of rewards of
+							the simulations performed both in this
+							IExperiment and in 'exp', paired by
+							simulation (see 'computeDSRList()').
+							Throw an ExperimentException if 'exp' is not
+							defined on the same simulations.
+			
+			\param[exp		The IExperiment to compare with.
+			\param[dsrList	The discounted sums of rewards of this
+							IExperiment.
+			\param[expDSRList	The discounted sums of rewards of 'exp'.
+			\param[gamma		The discount factor (see
+							'computeDSRList()').
+		*/
+		void computePairedDSRLists(
+				const IExperiment& exp,
+				std::vector<double>& dsrList,
+				std::vector<double>& expDSRList,
+				double gamma = -1.0) const throw (ExperimentException);
+		
+		
 		/**
                \brief    Return the list of MDPs used by this IExperiment.
                
@@ -225,6 +475,33 @@ class IExperiment : public Serializable
 
 
 	protected:
+		// =================================================================
+		//	Protected Classes
+		// =================================================================
+		/**
+			\brief	Tag selecting the constructor which shares the test
+					MDPs of another IExperiment.
+		*/
+		struct ShareMDPs {};
+		
+		
+		// =================================================================
+		//	Protected Constructors
+		// =================================================================
+		/**
+			\brief		Constructor.
+						Create an IExperiment performing the same
+						simulations as 'exp', on the same test MDPs.
+						The test MDPs are shared, not copied: 'exp'
+						keeps the responsibility to delete them (and
+						must outlive this IExperiment).
+						The results of 'exp' are not copied.
+			
+			\param[exp	The IExperiment whose test MDPs are shared.
+		*/
+		IExperiment(const IExperiment& exp, ShareMDPs);
+		
+		
 		// =================================================================
 		//	Protected attributes
 		// =================================================================
@@ -268,22 +545,19 @@ class IExperiment : public Serializable
 		
 		
 		/**
-			\brief	The index of the next MDP to simulate.
+			\brief	The number of simulations performed so far
+					(in the current shard).
 		*/
-		unsigned int nextMDP;
-
-
-		/**
-			\brief	A mutex on 'nextMDP'
-					(only for multi-thread).
-		*/
-		pthread_mutex_t m_nextMDP;
+		unsigned int nbDone;
 		
 		
 		/**
-			\brief	The list of copies of 'agent' associated to each
-					SimulationThread
-					(only for multi-thread).
+			\brief	The list of copies of the agents associated to each
+					SimulationThread, where the copy of the agent of
+					'poolExpList[k]' used by SimulationThread 'ID' is
+					at position 'ID * poolExpList.size() + k'.
+					(only for multi-thread; kept from one call of 'run()'
+					to another).
 		*/
 		std::vector<AgentType*> copyAgentList;
 		
@@ -318,9 +592,126 @@ class IExperiment : public Serializable
 		*/
 		virtual SimulationRecordType
 				simulate(AgentType* agent, MDPType* mdp) const = 0;
+		
+		
+		/**
+			\brief		Reseed the RNGs used by the calling thread during
+						the simulations (see 'setTaskSeed()').
+						Should be overloaded if other RNGs than
+						'utils::RandomGen' are involved.
+			
+			\param[seed	The seed to use.
+		*/
+		virtual void initRNG(unsigned int seed) const
+		{
+			utils::RandomGen::setThreadSeed(seed);
+		}
+
+		
+		/**
+			\brief		Save the data about task 't' which are not part
+						of its SimulationRecord (called right after
+						the simulation of task 't', possibly from
+						several threads at once).
+						Should be overloaded to store additional
+						per-task results.
+			
+			\param[t		The task which has just been performed.
+			\param[agent	The agent used to perform it.
+		*/
+		virtual void saveTaskData(unsigned int, const AgentType*) {}
+
+
+		/**
+			\brief		Retrieve the optimal value of the j-th test MDP, in
+						order to compute the regrets of its simulations
+						(see 'getMetrics()').
+						Should be overloaded if the optimal values of the
+						test MDPs are known.
+			
+			\param[j		The index of the MDP in 'mdpList'.
+			\param[value	The optimal value of the MDP (output).
+			
+			\return		True if the optimal value of the MDP is known,
+						false else.
+		*/
+		virtual bool getOptimalValue(unsigned int, double&) const
+		{
+			return false;
+		}
+
+
+		/**
+			\brief	Recompute the running statistics of the discounted
+					sums of rewards and of the regrets from the
+					simulations performed (see 'getMetrics()').
+					Should be called whenever the results of 
+					'getOptimalValue()' change.
+		*/
+		void computeMetrics();
+
+
+		/**
+			\brief		Serialize the j-th test MDP.
+						Can be overloaded to serialize the test MDPs in a
+						more compact form (e.g.: relatively to the
+						previous ones).
+			
+			\param[os	The stream in which to serialize the MDP.
+			\param[j		The index of the MDP in 'mdpList'.
+		*/
+		virtual void serializeMDP(std::ostream& os, unsigned int j) const
+		{
+			mdpList[j]->serialize(os);
+		}
+
+
+		/**
+			\brief		Deserialize the j-th test MDP (see
+						'serializeMDP()'). The previous test MDPs have
+						already been added to 'mdpList'.
+			
+			\param[is	The stream from which to deserialize the MDP.
+			\param[j		The index of the MDP in 'mdpList'.
+			
+			\return		The deserialized MDP.
+		*/
+		virtual MDPType* deserializeMDP(std::istream& is, unsigned int) const
+		{
+			return dynamic_cast<MDPType*>(
+					Serializable::createInstance<MDPType>(is));
+		}
 
 
 	private:
+		// =================================================================
+		//	Private Classes (declarations)
+		// =================================================================
+		struct TaskRange;
+		struct ThreadMetrics;
+		class SimulationThread;
+		
+		
+		// =================================================================
+		//	Private Constructors
+		// =================================================================
+		/**
+			\brief	Not implemented: an IExperiment cannot be copied
+					(see 'IExperiment(const IExperiment&, ShareMDPs)').
+		*/
+		IExperiment(const IExperiment&);
+		
+		
+		// =================================================================
+		//	Private static attributes
+		// =================================================================
+		/**
+			\brief	The directories searched for the files of the
+					test-set store (see 'addTestSetStoreDir()').
+		*/
+		static std::vector<std::string> testSetStoreDirList;
+		
+		
 		// =================================================================
 		//	Private attributes
 		// =================================================================
@@ -330,9 +721,371 @@ class IExperiment : public Serializable
 		std::string name;
 		
 		
+		/**
+			\brief	The file of the test-set store from which 'mdpList'
+					is loaded (empty if 'mdpList' is embedded).
+		*/
+		std::string testSetFile;
+		
+		
+		/**
+			\brief	The hash of the content of 'testSetFile', which
+					identifies the test set (empty if 'mdpList' is
+					embedded).
+		*/
+		std::string testSetHash;
+		
+		
+		/**
+			\brief	True if 'mdpList' has to be freed by this IExperiment,
+					false if it is shared with another one.
+		*/
+		bool ownMDPs;
+		
+		
+		/**
+			\brief	The index of the shard of simulations performed by
+					this IExperiment (see 'setShard()').
+		*/
+		unsigned int shardIndex;
+		
+		
+		/**
+			\brief	The number of shards (see 'setShard()').
+		*/
+		unsigned int nbShards;
+		
+		
+		/**
+			\brief	The seed from which the seed of each simulation is
+					derived (0: disabled, see 'setTaskSeed()').
+		*/
+		unsigned int taskSeed;
+		
+		
+		/**
+			\brief	The seed of the order in which the test MDPs are
+					processed (0: disabled, see 'setRandomOrder()').
+		*/
+		unsigned int orderSeed;
+		
+		
+		/**
+			\brief	The SimulationThreads
+					(only for multi-thread).
+		*/
+		std::vector<SimulationThread*> simThreadList;
+		
+		
+		/**
+			\brief	The IExperiments whose simulations are performed by
+					the SimulationThreads.
+					(only for multi-thread)
+		*/
+		std::vector<IExperiment*> poolExpList;
+		
+		
+		/**
+			\brief	The agents from which 'copyAgentList' has been
+					cloned (empty if no SimulationThread is running).
+		*/
+		std::vector<const AgentType*> poolAgentList;
+		
+		
+		/**
+			\brief	The list of tasks to perform during the current call
+					of 'run()', where task '(k, t)' is the simulation
+					't % nbSimPerMDP' on MDP 't / nbSimPerMDP' of
+					IExperiment 'k'.
+		*/
+		std::vector<std::pair<unsigned int, unsigned int> > taskList;
+		
+		
+		/**
+			\brief	For each IExperiment of 'poolExpList', the time spent
+					in its simulations during the current call of 'run()'
+					(in ms, summed over the SimulationThreads).
+					(only for multi-thread)
+		*/
+		std::vector<double> roundTimeList;
+		
+		
+		/**
+			\brief	For each SimulationThread, the range of 'taskList'
+					it still has to perform.
+					(only for multi-thread)
+		*/
+		TaskRange* taskRangeList;
+		
+		
+		/**
+			\brief	A mutex on the state of the SimulationThreads
+					('poolRound', 'poolStop', 'nbThreadsDone' and
+					'roundTimeList').
+					(only for multi-thread)
+		*/
+		pthread_mutex_t m_pool;
+		
+		
+		/**
+			\brief	Signaled when a new call of 'run()' starts, and when
+					the SimulationThreads have to stop.
+					(only for multi-thread)
+		*/
+		pthread_cond_t c_roundStart;
+		
+		
+		/**
+			\brief	Signaled when all the SimulationThreads are done with
+					the current call of 'run()'.
+					(only for multi-thread)
+		*/
+		pthread_cond_t c_roundEnd;
+		
+		
+		/**
+			\brief	The number of calls of 'run()' handled by the
+					SimulationThreads so far.
+					(only for multi-thread)
+		*/
+		unsigned int poolRound;
+		
+		
+		/**
+			\brief	The number of SimulationThreads done with the
+					current call of 'run()'.
+					(only for multi-thread)
+		*/
+		unsigned int nbThreadsDone;
+		
+		
+		/**
+			\brief	True if the SimulationThreads have to stop.
+					(only for multi-thread)
+		*/
+		bool poolStop;
+		
+		
+		/**
+			\brief	The running metrics of this IExperiment
+					(see 'getMetrics()').
+		*/
+		Metrics metrics;
+		
+		
+		/**
+			\brief	Mutex protecting 'metrics', which are updated at the
+					end of each call of 'run()' (see 'mergeThreadMetrics()').
+		*/
+		mutable pthread_mutex_t m_metrics;
+		
+		
+		/**
+			\brief	The metrics of the simulations performed by each
+					SimulationThread (indexed by ID) during the current
+					call of 'run()', not merged into 'metrics' yet.
+					Each thread only updates its own entry, without
+					locking.
+		*/
+		std::vector<ThreadMetrics> threadMetricsList;
+		
+		
 		// =================================================================
 		//	Private methods
 		// =================================================================
+		/**
+			\brief			Load the test MDPs stored in 'file' (see
+							'storeTestSet()') into 'mdpList', and set
+							'testSetFile' and 'testSetHash'.
+							If 'file' cannot be opened, a file with the
+							same name is searched in the directories of
+							'testSetStoreDirList'.
+							The file is mapped in memory (read-only) and
+							its content is checked against its hash.
+			
+			\param[file		The file of the test-set store to load
+							(as referenced in the serialized
+							IExperiment).
+		*/
+		void loadTestSet(const std::string& file)
+									throw (SerializableException);
+		
+		
+		/**
+			\brief		Return the content of the test-set store file
+						of the test MDPs (see 'storeTestSet()').
+			
+			\return	The content of the test-set store file of the
+					test MDPs.
+		*/
+		std::string serializeTestSet() const;
+		
+		
+		/**
+			\brief		Return the hash of the test MDPs: 'testSetHash'
+						if they come from the test-set store, the hash of
+						'serializeTestSet()' if they are embedded (the
+						same hash in both cases).
+			
+			\return	The hash of the test MDPs.
+		*/
+		std::string computeTestSetHash() const;
+		
+		
+		/**
+			\brief		Throw an ExperimentException if 'exp' is not
+						defined on the same simulations as this
+						IExperiment.
+			
+			\param[exp	The IExperiment to check.
+		*/
+		void checkSameSimulations(const IExperiment& exp) const
+									throw (ExperimentException);
+		
+		
+		/**
+			\brief		Compute the discounted sum of rewards of
+						simulation 't' (see 'computeDSRList()').
+			
+			\param[t		A task of this IExperiment which has been
+						performed (see 'taskList').
+			\param[gamma	The discount factor.
+			
+			\return		The discounted sum of rewards of simulation 't'.
+		*/
+		double computeDSR(unsigned int t, double gamma) const;
+		
+		
+		/**
+			\brief	Return the number of tasks of this IExperiment (in
+					the current shard).
+			
+			\return	The number of tasks of this IExperiment (in the
+					current shard).
+		*/
+		unsigned int getNbTasks() const
+		{
+			unsigned int n = (mdpList.size() * nbSimPerMDP);
+			return ((n + nbShards - 1 - shardIndex) / nbShards);
+		}
+		
+		
+		/**
+			\brief	Return the list of tasks of this IExperiment (in
+					the current shard) which have not been performed yet
+					(see 'taskList'), in the order in which they are to
+					be performed (see 'setRandomOrder()').
+			
+			\return	The list of tasks of this IExperiment which have not
+					been performed yet.
+		*/
+		std::vector<unsigned int> getPendingTasks() const;
+		
+		
+		/**
+			\brief		Return true if task 't' has already been
+						performed, false else.
+			
+			\param[t		A task of this IExperiment (see 'taskList').
+			
+			\return		True if task 't' has already been performed,
+						false else.
+		*/
+		bool isDone(unsigned int t) const
+		{
+			return (saveTraj ? (simRecList[t] != 0) : !rList[t].empty());
+		}
+		
+		
+		/**
+			\brief	Return the number of MDPs, from the first one, whose
+					simulations have all been performed.
+					(this is the 'nextMDP' value of the serialized data)
+			
+			\return	The number of MDPs, from the first one, whose
+					simulations have all been performed.
+		*/
+		unsigned int getNbCompletedMDPs() const;
+		
+		
+		/**
+			\brief		Perform task 't' and save its results.
+			
+			\param[agent	The agent to use.
+			\param[t		The task of this IExperiment to perform
+						(see 'taskList').
+			\param[mdp	The MDP on which to perform the simulation
+						(0: MDP 't / nbSimPerMDP' of 'mdpList', else
+						a copy of it).
+			\param[ID	The ID of the SimulationThread performing the
+						task (0 if none).
+		*/
+		void performTask(AgentType* agent, unsigned int t, MDPType* mdp = 0,
+		                 unsigned int ID = 0);
+		
+		
+		/**
+			\brief	Merge the metrics of 'threadMetricsList' into
+					'metrics', and clear them.
+					Must not be called while SimulationThreads are
+					performing simulations.
+		*/
+		void mergeThreadMetrics();
+		
+		
+		/**
+			\brief			Start 'nbThreads' SimulationThreads, each one
+							using its own copy of the agents.
+			
+			\param[expList	The IExperiments whose simulations are to
+							be performed.
+			\param[agentList	The agents to copy (one per IExperiment of
+							'expList').
+			\param[nbThreads	The number of SimulationThreads to start.
+		*/
+		void startPool(	const std::vector<IExperiment*>& expList,
+						const std::vector<const AgentType*>& agentList,
+						unsigned int nbThreads);
+		
+		
+		/**
+			\brief	Stop the SimulationThreads (if any) and delete the
+					copies of the agents.
+		*/
+		void stopPool();
+		
+		
+		/**
+			\brief		Retrieve the next task to be performed by
+						SimulationThread 'ID', either from its own range
+						(front) or by stealing half of the range of
+						another SimulationThread (back).
+						Lock-free.
+			
+			\param[ID	The ID of the SimulationThread.
+			\param[task	The task retrieved.
+			
+			\return		True if a task has been retrieved, false if
+						there is no task left.
+		*/
+		bool popTask(unsigned int ID,
+					std::pair<unsigned int, unsigned int>& task);
+		
+		
+		/**
+			\brief		Perform the tasks of SimulationThread 'ID' until
+						there is no task left or the time limit is
+						reached.
+						Since several simulations of the same MDP can
+						be performed concurrently (and an MDP stores
+						its current state), each SimulationThread uses
+						its own copy of the MDP of its current task.
+			
+			\param[ID	The ID of the SimulationThread.
+		*/
+		void runTasks(unsigned int ID);
+		
+		
 		#ifndef NDEBUG
 		/**
 			\brief	Function to call whenever the internal data could
@@ -347,6 +1100,38 @@ class IExperiment : public Serializable
 		//	Private Classes
 		// =================================================================
 		/**
+			\brief	A range of 'taskList' ['begin'; 'end'[, packed in a
+					single word ('begin' in the 32 high bits), in order
+					to be updated atomically.
+					Padded to avoid false sharing between threads.
+		*/
+		struct TaskRange
+		{
+			volatile unsigned long long range;
+			char padding[64 - sizeof(unsigned long long)];
+		};
+		
+		
+		/**
+			\brief	The metrics of the simulations performed by a
+					SimulationThread (see 'threadMetricsList').
+					Padded to avoid false sharing between threads.
+		*/
+		struct ThreadMetrics
+		{
+			utils::RunningStatistics dsr, regret, taskTime;
+			unsigned int nbTasks;
+			double threadTime;
+			char padding[64];
+			
+			ThreadMetrics() : nbTasks(0), threadTime(0.0) {}
+		};
+		
+		
+		/**
+			\brief	A thread performing the simulations of the
+					IExperiment, and waiting for the next call of 'run()'
+					in the meantime.
 		*/
 		class SimulationThread : public utils::Thread
 		{			
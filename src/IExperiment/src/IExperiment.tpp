@@ -4,6 +4,14 @@
 using namespace std;
 
 
+// ===========================================================================
+//	Private static attributes
+// ===========================================================================
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+vector<string> IExperiment<AgentType, MDPType, SimulationRecordType>::
+		testSetStoreDirList;
+
+
 // ===========================================================================
 //	Public Constructors/Destructor
 // ===========================================================================
@@ -15,8 +23,10 @@ IExperiment<AgentType, MDPType, SimulationRecordType>::
 					bool saveTraj_) :
 						Serializable(),
 						mdpList(mdpList_), nbSimPerMDP(nbSimPerMDP_),
-						timeElapsed(0.0), saveTraj(saveTraj_), nextMDP(0),
-						name(name_)
+						timeElapsed(0.0), saveTraj(saveTraj_), nbDone(0),
+						name(name_), ownMDPs(true),
+						shardIndex(0), nbShards(1), taskSeed(0),
+						orderSeed(0)
 {
 	assert(!mdpList.empty());
 	for (unsigned int i = 0; i < mdpList.size(); ++i) { assert(mdpList[i]); }
@@ -29,6 +39,35 @@ IExperiment<AgentType, MDPType, SimulationRecordType>::
 	
 	
 	//	Clear
+	pthread_mutex_init(&m_metrics, NULL);
+	clear();
+	
+	
+	//	Check integrity
+	#ifndef NDEBUG
+	checkIntegrity();
+	#endif
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+IExperiment<AgentType, MDPType, SimulationRecordType>::
+		IExperiment(const IExperiment& exp, ShareMDPs) :
+						Serializable(),
+						mdpList(exp.mdpList), nbSimPerMDP(exp.nbSimPerMDP),
+						timeElapsed(0.0), saveTraj(exp.saveTraj), nbDone(0),
+						name(exp.name), testSetFile(exp.testSetFile),
+						testSetHash(exp.testSetHash), ownMDPs(false),
+						shardIndex(0), nbShards(1), taskSeed(0),
+						orderSeed(0)
+{
+	//	'simRecList' & 'rList'
+	if (saveTraj) { simRecList.resize(mdpList.size()*nbSimPerMDP); }
+     else          { rList.resize(mdpList.size()*nbSimPerMDP);      }
+	
+	
+	//	Clear
+	pthread_mutex_init(&m_metrics, NULL);
 	clear();
 	
 	
@@ -42,8 +81,14 @@ IExperiment<AgentType, MDPType, SimulationRecordType>::
 template<typename AgentType, typename MDPType, typename SimulationRecordType>
 IExperiment<AgentType, MDPType, SimulationRecordType>::~IExperiment()
 {
-	for (unsigned int i = 0; i < mdpList.size(); ++i)
-		if (mdpList[i]) { delete mdpList[i]; }
+	stopPool();
+	pthread_mutex_destroy(&m_metrics);
+	
+	if (ownMDPs)
+	{
+		for (unsigned int i = 0; i < mdpList.size(); ++i)
+			if (mdpList[i]) { delete mdpList[i]; }
+	}
 
 	for (unsigned int i = 0; i < simRecList.size(); ++i)
 		if (simRecList[i]) { delete simRecList[i]; }
@@ -51,108 +96,187 @@ IExperiment<AgentType, MDPType, SimulationRecordType>::~IExperiment()
 
 
 // ===========================================================================
-//	Public methods
+//	Public static methods
 // ===========================================================================
 template<typename AgentType, typename MDPType, typename SimulationRecordType>
 void IExperiment<AgentType, MDPType, SimulationRecordType>::
-		run(AgentType* agent, double timeLimit_, unsigned int nbThreads)
+		runAll(	vector<IExperiment*>& expList,
+				vector<AgentType*>& agentList,
+				double timeLimit_, unsigned int nbThreads)
 {
-	//	Adjust the number of Threads with respect to the number of MDPs
+	assert(!expList.empty());
+	assert(expList.size() == agentList.size());
+	assert(nbThreads > 0);
+	
+	
+	//	The first IExperiment hosts the SimulationThreads
+	IExperiment* host = expList[0];
+	
+	
+	//	Adjust the number of Threads with respect to the number of tasks
 	//	and set the time limit.
-	nbThreads = (nbThreads > mdpList.size()) ? mdpList.size() : nbThreads;
-	timeLimit = timeLimit_;
+	unsigned int nbTasks = 0;
+	for (unsigned int k = 0; k < expList.size(); ++k)
+		nbTasks += (expList[k]->mdpList.size() * expList[k]->nbSimPerMDP);
+	
+	nbThreads = (nbThreads > nbTasks) ? nbTasks : nbThreads;
+	host->timeLimit = timeLimit_;
+	
+	
+	//	Interleave the pending tasks of the IExperiments, so that they
+	//	all progress at the same pace
+	vector<vector<unsigned int> > pendingTasksList;
+	unsigned int maxSize = 0;
+	for (unsigned int k = 0; k < expList.size(); ++k)
+	{
+		pendingTasksList.push_back(expList[k]->getPendingTasks());
+		if (pendingTasksList[k].size() > maxSize)
+			maxSize = pendingTasksList[k].size();
+		
+		expList[k]->threadMetricsList.resize(nbThreads);
+	}
+	
+	host->taskList.clear();
+	for (unsigned int i = 0; i < maxSize; ++i)
+	{
+		for (unsigned int k = 0; k < expList.size(); ++k)
+		{
+			if (i < pendingTasksList[k].size())
+			{
+				host->taskList.push_back(
+						make_pair(k, pendingTasksList[k][i]));
+			}
+		}
+	}
 
 	
 	//	1 Thread case
 	if (nbThreads == 1)
 	{
-	     //	Perform the simulations
-	     chrono.restart();
-	     while (nextMDP < mdpList.size())
-	     {
-			for (unsigned int i = 0; i < nbSimPerMDP; ++i)
-			{
-                    //   Simulate
-                    SimulationRecordType* simRec
-                              = new SimulationRecordType(
-								simulate(agent, mdpList[nextMDP]));
-
-                    //   Save the results
-                    if (saveTraj)
-                         simRecList[nbSimPerMDP*nextMDP + i] = simRec;
-                    
-                    else
-                    {
-                         rList[nbSimPerMDP*nextMDP + i]
-                                   = simRec->getRewardList();
-
-                         delete simRec;
-                    }
-				
-				//	Check integrity
-				#ifndef NDEBUG
-				checkIntegrity();
-				#endif
-			}
+		//	Perform the simulations
+		utils::Chrono taskChrono;
+		
+		host->chrono.restart();
+		for (unsigned int i = 0; i < host->taskList.size(); ++i)
+		{
+			unsigned int k = host->taskList[i].first;
+			
+			taskChrono.restart();
+			expList[k]->performTask(agentList[k], host->taskList[i].second);
+			expList[k]->timeElapsed += taskChrono.get();
 			
 			
-			//	Next MDP to simulate
-			++nextMDP;
+			//	Check integrity
+			#ifndef NDEBUG
+			expList[k]->checkIntegrity();
+			#endif
 			
 			
 			//	Time limit check
-			if ((timeLimit > 0) && (chrono.get() >= timeLimit)) { break; }
-	     }
-	     
-	     //	Stop the chrono and compute the time elapsed
-	     timeElapsed += chrono.get();
+			if ((host->timeLimit > 0)
+					&& (host->chrono.get() >= host->timeLimit)) { break; }
+		}
 	}
 	
 	
 	//	Multi-Thread case
 	else
-	{		
-		//	Create the SimulationThreads and a unique copy of 'agent'
-		//	for each one.
-		vector<SimulationThread*> simThreadList;
+	{
+		//	(Re)start the SimulationThreads if the experiments, the agents
+		//	or the number of threads have changed since the last call.
+		vector<const AgentType*> cAgentList(agentList.begin(),
+		                                    agentList.end());
+		
+		if ((expList != host->poolExpList)
+				|| (cAgentList != host->poolAgentList)
+				|| (host->simThreadList.size() != nbThreads))
+		{
+			host->stopPool();
+			host->startPool(expList, cAgentList, nbThreads);
+		}
+		
+		
+		//	Split the tasks in one range per SimulationThread
+		unsigned long long size = host->taskList.size();
 		for (unsigned int i = 0; i < nbThreads; ++i)
 		{
-			simThreadList.push_back(new SimulationThread(i, this));
-			copyAgentList.push_back(agent->clone());
+			unsigned long long b = ((size * i) / nbThreads);
+			unsigned long long e = ((size * (i + 1)) / nbThreads);
+			
+			host->taskRangeList[i].range = ((b << 32) | e);
 		}
 
 
-		//	Start the SimulationThreads
-		chrono.restart();
+		//	Start a new round and wait for all the SimulationThreads to
+		//	finish it
+		host->chrono.restart();
 		
-		for (unsigned int i = 0; i < nbThreads; ++i)
-			simThreadList[i]->start();
+		pthread_mutex_lock(&(host->m_pool));
+		host->nbThreadsDone = 0;
+		host->roundTimeList.assign(expList.size(), 0.0);
+		++(host->poolRound);
+		pthread_cond_broadcast(&(host->c_roundStart));
 		
-
-		//	Join all the SimulationThreads
-		for (unsigned int i = 0; i < nbThreads; ++i)
-			simThreadList[i]->join();
+		while (host->nbThreadsDone < nbThreads)
+			pthread_cond_wait(&(host->c_roundEnd), &(host->m_pool));
+		pthread_mutex_unlock(&(host->m_pool));
 		
 		
-		//	Stop the chrono and compute the time elapsed
-		timeElapsed += chrono.get();
+		//	Stop the chrono and share the time elapsed between the
+		//	IExperiments
+		double roundTime = host->chrono.get();
 		
+		double totalTime = 0.0;
+		for (unsigned int k = 0; k < expList.size(); ++k)
+			totalTime += host->roundTimeList[k];
 		
-		//	Delete the SimulationThreads and the copies of 'agent'
-		for (unsigned int i = 0; i < nbThreads; ++i)
+		for (unsigned int k = 0; k < expList.size(); ++k)
 		{
-			delete simThreadList[i];
-			delete copyAgentList[i];
+			if (totalTime > 0.0)
+			{
+				expList[k]->timeElapsed +=
+						(roundTime * host->roundTimeList[k] / totalTime);
+			}
+			else { expList[k]->timeElapsed += (roundTime / expList.size()); }
+			
+			
+			//	Check integrity
+			#ifndef NDEBUG
+			expList[k]->checkIntegrity();
+			#endif
 		}
-		simThreadList.clear();
-		copyAgentList.clear();
-		
-		
-		//	Check integrity
-		#ifndef NDEBUG
-		checkIntegrity();
-		#endif
 	}
+	
+	
+	//	Merge the metrics of the simulations performed by each thread
+	for (unsigned int k = 0; k < expList.size(); ++k)
+		expList[k]->mergeThreadMetrics();
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		addTestSetStoreDir(const string& dir)
+{
+	if (find(testSetStoreDirList.begin(), testSetStoreDirList.end(), dir)
+			== testSetStoreDirList.end())
+	{
+		testSetStoreDirList.push_back(dir);
+	}
+}
+
+
+// ===========================================================================
+//	Public methods
+// ===========================================================================
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		run(AgentType* agent, double timeLimit_, unsigned int nbThreads)
+{
+	vector<IExperiment*> expList(1, this);
+	vector<AgentType*> agentList(1, agent);
+	
+	runAll(expList, agentList, timeLimit_, nbThreads);
 }
 
 
@@ -166,8 +290,171 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::clear()
 
      for (unsigned int i = 0; i < rList.size(); ++i) { rList[i].clear(); }
 
-	nextMDP = 0;
-	pthread_mutex_init(&m_nextMDP, NULL);
+	nbDone = 0;
+	
+	pthread_mutex_lock(&m_metrics);
+	metrics = Metrics();
+	pthread_mutex_unlock(&m_metrics);
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		setShard(unsigned int shardIndex_, unsigned int nbShards_)
+{
+	assert(nbShards_ > 0);
+	assert(shardIndex_ < nbShards_);
+	
+	stopPool();
+	
+	shardIndex = shardIndex_;
+	nbShards   = nbShards_;
+	
+	nbDone = (getNbTasks() - getPendingTasks().size());
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		merge(const IExperiment& exp) throw (ExperimentException)
+{
+	//	Check the simulations are the same, and seeded the same way
+	checkSameSimulations(exp);
+	
+	if ((exp.taskSeed != taskSeed) || (exp.nbShards != nbShards))
+	{
+		string msg;
+		msg += "Cannot merge the results of '" + exp.getName() + "': ";
+		msg += "the simulations have not been seeded the same way!\n";
+		
+		throw ExperimentException(msg);
+	}
+	
+	
+	//	Check no simulation has been performed in both IExperiments
+	unsigned int nbTasks = (mdpList.size() * nbSimPerMDP);
+	for (unsigned int t = 0; t < nbTasks; ++t)
+	{
+		if (exp.isDone(t) && isDone(t))
+		{
+			stringstream sstr;
+			sstr << "Cannot merge the results of '" << exp.getName() << "': ";
+			sstr << "simulation " << t << " has already been performed!\n";
+			
+			throw ExperimentException(sstr.str());
+		}
+	}
+	
+	
+	//	Add the results
+	for (unsigned int t = 0; t < nbTasks; ++t)
+	{
+		if (!exp.isDone(t)) { continue; }
+		
+		if (saveTraj)
+			simRecList[t] = new SimulationRecordType(*(exp.simRecList[t]));
+		
+		else { rList[t] = exp.rList[t]; }
+	}
+	
+	timeElapsed += exp.timeElapsed;
+	nbDone = (getNbTasks() - getPendingTasks().size());
+	
+	
+	//	Update the metrics
+	computeMetrics();
+	
+	Metrics expMetrics = exp.getMetrics();
+	pthread_mutex_lock(&m_metrics);
+	metrics.taskTime.merge(expMetrics.taskTime);
+	pthread_mutex_unlock(&m_metrics);
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		storeTestSet(string storeDir) throw (SerializableException)
+{
+	//	Serialize the test MDPs
+	string content = serializeTestSet();
+	
+	
+	//	The file is named after the hash of its content
+	//	(referenced by its path as given, so that the experiment files stay
+	//	valid when the work directory is moved or mounted elsewhere)
+	if (storeDir.empty()) { storeDir = "."; }
+	while ((storeDir.size() > 1) && (storeDir[storeDir.size() - 1] == '/'))
+		storeDir.erase(storeDir.size() - 1);
+	
+		//	Create the store and its parent directories
+	size_t pos = 0;
+	do
+	{
+		pos = storeDir.find('/', pos + 1);
+		string dir = storeDir.substr(0, pos);
+		if ((mkdir(dir.c_str(), 0755) != 0) && (errno != EEXIST))
+		{
+			string msg;
+			msg += "Unable to create the test-set store '" + dir + "' (";
+			msg += strerror(errno);
+			msg += ")!\n";
+			
+			throw SerializableException(msg);
+		}
+	} while (pos != string::npos);
+	
+	struct stat buffer;
+	if ((stat(storeDir.c_str(), &buffer) != 0) || !S_ISDIR(buffer.st_mode))
+	{
+		string msg;
+		msg += "The test-set store '" + storeDir + "' is not a directory!\n";
+		
+		throw SerializableException(msg);
+	}
+	
+	
+	string hash = utils::hashing::computeHash(content);
+	string file = storeDir + "/" + hash + ".dat";
+	
+	
+	//	Write the file if this test set has not been stored yet
+	//	(written under a temporary name, then renamed, so that concurrent
+	//	processes never read a partial file)
+	if (stat(file.c_str(), &buffer) != 0)
+	{
+		stringstream tmpFile;
+		tmpFile << file << "." << getpid() << ".tmp";
+		
+		ofstream os(tmpFile.str().c_str(), ios::binary);
+		os << content;
+		os.close();
+		
+		if (os.fail() || (rename(tmpFile.str().c_str(), file.c_str()) != 0))
+		{
+			remove(tmpFile.str().c_str());
+			
+			string msg;
+			msg += "Unable to write the test set '" + file + "'!\n";
+			
+			throw SerializableException(msg);
+		}
+	}
+	
+	testSetFile = file;
+	testSetHash = hash;
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+typename IExperiment<AgentType, MDPType, SimulationRecordType>::Metrics
+		IExperiment<AgentType, MDPType, SimulationRecordType>::
+				getMetrics() const
+{
+	pthread_mutex_lock(&m_metrics);
+	Metrics snapshot = metrics;
+	pthread_mutex_unlock(&m_metrics);
+	
+	return snapshot;
 }
 
 
@@ -180,32 +467,61 @@ vector<double> IExperiment<AgentType, MDPType, SimulationRecordType>::
 	
 	vector<double> dsrList;
 	
-	if (saveTraj)
+	unsigned int nbTasks = (mdpList.size() * nbSimPerMDP);
+	for (unsigned int t = 0; t < nbTasks; ++t)
+		if (isDone(t)) { dsrList.push_back(computeDSR(t, gamma)); }
+	
+	return dsrList;
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+vector<double> IExperiment<AgentType, MDPType, SimulationRecordType>::
+		computeRegretList(const vector<double>& optimalValueList) const
+{
+	assert(optimalValueList.size() == mdpList.size());
+	
+	
+	vector<double> regretList;
+	
+	unsigned int nbTasks = (mdpList.size() * nbSimPerMDP);
+	for (unsigned int t = 0; t < nbTasks; ++t)
 	{
-     	for (unsigned int i = 0; i < simRecList.size(); ++i)
-     	{
-     		if (simRecList[i])
-     			dsrList.push_back(simRecList[i]->computeDSR(gamma));
-     	}
+		if (isDone(t))
+		{
+			regretList.push_back(optimalValueList[t / nbSimPerMDP]
+					- computeDSR(t, -1.0));
+		}
 	}
 	
-	else
+	return regretList;
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		computePairedDSRLists(	const IExperiment& exp,
+							vector<double>& dsrList,
+							vector<double>& expDSRList,
+							double gamma) const throw (ExperimentException)
+{
+	assert((gamma == -1.0) || ((gamma > 0.0) && (gamma <= 1.0)));
+	
+	checkSameSimulations(exp);
+	
+	
+	dsrList.clear();
+	expDSRList.clear();
+	
+	unsigned int nbTasks = (mdpList.size() * nbSimPerMDP);
+	for (unsigned int t = 0; t < nbTasks; ++t)
 	{
-          for (unsigned int i = 0; i < rList.size(); ++i)
-          {
-               if (!rList[i].empty())
-               {
-                    double tGamma =
-                              ((gamma > 0.0) && (gamma <= 1.0)) ?
-                                        gamma : getSimGamma();
-
-                    dsrList.push_back(
-                         rl_utils::simulation::computeDSR(rList[i], tGamma));
-               }
-          }
+		if (isDone(t) && exp.isDone(t))
+		{
+			dsrList.push_back(computeDSR(t, gamma));
+			expDSRList.push_back(exp.computeDSR(t, gamma));
+		}
 	}
-	
-	return dsrList;
 }
 
 
@@ -217,24 +533,28 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 	
 	
 	os << IExperiment::toString() << "\n";
-	os << (8 + mdpList.size() + simRecList.size()) << "\n";
+	os << (10 + mdpList.size() + simRecList.size()) << "\n";
 	
 	
 	//	'name'
 	os << name << "\n";
 	
 	
-	//	'mdpList'
-	os << mdpList.size() << "\n";
-	for (unsigned int i = 0; i < mdpList.size(); ++i)
+	//	'mdpList' (or a reference to the test-set store)
+	if (!testSetFile.empty()) { os << "@" << testSetFile << "\n"; }
+	else
 	{
-		stringstream mdpStream;		
-		mdpList[i]->serialize(mdpStream);
-		
-		os << mdpStream.str().length() << "\n";
-		copy(istreambuf_iterator<char>(mdpStream),
-			istreambuf_iterator<char>(),
-			ostreambuf_iterator<char>(os));
+		os << mdpList.size() << "\n";
+		for (unsigned int i = 0; i < mdpList.size(); ++i)
+		{
+			stringstream mdpStream;		
+			serializeMDP(mdpStream, i);
+			
+			os << mdpStream.str().length() << "\n";
+			copy(istreambuf_iterator<char>(mdpStream),
+				istreambuf_iterator<char>(),
+				ostreambuf_iterator<char>(os));
+		}
 	}
 	
 	
@@ -273,7 +593,12 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 	
 	
 	//	'nextMDP'
-	os << nextMDP << "\n";
+	os << getNbCompletedMDPs() << "\n";
+	
+	
+	//	'shardIndex', 'nbShards' and 'taskSeed'
+	os << shardIndex << "/" << nbShards << "\n";
+	os << taskSeed << "\n";
 }
 
 
@@ -315,23 +640,36 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 	
 	//	'mdpList'
 	if (!getline(is, tmp)) { throwEOFMsg("mdpList"); }
-	unsigned int mdpListSize = atoi(tmp.c_str());
 	++i;
 	
-	for (unsigned int j = 0; j < mdpListSize; ++j)
+		//	Reference to the test-set store
+	if (!tmp.empty() && (tmp[0] == '@'))
 	{
-		if (!getline(is, tmp)) { throwEOFMsg("mdpList"); }
-		unsigned int mdpStreamLength = atoi(tmp.c_str());
-		
-		stringstream mdpStream;
-		string tmp;
-		tmp.resize(mdpStreamLength);
-		is.read(&tmp[0], mdpStreamLength);
-		mdpStream << tmp;
+		loadTestSet(tmp.substr(1));
+		i += mdpList.size();
+	}
+	
+		//	Embedded test MDPs
+	else
+	{
+		testSetFile = "";
+		testSetHash = "";
 		
-		mdpList.push_back(dynamic_cast<MDPType*>(
-				Serializable::createInstance<MDPType>(mdpStream)));
-		++i;
+		unsigned int mdpListSize = atoi(tmp.c_str());
+		for (unsigned int j = 0; j < mdpListSize; ++j)
+		{
+			if (!getline(is, tmp)) { throwEOFMsg("mdpList"); }
+			unsigned int mdpStreamLength = atoi(tmp.c_str());
+			
+			stringstream mdpStream;
+			string tmp;
+			tmp.resize(mdpStreamLength);
+			is.read(&tmp[0], mdpStreamLength);
+			mdpStream << tmp;
+			
+			mdpList.push_back(deserializeMDP(mdpStream, j));
+			++i;
+		}
 	}
 	
 	
@@ -410,9 +748,39 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 	
 	
 	//	'nextMDP'
+	//	(the simulations performed are retrieved from the results
+	//	themselves, since they are not performed in order)
 	if (!getline(is, tmp)) { throwEOFMsg("nextMDP"); }
-	nextMDP = atoi(tmp.c_str());
 	++i;
+	
+	
+	//	'shardIndex' and 'nbShards' (absent from the files saved before
+	//	their addition)
+	shardIndex = 0;
+	nbShards   = 1;
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("nbShards"); }
+		if ((sscanf(tmp.c_str(), "%u/%u", &shardIndex, &nbShards) != 2)
+				|| (nbShards == 0) || (shardIndex >= nbShards))
+		{
+			string msg = "Error with 'nbShards'.\n";
+			throw SerializableException(msg);
+		}
+		++i;
+	}
+	
+	
+	//	'taskSeed' (absent from the files saved before its addition)
+	taskSeed = 0;
+	if (n > i)
+	{
+		if (!getline(is, tmp)) { throwEOFMsg("taskSeed"); }
+		taskSeed = strtoul(tmp.c_str(), 0, 10);
+		++i;
+	}
+	
+	nbDone = (getNbTasks() - getPendingTasks().size());
 
 
 	//	Number of parameters check
@@ -423,6 +791,10 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 	}
 	
 	
+	//	'metrics'
+	computeMetrics();
+	
+	
 	//	Check integrity
 	#ifndef NDEBUG
 	checkIntegrity();
@@ -430,9 +802,492 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 }
 
 
+// ===========================================================================
+//	Protected methods
+// ===========================================================================
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::computeMetrics()
+{
+	utils::RunningStatistics dsr, regret;
+	
+	unsigned int nbTasks = (mdpList.size() * nbSimPerMDP);
+	for (unsigned int t = 0; t < nbTasks; ++t)
+	{
+		if (!isDone(t)) { continue; }
+		
+		double dsrT = computeDSR(t, -1.0);
+		dsr.add(dsrT);
+		
+		double optimalValue;
+		if (getOptimalValue(t / nbSimPerMDP, optimalValue))
+			regret.add(optimalValue - dsrT);
+	}
+	
+	pthread_mutex_lock(&m_metrics);
+	metrics.dsr = dsr;
+	metrics.regret = regret;
+	pthread_mutex_unlock(&m_metrics);
+}
+
+
 // ===========================================================================
 //	Private methods
 // ===========================================================================
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		loadTestSet(const string& file) throw (SerializableException)
+{
+	//	Resolve the file: the path as referenced, then its name in the
+	//	directories of the test-set store
+	string fileName = file.substr(file.find_last_of("/") + 1);
+	string path = file;
+	
+	struct stat buffer;
+	for (unsigned int i = 0; (stat(path.c_str(), &buffer) != 0); ++i)
+	{
+		if (i == testSetStoreDirList.size())
+		{
+			string msg;
+			msg += "Unable to find the test set '" + file + "'";
+			msg += " (see '--test_set_store')!\n";
+			
+			throw SerializableException(msg);
+		}
+		
+		path = testSetStoreDirList[i] + "/" + fileName;
+	}
+	
+	try
+	{
+		utils::MappedFile mFile(path);
+		
+		
+		//	Check the content against the hash (= the file name)
+		string hash = fileName.substr(0, fileName.find("."));
+		
+		if (utils::hashing::computeHash(mFile.getData(), mFile.getSize())
+				!= hash)
+		{
+			string msg;
+			msg += "The test set '" + path + "' is corrupted!\n";
+			
+			throw SerializableException(msg);
+		}
+		
+		testSetFile = file;
+		testSetHash = hash;
+		
+		
+		//	Parse the test MDPs (read from the mapped pages)
+		istream is(&mFile);
+		string tmp;
+		
+		if (!getline(is, tmp)) { throwEOFMsg("class name"); }
+		if (tmp != "TestSet")
+		{
+			string msg = "Error with 'class name'.\n";
+			throw SerializableException(msg);
+		}
+		
+		if (!getline(is, tmp)) { throwEOFMsg("mdpList"); }
+		unsigned int mdpListSize = atoi(tmp.c_str());
+		
+		for (unsigned int j = 0; j < mdpListSize; ++j)
+		{
+			if (!getline(is, tmp)) { throwEOFMsg("mdpList"); }
+			unsigned int mdpStreamLength = atoi(tmp.c_str());
+			
+			stringstream mdpStream;
+			string tmp;
+			tmp.resize(mdpStreamLength);
+			is.read(&tmp[0], mdpStreamLength);
+			mdpStream << tmp;
+			
+			mdpList.push_back(deserializeMDP(mdpStream, j));
+		}
+	}
+	
+	catch (const runtime_error& e) { throw SerializableException(e.what()); }
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+string IExperiment<AgentType, MDPType, SimulationRecordType>::
+		serializeTestSet() const
+{
+	stringstream sstr;
+	sstr << "TestSet\n";
+	sstr << mdpList.size() << "\n";
+	for (unsigned int i = 0; i < mdpList.size(); ++i)
+	{
+		stringstream mdpStream;
+		serializeMDP(mdpStream, i);
+		
+		sstr << mdpStream.str().length() << "\n";
+		sstr << mdpStream.str();
+	}
+	
+	return sstr.str();
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+string IExperiment<AgentType, MDPType, SimulationRecordType>::
+		computeTestSetHash() const
+{
+	if (!testSetHash.empty()) { return testSetHash; }
+	
+	//	Embedded test MDPs: hash them as they would be stored
+	return utils::hashing::computeHash(serializeTestSet());
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		checkSameSimulations(const IExperiment& exp) const
+									throw (ExperimentException)
+{
+	if ((exp.mdpList.size() != mdpList.size())
+			|| (exp.nbSimPerMDP != nbSimPerMDP)
+			|| (exp.saveTraj != saveTraj)
+			|| (exp.computeTestSetHash() != computeTestSetHash())
+			|| (exp.getSimGamma() != getSimGamma()))
+	{
+		string msg;
+		msg += "'" + exp.getName() + "' and '" + getName() + "': ";
+		msg += "the simulations are not the same!\n";
+		
+		throw ExperimentException(msg);
+	}
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+double IExperiment<AgentType, MDPType, SimulationRecordType>::
+		computeDSR(unsigned int t, double gamma) const
+{
+	assert(isDone(t));
+	
+	if (saveTraj) { return simRecList[t]->computeDSR(gamma); }
+	
+	double tGamma = ((gamma > 0.0) && (gamma <= 1.0)) ? gamma : getSimGamma();
+	return rl_utils::simulation::computeDSR(rList[t], tGamma);
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+vector<unsigned int> IExperiment<AgentType, MDPType, SimulationRecordType>::
+		getPendingTasks() const
+{
+	//	The order of the test MDPs (a permutation drawn from 'orderSeed'
+	//	through Fisher-Yates)
+	vector<unsigned int> mdpOrder(mdpList.size());
+	for (unsigned int m = 0; m < mdpOrder.size(); ++m) { mdpOrder[m] = m; }
+	
+	if ((orderSeed > 0) && !mdpOrder.empty())
+	{
+		for (unsigned int m = (mdpOrder.size() - 1); m > 0; --m)
+		{
+			unsigned int j = utils::hashing::computeSeed(orderSeed, m);
+			swap(mdpOrder[m], mdpOrder[j % (m + 1)]);
+		}
+	}
+	
+	
+	//	The tasks of the current shard which have not been performed yet
+	vector<unsigned int> pendingTasks;
+	for (unsigned int i = 0; i < mdpOrder.size(); ++i)
+	{
+		for (unsigned int s = 0; s < nbSimPerMDP; ++s)
+		{
+			unsigned int t = ((mdpOrder[i] * nbSimPerMDP) + s);
+			if (((t % nbShards) == shardIndex) && !isDone(t))
+				pendingTasks.push_back(t);
+		}
+	}
+	
+	return pendingTasks;
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+unsigned int IExperiment<AgentType, MDPType, SimulationRecordType>::
+		getNbCompletedMDPs() const
+{
+	unsigned int nbTasks = (mdpList.size() * nbSimPerMDP);
+	
+	unsigned int t = 0;
+	while ((t < nbTasks) && isDone(t)) { ++t; }
+	
+	return (t / nbSimPerMDP);
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		performTask(	AgentType* agent, unsigned int t, MDPType* mdp,
+					unsigned int ID)
+{
+	utils::Chrono taskChrono;
+	
+	
+	//   Simulate
+	if (!mdp) { mdp = mdpList[t / nbSimPerMDP]; }
+	if (taskSeed > 0) { initRNG(utils::hashing::computeSeed(taskSeed, t)); }
+	
+	SimulationRecordType* simRec
+			= new SimulationRecordType(simulate(agent, mdp));
+	
+	//	(the task may run on the calling thread, which must not keep
+	//	 drawing from the stream of task 't' afterwards)
+	if (taskSeed > 0) { utils::RandomGen::clearThreadSeed(); }
+	
+	
+	//   Save the results
+	if (saveTraj) { simRecList[t] = simRec; }
+	
+	else
+	{
+		rList[t] = simRec->getRewardList();
+		delete simRec;
+	}
+	
+	saveTaskData(t, agent);
+	
+	
+	//	Update the metrics
+	double taskTime = taskChrono.get();
+	double dsr = computeDSR(t, -1.0);
+	
+	double optimalValue;
+	bool hasRegret = getOptimalValue(t / nbSimPerMDP, optimalValue);
+	
+	//	(in the entry of the calling thread, merged at the end of 'run()')
+	assert(ID < threadMetricsList.size());
+	ThreadMetrics& threadMetrics = threadMetricsList[ID];
+	
+	threadMetrics.dsr.add(dsr);
+	if (hasRegret) { threadMetrics.regret.add(optimalValue - dsr); }
+	threadMetrics.taskTime.add(taskTime);
+	++threadMetrics.nbTasks;
+	threadMetrics.threadTime += taskTime;
+	
+	__sync_fetch_and_add(&nbDone, 1);
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		mergeThreadMetrics()
+{
+	pthread_mutex_lock(&m_metrics);
+	for (unsigned int i = 0; i < threadMetricsList.size(); ++i)
+	{
+		ThreadMetrics& threadMetrics = threadMetricsList[i];
+		if (threadMetrics.nbTasks == 0) { continue; }
+		
+		metrics.dsr.merge(threadMetrics.dsr);
+		metrics.regret.merge(threadMetrics.regret);
+		metrics.taskTime.merge(threadMetrics.taskTime);
+		
+		if (metrics.nbTasksList.size() <= i)
+		{
+			metrics.nbTasksList.resize(i + 1, 0);
+			metrics.threadTimeList.resize(i + 1, 0.0);
+		}
+		metrics.nbTasksList[i] += threadMetrics.nbTasks;
+		metrics.threadTimeList[i] += threadMetrics.threadTime;
+		
+		threadMetrics = ThreadMetrics();
+	}
+	pthread_mutex_unlock(&m_metrics);
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		startPool(	const vector<IExperiment*>& expList,
+					const vector<const AgentType*>& agentList,
+					unsigned int nbThreads)
+{
+	assert(simThreadList.empty());
+	
+	
+	//	Synchronization data
+	pthread_mutex_init(&m_pool, NULL);
+	pthread_cond_init(&c_roundStart, NULL);
+	pthread_cond_init(&c_roundEnd, NULL);
+	
+	poolRound     = 0;
+	nbThreadsDone = 0;
+	poolStop      = false;
+	
+	taskRangeList = new TaskRange[nbThreads];
+	for (unsigned int i = 0; i < nbThreads; ++i) { taskRangeList[i].range = 0; }
+	
+	
+	//	Create the SimulationThreads and a unique copy of each agent
+	//	for each one.
+	for (unsigned int i = 0; i < nbThreads; ++i)
+	{
+		simThreadList.push_back(new SimulationThread(i, this));
+		
+		for (unsigned int k = 0; k < agentList.size(); ++k)
+			copyAgentList.push_back(agentList[k]->clone());
+	}
+	poolExpList   = expList;
+	poolAgentList = agentList;
+	
+	
+	//	Start the SimulationThreads (waiting for the first round)
+	for (unsigned int i = 0; i < nbThreads; ++i)
+		simThreadList[i]->start();
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::stopPool()
+{
+	if (simThreadList.empty()) { return; }
+	
+	
+	//	Notify the SimulationThreads and join them
+	pthread_mutex_lock(&m_pool);
+	poolStop = true;
+	pthread_cond_broadcast(&c_roundStart);
+	pthread_mutex_unlock(&m_pool);
+	
+	for (unsigned int i = 0; i < simThreadList.size(); ++i)
+		simThreadList[i]->join();
+	
+	
+	//	Delete the SimulationThreads and the copies of the agents
+	for (unsigned int i = 0; i < simThreadList.size(); ++i)
+		delete simThreadList[i];
+	
+	for (unsigned int i = 0; i < copyAgentList.size(); ++i)
+		delete copyAgentList[i];
+	
+	simThreadList.clear();
+	copyAgentList.clear();
+	poolExpList.clear();
+	poolAgentList.clear();
+	
+	delete[] taskRangeList;
+	
+	pthread_cond_destroy(&c_roundEnd);
+	pthread_cond_destroy(&c_roundStart);
+	pthread_mutex_destroy(&m_pool);
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+bool IExperiment<AgentType, MDPType, SimulationRecordType>::
+		popTask(unsigned int ID, pair<unsigned int, unsigned int>& task)
+{
+	const unsigned long long MASK = 0xFFFFFFFFULL;
+	
+	
+	//	Own range (front)
+	volatile unsigned long long* own = &(taskRangeList[ID].range);
+	for (;;)
+	{
+		unsigned long long r = *own;
+		unsigned long long b = (r >> 32), e = (r & MASK);
+		if (b >= e) { break; }
+		
+		if (__sync_bool_compare_and_swap(own, r, (((b + 1) << 32) | e)))
+		{
+			task = taskList[b];
+			return true;
+		}
+	}
+	
+	
+	//	Steal the second half of the range of another SimulationThread
+	//	(back), perform its first task and keep the others as own range
+	//	(an empty range is only refilled by its owner).
+	unsigned int n = simThreadList.size();
+	for (unsigned int k = 1; k < n; ++k)
+	{
+		volatile unsigned long long* victim
+				= &(taskRangeList[(ID + k) % n].range);
+		for (;;)
+		{
+			unsigned long long r = *victim;
+			unsigned long long b = (r >> 32), e = (r & MASK);
+			if (b >= e) { break; }
+			
+			unsigned long long m = (e - ((e - b + 1) / 2));
+			if (__sync_bool_compare_and_swap(victim, r, ((b << 32) | m)))
+			{
+				task = taskList[m];
+				
+				unsigned long long o = *own;
+				while (!__sync_bool_compare_and_swap(
+						own, o, (((m + 1) << 32) | e))) { o = *own; }
+				
+				return true;
+			}
+		}
+	}
+	
+	return false;
+}
+
+
+template<typename AgentType, typename MDPType, typename SimulationRecordType>
+void IExperiment<AgentType, MDPType, SimulationRecordType>::
+		runTasks(unsigned int ID)
+{
+	//	Each SimulationThread measures the time limit on its own
+	//	('chrono' is owned by the calling thread)
+	utils::Chrono roundChrono, taskChrono;
+	
+	unsigned int nbExp = poolExpList.size();
+	vector<double> timeList(nbExp, 0.0);
+	
+	//	The copy of the MDP of the current task (the tasks of the same
+	//	MDP are contiguous in 'taskList', so a copy is made about once
+	//	per MDP)
+	const MDPType* mdpSource = 0;
+	MDPType* mdpCopy = 0;
+	
+	pair<unsigned int, unsigned int> task;
+	while (popTask(ID, task))
+	{
+		unsigned int k = task.first;
+		IExperiment* exp = poolExpList[k];
+		
+		taskChrono.restart();
+		
+		const MDPType* mdp = exp->mdpList[task.second / exp->nbSimPerMDP];
+		if (mdp != mdpSource)
+		{
+			if (mdpCopy) { delete mdpCopy; }
+			mdpCopy = mdp->clone();
+			mdpSource = mdp;
+		}
+		
+		exp->performTask(
+				copyAgentList[ID*nbExp + k], task.second, mdpCopy, ID);
+		timeList[k] += taskChrono.get();
+		
+		
+		//	Time limit check
+		if ((timeLimit > 0) && (roundChrono.get() >= timeLimit)) { break; }
+	}
+	
+	if (mdpCopy) { delete mdpCopy; }
+	
+	
+	//	Report the time spent in the simulations of each IExperiment
+	pthread_mutex_lock(&m_pool);
+	for (unsigned int k = 0; k < nbExp; ++k) { roundTimeList[k] += timeList[k]; }
+	pthread_mutex_unlock(&m_pool);
+}
+
+
 #ifndef NDEBUG
 template<typename AgentType, typename MDPType, typename SimulationRecordType>
 void IExperiment<AgentType, MDPType, SimulationRecordType>::
@@ -446,6 +1301,10 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 	
 	assert(( saveTraj && simRecList.size() == mdpList.size()*nbSimPerMDP)
 	    || (!saveTraj && rList.size()      == mdpList.size()*nbSimPerMDP));
+	
+	assert(nbShards > 0);
+	assert(shardIndex < nbShards);
+	assert(nbDone <= getNbTasks());
 }
 #endif
 
@@ -456,47 +1315,37 @@ void IExperiment<AgentType, MDPType, SimulationRecordType>::
 template<typename AgentType, typename MDPType, typename SimulationRecordType>
 void* IExperiment<AgentType, MDPType, SimulationRecordType>::
 		SimulationThread::run()
-{	
+{
+     unsigned int round = 0;
      for (;;)
      {
-          //	Reserve the MDPs to simulate
-          pthread_mutex_lock(&(exp->m_nextMDP));
+          //	Wait for the next call of 'run()' (or for the stop signal)
+          pthread_mutex_lock(&(exp->m_pool));
+          
+          while ((exp->poolRound == round) && !exp->poolStop)
+               pthread_cond_wait(&(exp->c_roundStart), &(exp->m_pool));
           
-          //	No more simulation to perform
-          if (exp->nextMDP >= exp->mdpList.size())
+          if (exp->poolStop)
           {
-               pthread_mutex_unlock(&(exp->m_nextMDP));
+               pthread_mutex_unlock(&(exp->m_pool));
                break;
           }
-          unsigned int t = (exp->nextMDP++);
+          round = exp->poolRound;
           
-          pthread_mutex_unlock(&(exp->m_nextMDP));		
+          pthread_mutex_unlock(&(exp->m_pool));
           
           
           //	Perform the simulations
-          for (unsigned int i = 0; i < exp->nbSimPerMDP; ++i)
-          {
-               SimulationRecordType* simRec
-                         = new SimulationRecordType(
-                                   exp->simulate(exp->copyAgentList[ID],
-                                   exp->mdpList[t]));
-               
-               if (exp->saveTraj)
-                    exp->simRecList[exp->nbSimPerMDP*t + i] = simRec;
-               
-               else
-               {
-                    exp->rList[exp->nbSimPerMDP*t + i]
-                              = simRec->getRewardList();
-
-                    delete simRec;
-               }
-          }
+          exp->runTasks(ID);
+          
+          
+          //	Notify the end of the round
+          pthread_mutex_lock(&(exp->m_pool));
           
+          if (++(exp->nbThreadsDone) == exp->simThreadList.size())
+               pthread_cond_signal(&(exp->c_roundEnd));
           
-          //	Time limit check
-          if ((exp->timeLimit > 0)
-                    && ((exp->chrono).get() >= exp->timeLimit)) { break; }
+          pthread_mutex_unlock(&(exp->m_pool));
      }
      
      return 0;
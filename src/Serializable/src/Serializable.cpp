@@ -17,7 +17,8 @@ void Serializable::serialize(ostream& os) const
 }
 
 
-void Serializable::zSerialize(ostream& os, int compressionLevel) const
+void Serializable::zSerialize(ostream& os, int compressionLevel,
+                              unsigned int nThreads) const
 										throw (SerializableException)
 {
 	string cStr;
@@ -26,7 +27,7 @@ void Serializable::zSerialize(ostream& os, int compressionLevel) const
 	{
 		stringstream sstr;
 		serialize(sstr);
-		cStr = compressStr(sstr.str(), compressionLevel);
+		cStr = compressStr(sstr.str(), compressionLevel, nThreads);
 	}
 	
 	catch (runtime_error e)
@@ -77,7 +78,9 @@ void Serializable::dDeserialize(istream& is) throw (SerializableException)
 	{
 		istreambuf_iterator<char> eos;
 		string cStr(istreambuf_iterator<char>(is), eos);
-		dStr = decompressStr(cStr);
+		
+		long nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+		dStr = decompressStr(cStr, ((nProcessors > 1) ? nProcessors : 1));
 	}
 	
 	catch (runtime_error e)
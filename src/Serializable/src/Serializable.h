@@ -145,10 +145,14 @@ class Serializable
 							Z_BEST_COMPRESSION		(9)
 							Z_DEFAULT_COMPRESSION	(-1)
 					
+					If 'nThreads' > 1, the data are compressed by blocks
+					in parallel (see 'utils::compression::compressStr()').
+					
 					In case of error, return to the beginning of the
 					stream before throwing a SerializableException.
 		*/
-		void zSerialize(std::ostream& os, int compressionlevel) const
+		void zSerialize(std::ostream& os, int compressionlevel,
+		                unsigned int nThreads = 1) const
 									throw (SerializableException);
 		
 		
@@ -165,6 +169,10 @@ class Serializable
 			\brief	Deserialize this Object, assuming the stream contains
 					compressed data (zlib).
 					
+					If the data have been compressed by blocks, they are
+					decompressed in parallel, by as many threads as there
+					are processors online.
+					
 					In case of error, return to the beginning of the
 					stream before throwing a SerializableException.
 		*/
@@ -4,7 +4,11 @@
 #include "src/utils.h"
 
 #include "src/Chrono.h"
+#include "src/MappedFile.h"
+#include "src/Profiler.h"
 #include "src/RandomGen.h"
+#include "src/RunningStatistics.h"
+#include "src/SharedVector.h"
 #include "src/Thread.h"
 
 #include "src/Algorithm/StoSOO.h"
@@ -54,11 +54,12 @@ int UCB1::run(unsigned int n)
 
 
 	//	Convergence criteria: same arm drawn several times in a row
+	//	('ucbScoreList' is reused from one iteration to another)
+	vector<double> ucbScoreList(nArms);
 	while ((n > 0) && (nDiscardedArms < nArms))
 	{
 		//	1.	Compute the 'score' associated to each arm with respect
 		//		to UCB1 formula
-		vector<double> ucbScoreList(nArms);
 		for (unsigned int i = 0; i < nArms; ++i)
 		{
                if (discardFlags[i]) { ucbScoreList[i] = -DBL_MAX; }
@@ -71,13 +72,9 @@ int UCB1::run(unsigned int n)
 
 		
 		//	2.	Select the arm which obtained the best score
-		vector<vector<double>::const_iterator> maxList;
-		maxList = utils::search::max<vector<double> >(
+		int s = utils::search::randMax<vector<double> >(
 				ucbScoreList.begin(), ucbScoreList.end());
 		
-		int maxI	= RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-		int s	= (maxList[maxI] - ucbScoreList.begin());
-		
 		
 		//	3.	Draw the selected arm and update the data
 		try
@@ -103,12 +100,8 @@ int UCB1::run(unsigned int n)
 
 
 	//	Return the most drawn arm else
-	vector<vector<unsigned int>::const_iterator> maxList;
-		maxList = utils::search::max<vector<unsigned int> >(
-				nList.begin(), nList.end());
-		
-	int maxI = RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-	return (maxList[maxI] - nList.begin());
+	return utils::search::randMax<vector<unsigned int> >(
+			nList.begin(), nList.end());
 }
 
 
@@ -118,13 +111,11 @@ vector<unsigned int> UCB1::getTop(unsigned int n) const
 	vector<unsigned int> nListTmp = nList;
 	while (n-- > 0)
 	{	
-		vector<vector<unsigned int>::const_iterator> maxList;
-		maxList = utils::search::max<vector<unsigned int> >(
+		unsigned int i = utils::search::randMax<vector<unsigned int> >(
 				nListTmp.begin(), nListTmp.end());
 		
-		int maxI	= RandomGen::randIntRange_Uniform(0, (maxList.size() - 1));
-		top.push_back(maxList[maxI] - nListTmp.begin());
-		nListTmp[maxList[maxI] - nListTmp.begin()] = 0;
+		top.push_back(i);
+		nListTmp[i] = 0;
 	}
 	
 	return top;
@@ -0,0 +1,47 @@
+
+#include "MappedFile.h"
+
+using namespace utils;
+
+
+// ===========================================================================
+//	Public Constructor/Destructor
+// ===========================================================================
+MappedFile::MappedFile(const std::string& path) throw (std::runtime_error) :
+		data(0), size(0)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		throw std::runtime_error("Unable to open '" + path + "'!");
+
+	struct stat st;
+	if (fstat(fd, &st) == -1)
+	{
+		close(fd);
+		throw std::runtime_error("Unable to stat '" + path + "'!");
+	}
+	size = st.st_size;
+
+
+	//	An empty file cannot be mapped
+	if (size == 0) { close(fd); return; }
+
+	void* addr = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (addr == MAP_FAILED)
+		throw std::runtime_error("Unable to map '" + path + "'!");
+
+	data = static_cast<const char*>(addr);
+	
+	
+	//	'std::streambuf' get area
+	char* begin = const_cast<char*>(data);
+	setg(begin, begin, begin + size);
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (data) { munmap(const_cast<char*>(data), size); }
+}
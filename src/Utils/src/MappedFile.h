@@ -0,0 +1,94 @@
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "utils.h"
+#include "../ExternalLibs.h"
+
+
+// ===========================================================================
+/*
+	\class 	MappedFile
+
+	\brief 	A read-only view of a file mapped in memory.
+			The implementation depends on POSIX ('mmap()').
+
+			The pages are mapped as shared, which means that several
+			processes mapping the same file on the same node read the
+			same physical pages (through the page cache).
+			
+			A MappedFile is also a read-only 'std::streambuf', which
+			allows to read it through a 'std::istream' without copying
+			its content:
+				'std::istream is(&mappedFile);'
+*/
+// ===========================================================================
+class utils::MappedFile : public std::streambuf
+{
+	public:
+		// =================================================================
+		//	Public Constructor/Destructor
+		// =================================================================
+		/**
+			\brief		Constructor.
+						Throw a runtime_error if the file cannot be
+						mapped.
+
+			\param[path	The path of the file to map.
+		*/
+		MappedFile(const std::string& path) throw (std::runtime_error);
+
+
+		/**
+			\brief	Destructor.
+					The file is unmapped.
+		*/
+		~MappedFile();
+
+
+		// =================================================================
+		//	Public methods
+		// =================================================================
+		/**
+			\brief	Return a pointer to the first byte of the file.
+
+			\return	A pointer to the first byte of the file.
+		*/
+		const char* getData() const { return data; }
+
+
+		/**
+			\brief	Return the size of the file (in bytes).
+
+			\return	The size of the file (in bytes).
+		*/
+		size_t getSize() const { return size; }
+
+
+	private:
+		// =================================================================
+		//	Private attributes
+		// =================================================================
+		/**
+			\brief	The first byte of the mapped file.
+		*/
+		const char* data;
+
+
+		/**
+			\brief	The size of the file (in bytes).
+		*/
+		size_t size;
+
+
+		// =================================================================
+		//	Private Constructor/Operator
+		// =================================================================
+		/**
+			\brief	Prevent copies (a mapping is owned by one instance).
+		*/
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+};
+
+#endif
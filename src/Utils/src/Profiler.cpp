@@ -0,0 +1,149 @@
+
+#include "Profiler.h"
+
+using namespace std;
+using namespace utils;
+
+
+// ===========================================================================
+//	Private static attributes
+// ===========================================================================
+__thread vector<Profiler::Entry>* Profiler::localBuffer = 0;
+
+pthread_key_t Profiler::bufferKey;
+
+pthread_once_t Profiler::bufferKeyOnce = PTHREAD_ONCE_INIT;
+
+pthread_mutex_t Profiler::m_profiler = PTHREAD_MUTEX_INITIALIZER;
+
+vector<string> Profiler::phaseList;
+
+vector<vector<Profiler::Entry>*> Profiler::bufferList;
+
+vector<Profiler::Entry> Profiler::endedBuffer;
+
+
+// ===========================================================================
+//	Public static methods
+// ===========================================================================
+unsigned int Profiler::getPhaseId(const string& name)
+{
+	pthread_mutex_lock(&m_profiler);
+
+	unsigned int id = 0;
+	while ((id < phaseList.size()) && (phaseList[id] != name)) { ++id; }
+	if (id == phaseList.size()) { phaseList.push_back(name); }
+
+	pthread_mutex_unlock(&m_profiler);
+
+
+	return id;
+}
+
+
+Profiler::Profile Profiler::collect()
+{
+	pthread_mutex_lock(&m_profiler);
+
+	Profile profile;
+	for (unsigned int i = 0; i <= bufferList.size(); ++i)
+	{
+		const vector<Entry>& buffer =
+				((i < bufferList.size()) ? *(bufferList[i]) : endedBuffer);
+		for (unsigned int id = 0; id < buffer.size(); ++id)
+		{
+			if (buffer[id].count == 0) { continue; }
+
+			Entry& entry = profile[phaseList[id]];
+			entry.count += buffer[id].count;
+			entry.time  += buffer[id].time;
+		}
+	}
+
+	pthread_mutex_unlock(&m_profiler);
+
+
+	return profile;
+}
+
+
+void Profiler::reset()
+{
+	pthread_mutex_lock(&m_profiler);
+
+	for (unsigned int i = 0; i < bufferList.size(); ++i)
+	{
+		vector<Entry>& buffer = *(bufferList[i]);
+		for (unsigned int id = 0; id < buffer.size(); ++id)
+			buffer[id] = Entry();
+	}
+	endedBuffer.clear();
+
+	pthread_mutex_unlock(&m_profiler);
+}
+
+
+void Profiler::merge(Profile& dst, const Profile& src)
+{
+	Profile::const_iterator it;
+	for (it = src.begin(); it != src.end(); ++it)
+	{
+		Entry& entry = dst[it->first];
+		entry.count += it->second.count;
+		entry.time  += it->second.time;
+	}
+}
+
+
+// ===========================================================================
+//	Private static methods
+// ===========================================================================
+vector<Profiler::Entry>* Profiler::getLocalBuffer()
+{
+	pthread_once(&bufferKeyOnce, &Profiler::createBufferKey);
+
+	pthread_mutex_lock(&m_profiler);
+
+	if (!localBuffer)
+	{
+		localBuffer = new vector<Entry>();
+		bufferList.push_back(localBuffer);
+		pthread_setspecific(bufferKey, localBuffer);
+	}
+	localBuffer->resize(phaseList.size());
+
+	pthread_mutex_unlock(&m_profiler);
+
+
+	return localBuffer;
+}
+
+
+void Profiler::createBufferKey()
+{
+	pthread_key_create(&bufferKey, &Profiler::releaseLocalBuffer);
+}
+
+
+void Profiler::releaseLocalBuffer(void* buffer)
+{
+	vector<Entry>* ended = static_cast<vector<Entry>*>(buffer);
+
+	pthread_mutex_lock(&m_profiler);
+
+	if (endedBuffer.size() < ended->size())
+		endedBuffer.resize(ended->size());
+	for (unsigned int id = 0; id < ended->size(); ++id)
+	{
+		endedBuffer[id].count += (*ended)[id].count;
+		endedBuffer[id].time  += (*ended)[id].time;
+	}
+
+	bufferList.erase(find(bufferList.begin(), bufferList.end(), ended));
+
+	pthread_mutex_unlock(&m_profiler);
+
+
+	localBuffer = 0;
+	delete ended;
+}
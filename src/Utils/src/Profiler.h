@@ -0,0 +1,262 @@
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "utils.h"
+#include "../ExternalLibs.h"
+
+
+// ===========================================================================
+//	Instrumentation macros
+//	(compiled out unless PROFILING is defined, see 'CMakeLists.txt')
+// ===========================================================================
+#define PROFILER_CONCAT_AUX(a, b)	a##b
+#define PROFILER_CONCAT(a, b)		PROFILER_CONCAT_AUX(a, b)
+
+#ifdef PROFILING
+/**
+	\brief	Time the rest of the enclosing scope under phase 'name'
+			(one call per execution).
+*/
+#define PROFILE_SCOPE(name)											\
+	static const unsigned int PROFILER_CONCAT(profId_, __LINE__)		\
+			= utils::Profiler::getPhaseId(name);						\
+	utils::Profiler::ScopedTimer PROFILER_CONCAT(profTimer_, __LINE__)(	\
+			PROFILER_CONCAT(profId_, __LINE__))
+
+/**
+	\brief	Add 'n' to the counter 'name'.
+*/
+#define PROFILE_COUNT(name, n)										\
+	do {															\
+		static const unsigned int profId = utils::Profiler::getPhaseId(name);\
+		utils::Profiler::add(profId, (n), 0.0);						\
+	} while (0)
+
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_COUNT(name, n)	do {} while (0)
+
+#endif
+
+
+// ===========================================================================
+/*
+	\class 	Profiler
+
+	\brief 	Gather scoped timers and counters over the hot paths (see
+			'PROFILE_SCOPE' and 'PROFILE_COUNT').
+
+			Each thread records into its own buffer, without locking.
+			When a thread ends, its buffer is folded into a common one
+			and freed, so that short-lived threads do not accumulate.
+			The buffers are merged by 'collect()', which must be called
+			when no instrumented code is running (e.g.: between two
+			'IExperiment::run()' calls).
+
+			The timers are inclusive: a phase nested in another one is
+			also counted in its parent.
+			The implementation depends on POSIX ('clock_gettime()').
+*/
+// ===========================================================================
+class utils::Profiler
+{
+	public:
+		// =================================================================
+		//	Public Classes
+		// =================================================================
+		/**
+			\brief	The data gathered for a phase.
+		*/
+		struct Entry
+		{
+			Entry() : count(0), time(0.0) {}
+
+
+			/**
+				\brief	The number of calls (timers), or the sum of the
+						increments (counters).
+			*/
+			unsigned long count;
+
+
+			/**
+				\brief	The total time spent (in ms, 0 for counters).
+			*/
+			double time;
+		};
+
+
+		/**
+			\brief	The data gathered for each phase, indexed by name.
+		*/
+		typedef std::map<std::string, Entry> Profile;
+
+
+		/**
+			\brief	Time its own lifetime, and record it under a phase.
+		*/
+		class ScopedTimer
+		{
+			public:
+				ScopedTimer(unsigned int id_) : id(id_), start(now()) {}
+				~ScopedTimer() { add(id, 1, (now() - start)); }
+
+			private:
+				unsigned int id;
+				double start;
+		};
+
+
+		// =================================================================
+		//	Public static methods
+		// =================================================================
+		/**
+			\brief		Return the identifier of phase 'name' (registered
+						at its first call).
+
+			\param[name	The name of the phase.
+
+			\return		The identifier of phase 'name'.
+		*/
+		static unsigned int getPhaseId(const std::string& name);
+
+
+		/**
+			\brief		Record 'n' calls and 'time' ms under phase 'id'
+						(in the buffer of the calling thread).
+
+			\param[id		The identifier of the phase.
+			\param[n		The number of calls.
+			\param[time	The time spent (in ms).
+		*/
+		static void add(unsigned int id, unsigned long n, double time)
+		{
+			std::vector<Entry>* buffer = localBuffer;
+			if (!buffer || (id >= buffer->size()))
+				buffer = getLocalBuffer();
+
+			(*buffer)[id].count += n;
+			(*buffer)[id].time  += time;
+		}
+
+
+		/**
+			\brief	Return the current time of the monotonic clock (in ms,
+					only meaningful as a difference).
+
+			\return	The current time of the monotonic clock (in ms).
+		*/
+		static double now()
+		{
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+
+			return ((1000.0 * ts.tv_sec) + (ts.tv_nsec / 1000000.0));
+		}
+
+
+		/**
+			\brief	Return the data recorded by all threads since the last
+					'reset()'.
+
+			\return	The data recorded by all threads since the last
+					'reset()'.
+		*/
+		static Profile collect();
+
+
+		/**
+			\brief	Clear the data recorded by all threads.
+		*/
+		static void reset();
+
+
+		/**
+			\brief		Add the data of 'src' to 'dst'.
+
+			\param[dst	The Profile to update.
+			\param[src	The Profile to add.
+		*/
+		static void merge(Profile& dst, const Profile& src);
+
+
+	private:
+		// =================================================================
+		//	Private static attributes
+		// =================================================================
+		/**
+			\brief	The buffer of the calling thread (0 until its first
+					record).
+		*/
+		static __thread std::vector<Entry>* localBuffer;
+
+
+		/**
+			\brief	The key whose destructor releases the buffer of a
+					thread when it ends (see 'releaseLocalBuffer()').
+		*/
+		static pthread_key_t bufferKey;
+
+
+		/**
+			\brief	Ensure 'bufferKey' is created once.
+		*/
+		static pthread_once_t bufferKeyOnce;
+
+
+		/**
+			\brief	The mutex protecting 'phaseList', 'bufferList' and
+					'endedBuffer'.
+		*/
+		static pthread_mutex_t m_profiler;
+
+
+		/**
+			\brief	The name of each phase registered.
+		*/
+		static std::vector<std::string> phaseList;
+
+
+		/**
+			\brief	The buffer of each running thread which has recorded
+					data.
+		*/
+		static std::vector<std::vector<Entry>*> bufferList;
+
+
+		/**
+			\brief	The data recorded by the threads which have ended
+					since the last 'reset()'.
+		*/
+		static std::vector<Entry> endedBuffer;
+
+
+		// =================================================================
+		//	Private static methods
+		// =================================================================
+		/**
+			\brief	Create or extend the buffer of the calling thread, so
+					that it covers every phase registered.
+
+			\return	The buffer of the calling thread.
+		*/
+		static std::vector<Entry>* getLocalBuffer();
+
+
+		/**
+			\brief	Create 'bufferKey'.
+		*/
+		static void createBufferKey();
+
+
+		/**
+			\brief			Fold the buffer of a thread which ends into
+							'endedBuffer', and free it.
+
+			\param[buffer	The buffer of the thread.
+		*/
+		static void releaseLocalBuffer(void* buffer);
+};
+
+#endif
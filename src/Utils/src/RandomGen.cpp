@@ -4,6 +4,13 @@
 using namespace utils;
 
 
+#ifndef BOOST_FOUND
+//	The stream of the calling thread (see 'setThreadSeed()')
+static __thread bool hasThreadSeed = false;
+static __thread unsigned int threadSeed = 0;
+#endif
+
+
 // ===========================================================================
 //	Public static methods.
 // ===========================================================================
@@ -30,6 +37,35 @@ void RandomGen::setSeed(long int seed)
 }
 
 
+void RandomGen::setThreadSeed(unsigned int seed)
+{
+	#ifdef BOOST_FOUND
+	mutexGenerators_.lock();
+	generators_[boost::this_thread::get_id()] = boost::mt19937(seed);
+	mutexGenerators_.unlock();
+	
+	#else
+	hasThreadSeed = true;
+	threadSeed = seed;
+	
+	#endif
+}
+
+
+void RandomGen::clearThreadSeed()
+{
+	#ifdef BOOST_FOUND
+	mutexGenerators_.lock();
+	generators_.erase(boost::this_thread::get_id());
+	mutexGenerators_.unlock();
+	
+	#else
+	hasThreadSeed = false;
+	
+	#endif
+}
+
+
 double RandomGen::rand01_Uniform()
 {
 	#ifdef BOOST_FOUND
@@ -54,6 +90,9 @@ double RandomGen::rand01_Uniform()
 	return rand01Dist_(it->second);
 	
 	#else
+	if (hasThreadSeed)
+		return ((double) rand_r(&threadSeed) / (double) RAND_MAX);
+	
 	return ((double) rand() / (double) RAND_MAX);
 	
 	#endif
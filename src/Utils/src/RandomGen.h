@@ -33,6 +33,26 @@ class utils::RandomGen
 		static void setSeed(long int seed);
 		
 		
+		/**
+			\brief		Give the calling thread its own stream of random
+						numbers, seeded by 'seed'.
+						The streams of the other threads are not affected,
+						which allows several threads to draw reproducible
+						sequences concurrently.
+			
+			\param[seed	The seed to use.
+		*/
+		static void setThreadSeed(unsigned int seed);
+		
+		
+		/**
+			\brief		Drop the stream given to the calling thread by
+						'setThreadSeed()', the thread then draws from the
+						shared generator again.
+		*/
+		static void clearThreadSeed();
+		
+		
 		/**
 			\brief	Returns a number in [0; 1[ range, following a uniform
 					distribution.
@@ -0,0 +1,41 @@
+
+#include "RunningStatistics.h"
+
+using namespace std;
+using namespace utils;
+
+
+// ===========================================================================
+//	Public methods
+// ===========================================================================
+void RunningStatistics::add(double x)
+{
+	++n;
+
+	double delta = (x - mean);
+	mean += (delta / (double) n);
+	m2 += (delta * (x - mean));
+}
+
+
+void RunningStatistics::merge(const RunningStatistics& rs)
+{
+	if (rs.n == 0) { return; }
+	if (n == 0) { *this = rs; return; }
+
+	double total = ((double) n + (double) rs.n);
+	double delta = (rs.mean - mean);
+
+	mean += (delta * ((double) rs.n / total));
+	m2 += (rs.m2 + (delta * delta * ((double) n * (double) rs.n / total)));
+	n += rs.n;
+}
+
+
+pair<double, double> RunningStatistics::computeCI95() const
+{
+	if (n == 0) { return make_pair(0.0, 0.0); }
+
+	return statistics::details::computeCI(
+			1.96, mean, getStandardDeviation(), n);
+}
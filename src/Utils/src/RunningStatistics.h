@@ -0,0 +1,129 @@
+
+#ifndef RUNNINGSTATISTICS_H
+#define RUNNINGSTATISTICS_H
+
+#include "utils.h"
+#include "../ExternalLibs.h"
+
+
+// ===========================================================================
+/*
+	\class 	RunningStatistics
+
+	\brief 	The mean and the variance of a stream of values, updated in
+			O(1) for each new value (Welford's algorithm).
+
+			Two RunningStatistics computed on disjoint sets of values
+			can be merged (Chan et al.'s algorithm).
+
+			Not thread-safe.
+*/
+// ===========================================================================
+class utils::RunningStatistics
+{
+	public:
+		// =================================================================
+		//	Public Constructor
+		// =================================================================
+		/**
+			\brief	Constructor (no value).
+		*/
+		RunningStatistics() : n(0), mean(0.0), m2(0.0) {}
+
+
+		// =================================================================
+		//	Public methods
+		// =================================================================
+		/**
+			\brief		Add a value.
+
+			\param[x		The value to add.
+		*/
+		void add(double x);
+
+
+		/**
+			\brief		Add the values of 'rs'.
+
+			\param[rs		The RunningStatistics to merge.
+		*/
+		void merge(const RunningStatistics& rs);
+
+
+		/**
+			\brief	Remove all the values.
+		*/
+		void clear() { n = 0; mean = 0.0; m2 = 0.0; }
+
+
+		/**
+			\brief	Return the number of values.
+
+			\return	The number of values.
+		*/
+		unsigned int getCount() const { return n; }
+
+
+		/**
+			\brief	Return the mean of the values (0 if none).
+
+			\return	The mean of the values.
+		*/
+		double getMean() const { return mean; }
+
+
+		/**
+			\brief	Return the (unbiased) variance of the values (0 if
+					there are less than 2 values).
+					(see 'statistics::computeVariance()')
+
+			\return	The variance of the values.
+		*/
+		double getVariance() const
+		{
+			return ((n > 1) ? (m2 / (double) (n - 1)) : 0.0);
+		}
+
+
+		/**
+			\brief	Return the standard deviation of the values.
+
+			\return	The standard deviation of the values.
+		*/
+		double getStandardDeviation() const { return sqrt(getVariance()); }
+
+
+		/**
+			\brief	Compute the confidence interval of the mean of the
+					values with 95% confidence.
+					(see 'statistics::computeCI95()')
+
+			\return	A pair where 'first' is the CI lower bound and
+					'second' is the CI upper bound.
+		*/
+		std::pair<double, double> computeCI95() const;
+
+
+	private:
+		// =================================================================
+		//	Private attributes
+		// =================================================================
+		/**
+			\brief	The number of values.
+		*/
+		unsigned int n;
+
+
+		/**
+			\brief	The mean of the values.
+		*/
+		double mean;
+
+
+		/**
+			\brief	The sum of the squared differences to 'mean'.
+		*/
+		double m2;
+};
+
+#endif
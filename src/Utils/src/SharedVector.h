@@ -0,0 +1,189 @@
+
+#ifndef SHAREDVECTOR_H
+#define SHAREDVECTOR_H
+
+#include "utils.h"
+#include "../ExternalLibs.h"
+
+
+// ===========================================================================
+/*
+	\class 	SharedVector
+
+	\brief 	An immutable vector, whose copies share the same data.
+			The data are freed when the last copy is destroyed (the
+			reference counter is atomic, so that the copies can be
+			created and destroyed from several threads at once).
+*/
+// ===========================================================================
+template<typename T>
+class utils::SharedVector
+{
+	public:
+		// =================================================================
+		//	Public Constructors/Destructor
+		// =================================================================
+		/**
+			\brief	Constructor (empty vector).
+		*/
+		SharedVector() : data(0) {}
+
+
+		/**
+			\brief		Constructor (copies 'v').
+
+			\param[v		The content of this SharedVector.
+		*/
+		explicit SharedVector(const std::vector<T>& v) : data(new Data(v)) {}
+
+
+		/**
+			\brief		Copy constructor (shares the data of 'sv').
+
+			\param[sv		The SharedVector to share.
+		*/
+		SharedVector(const SharedVector& sv) : data(sv.data) { acquire(); }
+
+
+		/**
+			\brief	Destructor.
+		*/
+		~SharedVector() { release(); }
+
+
+		// =================================================================
+		//	Public methods
+		// =================================================================
+		/**
+			\brief		Share the data of 'sv'.
+
+			\param[sv		The SharedVector to share.
+
+			\return		This SharedVector.
+		*/
+		SharedVector& operator=(const SharedVector& sv)
+		{
+			if (data != sv.data)
+			{
+				release();
+				data = sv.data;
+				acquire();
+			}
+
+			return *this;
+		}
+
+
+		/**
+			\brief	Return the content of this SharedVector.
+
+			\return	The content of this SharedVector.
+		*/
+		const std::vector<T>& get() const
+		{
+			return (data ? data->v : getEmpty());
+		}
+
+
+		/**
+			\brief	Return the i-th element of this SharedVector.
+
+			\return	The i-th element of this SharedVector.
+		*/
+		const T& operator[](size_t i) const { return data->v[i]; }
+
+
+		/**
+			\brief	Return the number of elements of this SharedVector.
+
+			\return	The number of elements of this SharedVector.
+		*/
+		size_t size() const { return (data ? data->v.size() : 0); }
+
+
+		/**
+			\brief	Return true if this SharedVector is empty, false else.
+
+			\return	True if this SharedVector is empty, false else.
+		*/
+		bool empty() const { return (size() == 0); }
+
+
+		/**
+			\brief		Return true if this SharedVector shares its data
+						with 'sv', false else.
+
+			\param[sv		A SharedVector.
+
+			\return		True if this SharedVector shares its data with
+						'sv', false else.
+		*/
+		bool isSharedWith(const SharedVector& sv) const
+		{
+			return (data == sv.data);
+		}
+
+
+	private:
+		// =================================================================
+		//	Private Classes
+		// =================================================================
+		/**
+			\brief	The shared data.
+		*/
+		struct Data
+		{
+			Data(const std::vector<T>& v_) : v(v_), nbRefs(1) {}
+
+			const std::vector<T> v;
+			unsigned int nbRefs;
+		};
+
+
+		// =================================================================
+		//	Private attributes
+		// =================================================================
+		/**
+			\brief	The shared data (0 if empty).
+		*/
+		Data* data;
+
+
+		// =================================================================
+		//	Private methods
+		// =================================================================
+		/**
+			\brief	Add a reference to the data.
+		*/
+		void acquire()
+		{
+			if (data) { __sync_fetch_and_add(&data->nbRefs, 1); }
+		}
+
+
+		/**
+			\brief	Remove a reference to the data (and free them if it
+					was the last one).
+		*/
+		void release()
+		{
+			if (data && (__sync_sub_and_fetch(&data->nbRefs, 1) == 0))
+				delete data;
+
+			data = 0;
+		}
+
+
+		/**
+			\brief	Return an empty vector.
+
+			\return	An empty vector.
+		*/
+		static const std::vector<T>& getEmpty()
+		{
+			static const std::vector<T> empty;
+			return empty;
+		}
+};
+
+#endif
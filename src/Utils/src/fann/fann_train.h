@@ -217,6 +217,27 @@ FANN_EXTERNAL void FANN_API fann_train_on_file(struct fann *ann, const char *fil
 FANN_EXTERNAL float FANN_API fann_train_epoch(struct fann *ann, struct fann_train_data *data);
 FANN_EXTERNAL float FANN_API fann_train_epoch_w(struct fann *ann, struct fann_train_data *data,
                                                 const double* weights);
+
+/* Function: fann_train_epoch_minibatch_w
+   Train one epoch with a set of weighted training data, using mini-batch
+   gradient descent.
+
+	The data is processed in consecutive batches of 'batch_size' samples. The
+	slopes of a batch are computed by 'num_threads' threads, each of them
+	working on a contiguous shard of the batch with its own copy of the
+	network. The slopes are then summed (always in the same order) and the
+	weights are updated once per batch, as in <FANN_TRAIN_BATCH>.
+
+	This function does not depend on the training algorithm chosen by
+	<fann_set_training_algorithm>.
+
+	Returns the weighted MSE computed during the epoch, or -1 if the worker
+	networks could not be allocated.
+ */
+FANN_EXTERNAL float FANN_API fann_train_epoch_minibatch_w(struct fann *ann, struct fann_train_data *data,
+                                                          const double* weights,
+                                                          unsigned int batch_size,
+                                                          unsigned int num_threads);
 #endif	/* NOT FIXEDFANN */
 
 /* Function: fann_test_data
@@ -322,6 +343,15 @@ FANN_EXTERNAL void FANN_API fann_shuffle_train_data(struct fann_train_data *trai
 FANN_EXTERNAL void FANN_API fann_shuffle_train_data_w(struct fann_train_data *train_data,
                                                       double* weights);
 
+/* Function: fann_shuffle_train_data_w_r
+   
+   Same as <fann_shuffle_train_data_w>, but draws the permutation from the
+   given seed ('rand_r()') instead of the global 'rand()' state, so that
+   several threads can shuffle their own training data reproducibly.
+ */ 
+FANN_EXTERNAL void FANN_API fann_shuffle_train_data_w_r(struct fann_train_data *train_data,
+                                                        double* weights, unsigned int *seed);
+
 #ifndef FIXEDFANN
 /* Function: fann_scale_train
 
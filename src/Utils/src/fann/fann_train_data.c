@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "config.h"
 #include "fann.h"
@@ -297,6 +298,206 @@ FANN_EXTERNAL float FANN_API fann_train_epoch_w(struct fann *ann, struct fann_tr
 	return 0;
 }
 
+/*
+ * INTERNAL STRUCTURE
+ * State of a thread taking part in a mini-batch epoch
+ * (see 'fann_train_epoch_minibatch_w()').
+ */
+struct fann_minibatch_worker
+{
+	struct fann *master;
+	struct fann *ann;
+	struct fann_train_data *data;
+	const double *weights;
+	unsigned int batch_size;
+	unsigned int num_threads;
+	unsigned int id;
+	pthread_barrier_t *barrier;
+	pthread_t thread;
+	struct fann_minibatch_worker *worker_list;
+};
+
+/*
+ * INTERNAL FUNCTION
+ * Sum the slopes (and the MSE statistics) of every worker into the master
+ * network, always in the same order so that the result does not depend on
+ * thread scheduling.
+ */
+static void fann_minibatch_reduce(struct fann_minibatch_worker *worker_list,
+                                  unsigned int num_threads)
+{
+	struct fann *master = worker_list[0].master;
+	fann_type *master_slopes = master->train_slopes;
+	unsigned int total_connections = master->total_connections;
+	unsigned int k, i;
+
+	for(k = 1; k < num_threads; k++)
+	{
+		fann_type *slopes = worker_list[k].ann->train_slopes;
+
+		for(i = 0; i != total_connections; i++)
+		{
+			master_slopes[i] += slopes[i];
+			slopes[i] = 0;
+		}
+	}
+}
+
+/*
+ * INTERNAL FUNCTION
+ * Mini-batch loop run by every worker (worker 0 runs in the calling
+ * thread and works directly on the master network).
+ */
+static void *fann_minibatch_run(void *arg)
+{
+	struct fann_minibatch_worker *worker = (struct fann_minibatch_worker *) arg;
+	struct fann *master = worker->master;
+	struct fann *ann = worker->ann;
+	struct fann_train_data *data = worker->data;
+	unsigned int num_data = data->num_data;
+	unsigned int first, size, begin, end, i;
+
+	for(first = 0; first < num_data; first += worker->batch_size)
+	{
+		size = worker->batch_size;
+		if(size > num_data - first)
+			size = num_data - first;
+
+		/* the weights have been updated by worker 0 */
+		if(ann != master)
+			memcpy(ann->weights, master->weights, master->total_connections * sizeof(fann_type));
+
+		/* shard of the current batch */
+		begin = first + (unsigned int) (((unsigned long) size * worker->id) / worker->num_threads);
+		end = first + (unsigned int) (((unsigned long) size * (worker->id + 1)) / worker->num_threads);
+
+		for(i = begin; i < end; i++)
+		{
+			fann_run(ann, data->input[i]);
+			fann_compute_MSE_w(ann, data->output[i], worker->weights[i]);
+			fann_backpropagate_MSE(ann);
+			fann_update_slopes_batch(ann, ann->first_layer + 1, ann->last_layer - 1);
+		}
+
+		if(worker->num_threads > 1)
+			pthread_barrier_wait(worker->barrier);
+
+		if(worker->id == 0)
+		{
+			fann_minibatch_reduce(worker->worker_list, worker->num_threads);
+			fann_update_weights_batch(master, size, 0, master->total_connections);
+		}
+
+		if(worker->num_threads > 1)
+			pthread_barrier_wait(worker->barrier);
+	}
+
+	return NULL;
+}
+
+FANN_EXTERNAL float FANN_API fann_train_epoch_minibatch_w(struct fann *ann, struct fann_train_data *data,
+                                                          const double* weights,
+                                                          unsigned int batch_size,
+                                                          unsigned int num_threads)
+{
+	struct fann_minibatch_worker *worker_list;
+	pthread_barrier_t barrier;
+	unsigned int k;
+
+	if(fann_check_input_output_sizes(ann, data) == -1)
+		return 0;
+
+	if(batch_size == 0)
+		batch_size = 1;
+	if(num_threads == 0)
+		num_threads = 1;
+	if(num_threads > batch_size)
+		num_threads = batch_size;
+
+	/* the slopes of the master network receive the reduced slopes */
+	if(ann->train_slopes == NULL)
+	{
+		ann->train_slopes =
+			(fann_type *) calloc(ann->total_connections_allocated, sizeof(fann_type));
+		if(ann->train_slopes == NULL)
+		{
+			fann_error((struct fann_error *) ann, FANN_E_CANT_ALLOCATE_MEM);
+			return -1;
+		}
+	}
+	else
+	{
+		memset(ann->train_slopes, 0, (ann->total_connections_allocated) * sizeof(fann_type));
+	}
+	fann_reset_MSE(ann);
+
+	worker_list = (struct fann_minibatch_worker *) calloc(num_threads, sizeof(struct fann_minibatch_worker));
+	if(worker_list == NULL)
+	{
+		fann_error((struct fann_error *) ann, FANN_E_CANT_ALLOCATE_MEM);
+		return -1;
+	}
+
+	/* every other thread works on its own copy of the network
+	 * ('fann_run()' stores the neuron values in the network) */
+	for(k = 0; k < num_threads; k++)
+	{
+		struct fann_minibatch_worker *worker = &worker_list[k];
+
+		worker->master = ann;
+		worker->data = data;
+		worker->weights = weights;
+		worker->batch_size = batch_size;
+		worker->num_threads = num_threads;
+		worker->id = k;
+		worker->barrier = &barrier;
+		worker->worker_list = worker_list;
+
+		if(k == 0)
+		{
+			worker->ann = ann;
+			continue;
+		}
+
+		worker->ann = fann_copy(ann);
+		if(worker->ann == NULL)
+		{
+			while(--k > 0)
+				fann_destroy(worker_list[k].ann);
+			free(worker_list);
+			fann_error((struct fann_error *) ann, FANN_E_CANT_ALLOCATE_MEM);
+			return -1;
+		}
+		fann_reset_MSE(worker->ann);
+	}
+
+	if(num_threads > 1)
+	{
+		pthread_barrier_init(&barrier, NULL, num_threads);
+		for(k = 1; k < num_threads; k++)
+			pthread_create(&worker_list[k].thread, NULL, fann_minibatch_run, &worker_list[k]);
+	}
+
+	fann_minibatch_run(&worker_list[0]);
+
+	if(num_threads > 1)
+	{
+		for(k = 1; k < num_threads; k++)
+		{
+			pthread_join(worker_list[k].thread, NULL);
+
+			ann->MSE_value += worker_list[k].ann->MSE_value;
+			ann->num_MSE += worker_list[k].ann->num_MSE;
+			ann->num_bit_fail += worker_list[k].ann->num_bit_fail;
+			fann_destroy(worker_list[k].ann);
+		}
+		pthread_barrier_destroy(&barrier);
+	}
+	free(worker_list);
+
+	return fann_get_MSE(ann);
+}
+
 
 FANN_EXTERNAL void FANN_API fann_train_on_data(struct fann *ann, struct fann_train_data *data,
 											   unsigned int max_epochs,
@@ -426,6 +627,36 @@ FANN_EXTERNAL void FANN_API fann_shuffle_train_data_w(struct fann_train_data *tr
 		}
 	}
 }
+FANN_EXTERNAL void FANN_API fann_shuffle_train_data_w_r(struct fann_train_data *train_data,
+                                                        double* weights, unsigned int *seed)
+{
+	unsigned int dat = 0, elem, swap;
+	fann_type temp;
+
+	for(; dat < train_data->num_data; dat++)
+	{
+		swap = (unsigned int) (rand_r(seed) % train_data->num_data);
+		if(swap != dat)
+		{
+			for(elem = 0; elem < train_data->num_input; elem++)
+			{
+				temp = train_data->input[dat][elem];
+				train_data->input[dat][elem] = train_data->input[swap][elem];
+				train_data->input[swap][elem] = temp;
+			}
+			for(elem = 0; elem < train_data->num_output; elem++)
+			{
+				temp = train_data->output[dat][elem];
+				train_data->output[dat][elem] = train_data->output[swap][elem];
+				train_data->output[swap][elem] = temp;
+			}
+			
+			double tmp    = weights[dat];
+			weights[dat]  = weights[swap];
+			weights[swap] = tmp;
+		}
+	}
+}
 
 /*
  * INTERNAL FUNCTION Scales data to a specific range 
@@ -1,6 +1,7 @@
 
 #include "utils.h"
 #include "RandomGen.h"
+#include "Thread.h"
 #include "Algorithm/StoSOO.h"
 
 using namespace std;
@@ -129,15 +130,379 @@ double utils::statistics::getBilateralPairedZThreshold95()  { return 1.96;  }
 double utils::statistics::getUnilateralPairedZThreshold95() { return 1.645; }
 
 
+double utils::statistics::getBilateralZThreshold(double alpha)
+{
+     assert((alpha > 0.0) && (alpha < 1.0));
+     
+     
+     //   Solve 'P(|Z| > z) = erfc(z / sqrt(2)) = alpha' by bisection
+     double zMin = 0.0, zMax = 40.0;
+     for (unsigned int i = 0; i < 100; ++i)
+     {
+          double z = ((zMin + zMax) / 2.0);
+          if (erfc(z / sqrt(2.0)) > alpha) { zMin = z; }
+          else                             { zMax = z; }
+     }
+     
+     return ((zMin + zMax) / 2.0);
+}
+
+
+double utils::statistics::computeOBFAlphaSpending(double alpha, double tau)
+{
+     assert((alpha > 0.0) && (alpha < 1.0));
+     
+     if (tau <= 0.0) { return 0.0;   }
+     if (tau >= 1.0) { return alpha; }
+     
+     
+     //   2 - 2 Phi(x) = erfc(x / sqrt(2))
+     return erfc(getBilateralZThreshold(alpha) / sqrt(2.0 * tau));
+}
+
+
 // ---------------------------------------------------------------------------
 //	'compression' namespace
 // ---------------------------------------------------------------------------
+// ===========================================================================
+//	Details (to ignore)
+// ===========================================================================
+namespace
+{
+	/**
+		\brief	The size of the blocks compressed independently by
+				'compressStr()' when several threads are used.
+	*/
+	const size_t BLOCK_SIZE = (1 << 20);
+	
+	
+	/**
+		\brief	The tag ending the index of the blocks of a stream.
+	*/
+	const char INDEX_TAG[] = "BBRLzidx";
+	const size_t INDEX_TAG_SIZE = (sizeof(INDEX_TAG) - 1);
+	
+	
+	/**
+		\brief	The blocks of a stream, compressed or decompressed by
+				several BlockThreads.
+	*/
+	struct BlockJob
+	{
+		BlockJob(const string* in_, string* out_, int compressionLevel_) :
+				in(in_), out(out_), compressionLevel(compressionLevel_),
+				nextBlock(0), error(Z_OK) {}
+		
+		const string* in;
+		string* out;
+		int compressionLevel;
+		
+		std::vector<size_t> cOffsetList, cSizeList;
+		std::vector<size_t> dOffsetList, dSizeList;
+		std::vector<std::string> cBlockList;
+		std::vector<uLong> adlerList;
+		
+		unsigned int nextBlock;
+		int error;
+	};
+	
+	
+	/**
+		\brief	Compress the i-th block of 'job->in' into a raw deflate
+				stream, ended by a sync flush (or by the end of the stream
+				for the last block).
+	*/
+	int deflateBlock(BlockJob* job, unsigned int i)
+	{
+		z_stream zs;
+		memset(&zs, 0, sizeof(zs));
+		
+		if (deflateInit2(&zs, job->compressionLevel, Z_DEFLATED,
+		                 -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			return Z_STREAM_ERROR;
+		}
+		
+		const Bytef* dBlock
+				= (const Bytef*) (job->in->data() + job->dOffsetList[i]);
+		uInt dSize = job->dSizeList[i];
+		
+		zs.next_in = (Bytef*) dBlock;
+		zs.avail_in = dSize;
+		
+		bool isLast = (i == (job->dSizeList.size() - 1));
+		string& cBlock = job->cBlockList[i];
+		cBlock.resize(deflateBound(&zs, dSize) + 16);
+		
+		int ret;
+		do
+		{
+			if (zs.total_out == cBlock.size()) { cBlock.resize(2*cBlock.size()); }
+			
+			zs.next_out = (Bytef*) &cBlock[zs.total_out];
+			zs.avail_out = (cBlock.size() - zs.total_out);
+			
+			ret = deflate(&zs, (isLast ? Z_FINISH : Z_SYNC_FLUSH));
+		}
+		while ((ret == Z_OK) && (zs.avail_out == 0));
+		
+		cBlock.resize(zs.total_out);
+		deflateEnd(&zs);
+		
+		if (isLast ? (ret != Z_STREAM_END)
+		           : (((ret != Z_OK) && (ret != Z_BUF_ERROR))
+		                   || (zs.avail_in != 0)))
+		{
+			return ((ret == Z_OK) ? Z_BUF_ERROR : ret);
+		}
+		
+		job->adlerList[i] = adler32(adler32(0L, Z_NULL, 0), dBlock, dSize);
+		
+		return Z_OK;
+	}
+	
+	
+	/**
+		\brief	Decompress the i-th block of 'job->in' (a raw deflate
+				stream) at its place in 'job->out'.
+	*/
+	int inflateBlock(BlockJob* job, unsigned int i)
+	{
+		z_stream zs;
+		memset(&zs, 0, sizeof(zs));
+		
+		if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) { return Z_STREAM_ERROR; }
+		
+		Bytef* dBlock = (Bytef*) &(*job->out)[job->dOffsetList[i]];
+		uInt dSize = job->dSizeList[i];
+		
+		zs.next_in = (Bytef*) (job->in->data() + job->cOffsetList[i]);
+		zs.avail_in = job->cSizeList[i];
+		zs.next_out = dBlock;
+		zs.avail_out = dSize;
+		
+		int ret = inflate(&zs, Z_SYNC_FLUSH);
+		inflateEnd(&zs);
+		
+		bool isLast = (i == (job->dSizeList.size() - 1));
+		if ((ret != (isLast ? Z_STREAM_END : Z_OK))
+				|| (zs.avail_in != 0) || (zs.total_out != dSize))
+		{
+			return ((ret == Z_STREAM_END) || (ret == Z_OK)) ? Z_DATA_ERROR : ret;
+		}
+		
+		job->adlerList[i] = adler32(adler32(0L, Z_NULL, 0), dBlock, dSize);
+		
+		return Z_OK;
+	}
+	
+	
+	/**
+		\brief	A thread processing the blocks of a BlockJob until there
+				is none left (or until an error occurs).
+	*/
+	class BlockThread : public utils::Thread
+	{
+		public:
+			BlockThread(BlockJob* job_, int (*f_)(BlockJob*, unsigned int)) :
+					Thread(), job(job_), f(f_) {}
+			
+			
+			void* run()
+			{
+				unsigned int nBlocks = job->dSizeList.size();
+				
+				unsigned int i;
+				while (((i = __sync_fetch_and_add(&job->nextBlock, 1)) < nBlocks)
+				          && (job->error == Z_OK))
+				{
+					int ret = f(job, i);
+					if (ret != Z_OK)
+						__sync_bool_compare_and_swap(&job->error, Z_OK, ret);
+				}
+				
+				return 0;
+			}
+		
+		
+		private:
+			BlockJob* job;
+			int (*f)(BlockJob*, unsigned int);
+	};
+	
+	
+	/**
+		\brief	Process all the blocks of 'job' with 'nThreads' threads
+				(the calling thread if 'nThreads' <= 1).
+	*/
+	void runBlockJob(BlockJob* job, int (*f)(BlockJob*, unsigned int),
+	                 unsigned int nThreads)
+	{
+		if (nThreads > job->dSizeList.size()) { nThreads = job->dSizeList.size(); }
+		
+		if (nThreads <= 1) { BlockThread(job, f).run(); return; }
+		
+		std::vector<BlockThread*> threadList;
+		for (unsigned int j = 0; j < nThreads; ++j)
+		{
+			threadList.push_back(new BlockThread(job, f));
+			threadList.back()->start();
+		}
+		
+		for (unsigned int j = 0; j < nThreads; ++j)
+		{
+			threadList[j]->join();
+			delete threadList[j];
+		}
+	}
+	
+	
+	/**
+		\brief	Append 'x' to 'str' (4 bytes, little-endian).
+	*/
+	void appendUInt32(string& str, size_t x)
+	{
+		for (unsigned int k = 0; k < 4; ++k) { str += (char) ((x >> (8*k)) & 0xFF); }
+	}
+	
+	
+	/**
+		\brief	Read 4 bytes of 'str' starting at 'pos' (little-endian).
+	*/
+	size_t readUInt32(const string& str, size_t pos)
+	{
+		size_t x = 0;
+		for (unsigned int k = 0; k < 4; ++k)
+			x |= ((size_t) (unsigned char) str[pos + k] << (8*k));
+		
+		return x;
+	}
+	
+	
+	/**
+		\brief	Parse the index of the blocks of 'str' (see
+				'compressStr()') into 'job', and return false if there is
+				none (or if it is inconsistent).
+	*/
+	bool readIndex(const string& str, BlockJob* job)
+	{
+		//	Tag and number of blocks
+		if (str.size() < (2 + 4 + 4 + INDEX_TAG_SIZE)) { return false; }
+		if (str.compare(str.size() - INDEX_TAG_SIZE, INDEX_TAG_SIZE, INDEX_TAG) != 0)
+			return false;
+		
+		size_t nBlocks = readUInt32(str, str.size() - INDEX_TAG_SIZE - 4);
+		if ((nBlocks == 0)
+				|| (nBlocks > ((str.size() - 2 - 4 - 4 - INDEX_TAG_SIZE) / 8)))
+		{
+			return false;
+		}
+		
+		
+		//	Sizes of the blocks
+		size_t indexPos = (str.size() - INDEX_TAG_SIZE - 4 - 8*nBlocks);
+		size_t cOffset = 2, dOffset = 0;
+		for (size_t i = 0; i < nBlocks; ++i)
+		{
+			size_t cSize = readUInt32(str, indexPos + 8*i);
+			size_t dSize = readUInt32(str, indexPos + 8*i + 4);
+			
+			//	A corrupted index must not trigger huge allocations (deflate
+			//	cannot expand data by more than 1032:1)
+			if ((dSize > BLOCK_SIZE) || (cSize > compressBound(BLOCK_SIZE))
+					|| (dSize > (1032*cSize)))
+			{
+				return false;
+			}
+			
+			job->cOffsetList.push_back(cOffset);
+			job->cSizeList.push_back(cSize);
+			job->dOffsetList.push_back(dOffset);
+			job->dSizeList.push_back(dSize);
+			
+			cOffset += cSize;
+			dOffset += dSize;
+			
+			if (cOffset > indexPos) { return false; }
+		}
+		
+		
+		//	The blocks must be followed by the Adler-32 checksum
+		return ((cOffset + 4) == indexPos);
+	}
+}
+
+
 // ===========================================================================
 //	Functions
 // ===========================================================================
 string utils::compression::compressStr(
-	const string& str, int compressionlevel) throw (runtime_error)
+	const string& str, int compressionlevel, unsigned int nThreads)
+										throw (runtime_error)
 {
+    //  Block-parallel case
+    if ((nThreads > 1) && (str.size() > BLOCK_SIZE))
+    {
+        BlockJob job(&str, 0, compressionlevel);
+        for (size_t offset = 0; offset < str.size(); offset += BLOCK_SIZE)
+        {
+            job.dOffsetList.push_back(offset);
+            job.dSizeList.push_back(min(BLOCK_SIZE, str.size() - offset));
+        }
+        job.cBlockList.resize(job.dSizeList.size());
+        job.adlerList.resize(job.dSizeList.size());
+        
+        runBlockJob(&job, &deflateBlock, nThreads);
+        
+        if (job.error != Z_OK)
+        {
+            ostringstream oss;
+            oss << "Exception during zlib compression: (" << job.error << ")";
+            throw(runtime_error(oss.str()));
+        }
+        
+        
+        //  zlib header (same as 'deflate()')
+        int level = ((compressionlevel == Z_DEFAULT_COMPRESSION) ?
+                          6 : compressionlevel);
+        unsigned int flags = ((level < 2) ? 0 : ((level < 6) ? 1 :
+                             ((level == 6) ? 2 : 3)));
+        unsigned int header = ((Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8);
+        header |= (flags << 6);
+        header += (31 - (header % 31));
+        
+        string outstring;
+        outstring += (char) (header >> 8);
+        outstring += (char) (header & 0xFF);
+        
+        
+        //  Blocks, and Adler-32 checksum of the whole string (big-endian)
+        uLong adler = adler32(0L, Z_NULL, 0);
+        for (unsigned int i = 0; i < job.cBlockList.size(); ++i)
+        {
+            outstring += job.cBlockList[i];
+            adler = adler32_combine(adler, job.adlerList[i],
+                                    job.dSizeList[i]);
+        }
+        
+        for (int k = 3; k >= 0; --k)
+            outstring += (char) ((adler >> (8*k)) & 0xFF);
+        
+        
+        //  Index of the blocks
+        for (unsigned int i = 0; i < job.cBlockList.size(); ++i)
+        {
+            appendUInt32(outstring, job.cBlockList[i].size());
+            appendUInt32(outstring, job.dSizeList[i]);
+        }
+        appendUInt32(outstring, job.cBlockList.size());
+        outstring += INDEX_TAG;
+        
+        return outstring;
+    }
+    
+    
+    //  Other case
     z_stream zs;                        // z_stream is zlib's control structure
     memset(&zs, 0, sizeof(zs));
 
@@ -177,9 +542,42 @@ string utils::compression::compressStr(
 }
 
 
-string utils::compression::decompressStr(const string& str)
+string utils::compression::decompressStr(const string& str,
+                                         unsigned int nThreads)
 										throw (runtime_error)
 {
+    //  Indexed case (see 'compressStr()')
+    //  (if anything goes wrong, the stream is decompressed as a whole
+    //  below, which reports the errors)
+    BlockJob job(&str, 0, 0);
+    if (readIndex(str, &job))
+    {
+        string outstring(job.dOffsetList.back() + job.dSizeList.back(), '\0');
+        job.out = &outstring;
+        job.adlerList.resize(job.dSizeList.size());
+        
+        runBlockJob(&job, &inflateBlock, nThreads);
+        
+        if (job.error == Z_OK)
+        {
+            uLong adler = adler32(0L, Z_NULL, 0);
+            for (unsigned int i = 0; i < job.adlerList.size(); ++i)
+            {
+                adler = adler32_combine(adler, job.adlerList[i],
+                                        job.dSizeList[i]);
+            }
+            
+            size_t pos = (job.cOffsetList.back() + job.cSizeList.back());
+            uLong expected = 0;
+            for (unsigned int k = 0; k < 4; ++k)
+                expected = ((expected << 8) | (unsigned char) str[pos + k]);
+            
+            if (adler == expected) { return outstring; }
+        }
+    }
+    
+    
+    //  Other case
     z_stream zs;                        // z_stream is zlib's control structure
     memset(&zs, 0, sizeof(zs));
 
@@ -220,6 +618,63 @@ string utils::compression::decompressStr(const string& str)
 }
 
 
+// ---------------------------------------------------------------------------
+//	'hashing' namespace
+// ---------------------------------------------------------------------------
+// ===========================================================================
+//	Functions
+// ===========================================================================
+string utils::hashing::computeHash(const char* data, size_t n)
+{
+	//	64-bit FNV-1a
+	unsigned long long h = 14695981039346656037ULL;
+	for (size_t i = 0; i < n; ++i)
+	{
+		h ^= (unsigned char) data[i];
+		h *= 1099511628211ULL;
+	}
+	
+	ostringstream oss;
+	oss << hex << setfill('0') << setw(16) << h;
+	
+	return oss.str();
+}
+
+
+string utils::hashing::computeHash(const string& str)
+{
+	return utils::hashing::computeHash(str.data(), str.size());
+}
+
+
+unsigned int utils::hashing::computeSeed(unsigned int seed, unsigned int index)
+{
+	//	SplitMix64
+	unsigned long long z = (((unsigned long long) seed << 32) | index);
+	z += 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z =  z ^ (z >> 31);
+	
+	unsigned int s = (unsigned int) (z & 0x7FFFFFFFULL);
+	return ((s > 0) ? s : 1);
+}
+
+
+// ---------------------------------------------------------------------------
+//	'search' namespace
+// ---------------------------------------------------------------------------
+// ===========================================================================
+//	Functions
+// ===========================================================================
+unsigned int utils::search::drawIndex(unsigned int n)
+{
+	assert(n > 0);
+	
+	return utils::RandomGen::randIntRange_Uniform(0, (n - 1));
+}
+
+
 // ---------------------------------------------------------------------------
 //	'parsing' namespace
 // ---------------------------------------------------------------------------
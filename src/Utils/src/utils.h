@@ -28,6 +28,20 @@ namespace utils
 	class Chrono;
 	
 	
+	/**
+          \class    MappedFile
+          \brief    A read-only view of a file mapped in memory.
+	*/
+	class MappedFile;
+	
+	
+	/**
+          \class    Profiler
+          \brief    Scoped timers and counters over the hot paths.
+	*/
+	class Profiler;
+	
+	
 	/**
           \class    RandomGen
           \brief    A generator of random numberÒs.
@@ -35,6 +49,20 @@ namespace utils
 	class RandomGen;
 	
 	
+	/**
+          \class    RunningStatistics
+          \brief    The mean and the variance of a stream of values.
+	*/
+	class RunningStatistics;
+	
+	
+	/**
+          \class    SharedVector
+          \brief    An immutable vector, whose copies share the same data.
+	*/
+	template<typename T> class SharedVector;
+	
+	
 	/**
           \class    Thread
           \brief 	A C++ handler for pthreads.	
@@ -322,6 +350,37 @@ namespace utils
                          Z-test' with 95% confidence.
           */
           double getUnilateralPairedZThreshold95();
+          
+          
+          /**
+               \brief        Return the threshold value of 'Z' in a
+                             'bilateral Z-test' at level 'alpha'
+                             (i.e.: 'z' such that P(|Z| > z) = alpha).
+
+               \param[alpha  The level of the test (in ]0; 1[).
+
+               \return       The threshold value of 'Z'.
+          */
+          double getBilateralZThreshold(double alpha);
+          
+          
+          /**
+               \brief        Return the type I error spent at the
+                             information fraction 'tau' by a sequential
+                             test of overall level 'alpha', following the
+                             spending function of Lan & DeMets
+                             approximating O'Brien-Fleming boundaries:
+                                  alpha(tau) = 2 - 2 Phi(z_{alpha/2} /
+                                                         sqrt(tau))
+
+               \param[alpha  The overall level of the test (in ]0; 1[).
+               \param[tau    The information fraction (the number of
+                             observations over the maximal number of
+                             observations).
+
+               \return       The type I error spent at 'tau'.
+          */
+          double computeOBFAlphaSpending(double alpha, double tau);
 	}
 	
 	
@@ -343,32 +402,91 @@ namespace utils
 								Z_BEST_SPEED			(1)
 								Z_BEST_COMPRESSION		(9)
 								Z_DEFAULT_COMPRESSION	(-1)
+						
+						If 'nThreads' > 1, the string is cut into blocks
+						of 1 MB which are compressed independently by
+						'nThreads' threads (as pigz does), then
+						concatenated into a single zlib stream. The
+						stream is followed by an index of the blocks,
+						which allows 'decompressStr()' to decompress
+						them in parallel as well (zlib ignores the data
+						following the end of the stream).
 	
 						http://panthema.net/2007/0328-ZLibString.html	
 	
-			\param[str	The STL string to compress.
+			\param[str			The STL string to compress.
+			\param[compressionlevel	The compression level.
+			\param[nThreads		The number of threads to use.
 			
 			\return		The binary data.
 		*/
-		std::string compressStr(const std::string& str, int compressionlevel)
+		std::string compressStr(const std::string& str, int compressionlevel,
+		                        unsigned int nThreads = 1)
 										throw (std::runtime_error);
 		
 		
 		/**
 			\brief		Decompress an STL string using zlib and return
 						the original data.
+						
+						If the stream is followed by an index of its
+						blocks (see 'compressStr()'), the blocks are
+						decompressed by 'nThreads' threads.
 	
 						http://panthema.net/2007/0328-ZLibString.html
 			
-			\param[str	The binary data.
+			\param[str		The binary data.
+			\param[nThreads	The number of threads to use.
 			
 			\return		The original string.
 		*/
-		std::string decompressStr(const std::string& str)
+		std::string decompressStr(const std::string& str,
+		                          unsigned int nThreads = 1)
 										throw (std::runtime_error);
 	}
 	
 	
+	/**
+		\brief	This namespace gathers several functions related to
+				the hashing of raw data.
+	*/
+	namespace hashing
+	{
+	     // =================================================================
+		//	Functions
+		// =================================================================
+		/**
+			\brief		Compute the 64-bit FNV-1a hash of 'n' bytes
+						starting from 'data', and return its hexadecimal
+						representation (16 characters).
+						
+						Used to address data by their content (this is
+						not a cryptographic hash).
+			
+			\param[data	The first byte of the data to hash.
+			\param[n		The number of bytes to hash.
+			
+			\return		The hexadecimal representation of the hash.
+		*/
+		std::string computeHash(const char* data, size_t n);
+		
+		std::string computeHash(const std::string& str);
+		
+		
+		/**
+			\brief		Derive the seed of the 'index'-th element of a
+						sequence from 'seed' (SplitMix64 finalizer).
+						Close indexes lead to unrelated seeds.
+			
+			\param[seed	The seed of the sequence.
+			\param[index	The index of the element.
+			
+			\return		The seed of the 'index'-th element (> 0).
+		*/
+		unsigned int computeSeed(unsigned int seed, unsigned int index);
+	}
+	
+	
 	/**
 		\brief	This namespace gathers several functions consisting to
 				search specific elements inside an STL container of
@@ -427,6 +545,47 @@ namespace utils
 		std::vector<typename C::const_iterator> max(
 				const typename C::const_iterator begin,
 				const typename C::const_iterator end);
+		
+		
+		/**
+			\brief		Return the position (w.r.t. 'begin') of a maximal
+						element between 'begin' and 'end' ('end'
+						excluded), drawn uniformly among the maximal
+						elements.
+						
+						Equivalent to drawing an element of the list
+						returned by 'max()' with
+						'RandomGen::randIntRange_Uniform()' (the same
+						random number is consumed), without any
+						allocation. As for 'max()', a NaN is only
+						selected if it is the first element.
+						
+						Undefined behaviour if the range is empty.
+			
+			\param[begin	An iterator to the first element of the range
+						through which the search will be performed.
+			
+			\param[end	An iterator to the last element ('end' excluded)
+						of the range through which the search will be
+						performed.
+			
+			\return		The position of the selected maximal element.
+		*/
+		template<typename C>
+		unsigned int randMax(
+				const typename C::const_iterator begin,
+				const typename C::const_iterator end);
+		
+		
+		/**
+			\brief		Return an integer in [0; n[ drawn uniformly
+						(see 'randMax()').
+			
+			\param[n	The number of integers to draw from (> 0).
+			
+			\return		An integer in [0; n[.
+		*/
+		unsigned int drawIndex(unsigned int n);
 	}
 	
 	
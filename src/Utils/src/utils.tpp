@@ -141,3 +141,38 @@ std::vector<typename C::const_iterator>
 	
 	return maxList;
 }
+
+
+template<typename C>
+unsigned int utils::search::randMax(
+				const typename C::const_iterator begin,
+				const typename C::const_iterator end)
+{
+	assert(begin != end);
+	
+	
+	//	Find the maximal value, its first occurrence and its number of
+	//	occurrences ('begin' counts as the first maximum, so that a NaN
+	//	is handled as in 'max()': selected if first, ignored otherwise)
+	typename C::value_type maxValue = *begin;
+	typename C::const_iterator first = begin;
+	unsigned int nMax = 1;
+	
+	typename C::const_iterator it = begin;
+	for (++it; it != end; ++it)
+	{
+		if      (*it >  maxValue) { maxValue = *it; first = it; nMax = 1; }
+		else if (*it == maxValue) { ++nMax; }
+	}
+	
+	
+	//	Select one of them
+	unsigned int k = drawIndex(nMax);
+	if (k == 0) { return (first - begin); }
+	
+	it = first;
+	for (++it; it != end; ++it)
+		if ((*it == maxValue) && (--k == 0)) { return (it - begin); }
+	
+	return (first - begin);
+}
@@ -46,7 +46,8 @@ namespace xport
      */
      enum DblField
      {
-          OFFLINE_TIME, ONLINE_TIME, MEAN, LOWER_BOUND, UPPER_BOUND
+          OFFLINE_TIME, ONLINE_TIME, NB_SIMULATIONS, MEAN, LOWER_BOUND,
+          UPPER_BOUND, REGRET, REGRET_LOWER_BOUND, REGRET_UPPER_BOUND
      };
 
 
@@ -130,7 +131,9 @@ namespace xport
                     \brief    Constructor
                */
                AgentData() : agentLoaded(false), expLoaded(false),
-                             dsrList(std::vector<double>()) {}     
+                             nbSimulations(0.0),
+                             dsrList(std::vector<double>()),
+                             regretLoaded(false) {}     
                
                
                // ============================================================
@@ -184,6 +187,23 @@ namespace xport
                     onlineTime  = (exp->getTimeElapsed()
                                   / (double) exp->getNbOfMDPs());
 
+                    //   Mean over the simulations performed (0 if the
+                    //   agent does not plan)
+                    const std::vector<double>& nbSimList
+                              = exp->getNbSimulationsList();
+                    
+                    unsigned int nbPerformed = 0;
+                    nbSimulations = 0.0;
+                    for (unsigned int i = 0; i < nbSimList.size(); ++i)
+                    {
+                         if (nbSimList[i] > 0.0)
+                         {
+                              nbSimulations += nbSimList[i];
+                              ++nbPerformed;
+                         }
+                    }
+                    if (nbPerformed > 0) { nbSimulations /= nbPerformed; }
+
                     dsrList = exp->computeDSRList();
 
                     pair<double, double> CI95;
@@ -193,6 +213,23 @@ namespace xport
                     lowerBound = CI95.first;
                     upperBound = CI95.second;
                     
+                    //   Regret (only if the optimal values of the test MDPs
+                    //   are stored in the experiment)
+                    regretLoaded = !exp->getOptimalValueList().empty();
+                    if (regretLoaded)
+                    {
+                         std::vector<double> regretList =
+                                   exp->computeRegretList(
+                                             exp->getOptimalValueList());
+                         
+                         CI95 = utils::statistics::computeCI95<double>(
+                                   regretList);
+                         
+                         regret           = ((CI95.first + CI95.second) / 2.0);
+                         regretLowerBound = CI95.first;
+                         regretUpperBound = CI95.second;
+                    }
+                    
                     expLoaded = true;
                }
                
@@ -217,6 +254,17 @@ namespace xport
                bool isExperimentLoaded() const { return expLoaded; }
                
                
+               /**
+                    \brief    Return true if the regret of the agent is
+                              known (i.e. if the experiment stores the
+                              optimal values of its test MDPs), false else.
+
+                    \return   True if the regret of the agent is known, false
+                              else.
+               */
+               bool isRegretLoaded() const { return regretLoaded; }
+               
+               
                /**
                     \brief    Return the DSR list.
                     
@@ -309,9 +357,27 @@ namespace xport
                     {
                          case OFFLINE_TIME: return offlineTime;
                          case ONLINE_TIME:  return onlineTime;
+                         case NB_SIMULATIONS: return nbSimulations;
                          case MEAN:         return mean;
                          case LOWER_BOUND:  return lowerBound;
                          case UPPER_BOUND:  return upperBound;
+                         default:           break;
+                    }
+                    
+                    if (!regretLoaded)
+                    {
+                         string msg;
+                         msg += "The regret of this agent is unknown!";
+                         
+                         throw AgentDataException(msg);
+                    }
+                    
+                    switch (field)
+                    {
+                         case REGRET:             return regret;
+                         case REGRET_LOWER_BOUND: return regretLowerBound;
+                         case REGRET_UPPER_BOUND: return regretUpperBound;
+                         default:                 return 0.0;
                     }
                }
                
@@ -348,10 +414,17 @@ namespace xport
                               && expName == x.expName
                               && offlineTime == x.offlineTime
                               && onlineTime == x.onlineTime
+                              && nbSimulations == x.nbSimulations
                               && sameDSR
                               && mean == x.mean
                               && lowerBound == x.lowerBound
-                              && upperBound == x.upperBound);
+                              && upperBound == x.upperBound
+                              && regretLoaded == x.regretLoaded
+                              && (!regretLoaded
+                                   || (regret == x.regret
+                                   && regretLowerBound == x.regretLowerBound
+                                   && regretUpperBound
+                                        == x.regretUpperBound)));
                }
                
 
@@ -385,6 +458,13 @@ namespace xport
                double offlineTime, onlineTime;
 
 
+               /**
+                    \brief    The mean number of simulations per decision
+                              (see 'Experiment::getNbSimulationsList()').
+               */
+               double nbSimulations;
+
+
                /**
                     \brief    The list of discounted sum of rewards.
                */
@@ -401,6 +481,26 @@ namespace xport
                     \brief    The lower/upper bound on 'mean' (CI at 95%).
                */
                double lowerBound, upperBound;
+
+
+               /**
+                    \brief    True if the regret has been loaded (see
+                              'isRegretLoaded()'), false else.
+               */
+               bool regretLoaded;
+
+
+               /**
+                    \brief    The mean regret observed (see
+                              'Experiment::computeRegretList()').
+               */
+               double regret;
+
+
+               /**
+                    \brief    The lower/upper bound on 'regret' (CI at 95%).
+               */
+               double regretLowerBound, regretUpperBound;
      };
 
 
@@ -0,0 +1,891 @@
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DDS/DDSLib.h"
+#include "DDS/src/Agent/Guez/utils/guez_utils.h"
+#include "Utils/UtilsLib.h"
+
+using namespace std;
+using namespace dds;
+using namespace utils;
+using namespace utils::formula;
+
+
+// ===========================================================================
+/**
+	\brief	A command-line program timing the hot kernels of BBRL library
+			on the shipped distributions (GC, GDL and Grid), in order to
+			detect throughput regressions against a baseline.
+*/
+// ===========================================================================
+// ---------------------------------------------------------------------------
+//	Benchmark settings
+//	(the same as the ones of the experiments, see 'scripts/lua_scripts')
+// ---------------------------------------------------------------------------
+const double       GAMMA = 0.95;
+const unsigned int T     = 250;
+
+
+// ---------------------------------------------------------------------------
+//	Benchmarks
+// ---------------------------------------------------------------------------
+/**
+	\brief	An operation to time on a distribution.
+*/
+class Benchmark
+{
+	public:
+		Benchmark(string name_, const DirMultiDistribution* distrib_,
+		          bool macro_ = false) :
+				name(distrib_->getShortName() + "/" + name_),
+				distrib(distrib_), macro(macro_) {}
+
+		virtual ~Benchmark() {}
+
+
+		/**
+			\brief	Return the name of this Benchmark
+					(prefixed by the name of its distribution).
+		*/
+		string getName() const { return name; }
+
+
+		/**
+			\brief	Return true if this Benchmark times whole trajectories
+					(macro benchmark), false if it times a kernel.
+		*/
+		bool isMacro() const { return macro; }
+
+
+		/**
+			\brief	Perform 'n' operations.
+		*/
+		virtual void run(unsigned long n) = 0;
+
+
+	protected:
+		string name;
+		const DirMultiDistribution* distrib;
+		bool macro;
+
+
+		/**
+			\brief	Accumulates the results of the operations, so that
+					the compiler cannot discard them.
+		*/
+		static volatile double sink;
+};
+
+volatile double Benchmark::sink = 0.0;
+
+
+/**
+	\brief	Time 'MDP::perform()' (random actions).
+*/
+class PerformBench : public Benchmark
+{
+	public:
+		PerformBench(const DirMultiDistribution* distrib_) :
+				Benchmark("MDP::perform", distrib_), mdp(distrib_->draw()),
+				k(0)
+		{
+			mdp->reset();
+			for (unsigned int i = 0; i < 1024; ++i)
+			{
+				uList.push_back(RandomGen::randIntRange_Uniform(
+						0, (mdp->getNbActions() - 1)));
+			}
+		}
+
+		~PerformBench() { delete mdp; }
+
+		void run(unsigned long n)
+		{
+			unsigned int y;
+			double r, sum = 0.0;
+			for (unsigned long i = 0; i < n; ++i, k = ((k + 1) & 1023))
+			{
+				mdp->perform(uList[k], y, r);
+				sum += r;
+			}
+			sink += sum;
+		}
+
+	private:
+		MDP* mdp;
+		vector<unsigned int> uList;
+		unsigned int k;
+};
+
+
+/**
+	\brief	Time 'MDP::valueIteration()' or 'MDP::qIteration()'
+			(from scratch).
+*/
+class IterationBench : public Benchmark
+{
+	public:
+		IterationBench(const DirMultiDistribution* distrib_, bool q_) :
+				Benchmark((q_ ? "MDP::qIteration" : "MDP::valueIteration"),
+				          distrib_),
+				mdp(distrib_->draw()), q(q_) {}
+
+		~IterationBench() { delete mdp; }
+
+		void run(unsigned long n)
+		{
+			for (unsigned long i = 0; i < n; ++i)
+			{
+				if (q) { sink += mdp->qIteration(GAMMA, T)[0];     }
+				else   { sink += mdp->valueIteration(GAMMA, T)[0]; }
+			}
+		}
+
+	private:
+		MDP* mdp;
+		bool q;
+};
+
+
+/**
+	\brief	Time 'CModel::update()' followed by 'CModel::qIteration()'
+			(as done by 'EGreedyAgent::learnOnline()'), on transitions
+			observed on a MDP drawn from the distribution.
+			The model is reset every T transitions.
+*/
+class CModelBench : public Benchmark
+{
+	public:
+		CModelBench(const DirMultiDistribution* distrib_) :
+				Benchmark("CModel::update+qIteration", distrib_),
+				mdp(distrib_->draw()), cModel(0), t(0)
+		{
+			iniModel = new CModel(
+					distrib_->getShortName(),
+					distrib_->getNbStates(), distrib_->getNbActions(),
+					distrib_->getIniState(), distrib_->getTheta(),
+					distrib_->getRType(), distrib_->getR(),
+					distrib_->getV());
+		}
+
+		~CModelBench()
+		{
+			delete mdp;
+			delete iniModel;
+			if (cModel) { delete cModel; }
+		}
+
+		void run(unsigned long n)
+		{
+			for (unsigned long i = 0; i < n; ++i, t = ((t + 1) % T))
+			{
+				if (t == 0)
+				{
+					if (cModel) { delete cModel; }
+					cModel = iniModel->clone();
+					Q = cModel->qIteration(GAMMA, T);
+					mdp->reset();
+				}
+
+				unsigned int x = mdp->getCurrentState(), y;
+				unsigned int u = RandomGen::randIntRange_Uniform(
+						0, (mdp->getNbActions() - 1));
+				double r;
+				mdp->perform(u, y, r);
+
+				cModel->update(x, u, y, r);
+				Q = cModel->qIteration(GAMMA, T, Q);
+			}
+			sink += Q[0];
+		}
+
+	private:
+		MDP* mdp;
+		CModel* iniModel;
+		CModel* cModel;
+		vector<double> Q;
+		unsigned int t;
+};
+
+
+/**
+	\brief	Time 'DirMultiDistribution::draw()'.
+*/
+class DrawBench : public Benchmark
+{
+	public:
+		DrawBench(const DirMultiDistribution* distrib_) :
+				Benchmark("DirMultiDistribution::draw", distrib_) {}
+
+		void run(unsigned long n)
+		{
+			for (unsigned long i = 0; i < n; ++i)
+			{
+				MDP* mdp = distrib->draw();
+				sink += mdp->getNbStates();
+				delete mdp;
+			}
+		}
+};
+
+
+/**
+	\brief	Time 'guez_utils::sampleDirichlet()' on the parameters of
+			each <state, action> pair of the distribution (as done by
+			BAMCP samplers).
+*/
+class DirichletBench : public Benchmark
+{
+	public:
+		DirichletBench(const DirMultiDistribution* distrib_) :
+				Benchmark("guez_utils::sampleDirichlet", distrib_),
+				theta(distrib_->getTheta()),
+				probs(distrib_->getNbStates()), k(0) {}
+
+		void run(unsigned long n)
+		{
+			unsigned int nX  = distrib->getNbStates();
+			unsigned int nXU = (nX * distrib->getNbActions());
+			for (unsigned long i = 0; i < n; ++i, k = ((k + 1) % nXU))
+				guez_utils::sampleDirichlet(&probs[0], &theta[nX*k], nX, 0.0);
+
+			sink += probs[0];
+		}
+
+	private:
+		vector<double> theta;
+		vector<double> probs;
+		unsigned int k;
+};
+
+
+/**
+	\brief	Time 'Formula::operator()' on a formula of 3 variables
+			(fed with the Q-values of a MDP drawn from the distribution).
+*/
+class FormulaBench : public Benchmark
+{
+	public:
+		FormulaBench(const DirMultiDistribution* distrib_) :
+				Benchmark("Formula::operator()", distrib_),
+				f("X0 X1 SQRT X2 INV MUL2 ADD2"), k(0)
+		{
+			MDP* mdp = distrib_->draw();
+			vector<double> Q = mdp->qIteration(GAMMA, T);
+			delete mdp;
+
+			for (unsigned int i = 0; i < Q.size(); ++i)
+			{
+				vector<double> val(3);
+				val[0] = Q[i];
+				val[1] = (1.0 + RandomGen::rand01_Uniform());
+				val[2] = (1.0 + (i % 7));
+				valList.push_back(val);
+			}
+		}
+
+		void run(unsigned long n)
+		{
+			double sum = 0.0;
+			for (unsigned long i = 0; i < n; ++i, k = ((k + 1) % valList.size()))
+				sum += f(valList[k]);
+
+			sink += sum;
+		}
+
+	private:
+		Formula f;
+		vector<vector<double> > valList;
+		unsigned int k;
+};
+
+
+/**
+	\brief	Time 'fann_run()' on a network shaped as the ones of
+			'ANNAgent' (3 variables per action, 10 hidden neurons, one
+			output per action).
+*/
+class FANNBench : public Benchmark
+{
+	public:
+		FANNBench(const DirMultiDistribution* distrib_) :
+				Benchmark("fann_run", distrib_), k(0)
+		{
+			unsigned int nU = distrib_->getNbActions();
+			unsigned int layers[3] = { (3 * nU), 10, nU };
+			ann = fann_create_standard_array(3, layers);
+			fann_randomize_weights(ann, -0.1, 0.1);
+			fann_set_activation_function_hidden(ann, FANN_SIGMOID_SYMMETRIC);
+			fann_set_activation_function_output(ann, FANN_SIGMOID_SYMMETRIC);
+
+			for (unsigned int i = 0; i < (1024 * 3 * nU); ++i)
+				inputList.push_back(RandomGen::rand01_Uniform());
+		}
+
+		~FANNBench() { fann_destroy(ann); }
+
+		void run(unsigned long n)
+		{
+			unsigned int nbInputs = fann_get_num_input(ann);
+			double sum = 0.0;
+			for (unsigned long i = 0; i < n; ++i, k = ((k + 1) & 1023))
+				sum += fann_run(ann, &inputList[nbInputs*k])[0];
+
+			sink += sum;
+		}
+
+	private:
+		struct fann* ann;
+		vector<fann_type> inputList;
+		unsigned int k;
+};
+
+
+/**
+	\brief	Time the decisions of an Agent ('Agent::getAction()', followed
+			by 'Agent::learnOnline()'), along trajectories of T steps on a
+			MDP drawn from the distribution.
+			'agent' is freed.
+*/
+class DecisionBench : public Benchmark
+{
+	public:
+		DecisionBench(string name_, const DirMultiDistribution* distrib_,
+		              Agent* agent_) :
+				Benchmark(name_, distrib_), agent(agent_),
+				mdp(distrib_->draw()), t(0)
+		{
+			agent->learnOffline(distrib_);
+		}
+
+		~DecisionBench() { delete agent; delete mdp; }
+
+		void run(unsigned long n)
+		{
+			for (unsigned long i = 0; i < n; ++i, t = ((t + 1) % T))
+			{
+				if (t == 0)
+				{
+					mdp->reset();
+					agent->setMDP(mdp, GAMMA, T);
+				}
+
+				unsigned int x = mdp->getCurrentState(), y;
+				unsigned int u = agent->getAction(x);
+				double r;
+				mdp->perform(u, y, r);
+				agent->learnOnline(x, u, y, r);
+			}
+
+			agent->freeData();
+			t = 0;
+		}
+
+	private:
+		Agent* agent;
+		MDP* mdp;
+		unsigned int t;
+};
+
+
+/**
+	\brief	Time whole trajectories ('simulation::simulate()') of an Agent
+			on MDPs drawn from the distribution.
+			'agent' is freed.
+*/
+class TrajectoryBench : public Benchmark
+{
+	public:
+		TrajectoryBench(string name_, const DirMultiDistribution* distrib_,
+		                Agent* agent_) :
+				Benchmark(name_, distrib_, true), agent(agent_), k(0)
+		{
+			agent->learnOffline(distrib_);
+			for (unsigned int i = 0; i < 16; ++i)
+				mdpList.push_back(distrib_->draw());
+		}
+
+		~TrajectoryBench()
+		{
+			delete agent;
+			for (unsigned int i = 0; i < mdpList.size(); ++i)
+				delete mdpList[i];
+		}
+
+		void run(unsigned long n)
+		{
+			for (unsigned long i = 0; i < n; ++i, k = ((k + 1) % 16))
+			{
+				simulation::SimulationRecord simRec =
+						simulation::simulate(agent, mdpList[k], GAMMA, T);
+				sink += simRec.computeDSR();
+			}
+		}
+
+	private:
+		Agent* agent;
+		vector<MDP*> mdpList;
+		unsigned int k;
+};
+
+
+// ---------------------------------------------------------------------------
+//	Extra functions header (see below for documentation)
+// ---------------------------------------------------------------------------
+/**
+	\brief	The result of a Benchmark.
+*/
+struct Result
+{
+	string name;
+	bool macro;
+	unsigned long n;
+	double nsPerOp;
+	double nsPerOpMin;
+};
+
+vector<Benchmark*> getBenchmarks(const DirMultiDistribution* distrib);
+Result measure(Benchmark* benchmark, double minTime, unsigned int nbRep);
+string formatTime(double ns);
+void exportJSON(const vector<Result>& resultList, int seed, string file);
+map<string, double> importJSON(string file);
+bool compare(const vector<Result>& resultList,
+             const map<string, double>& baseline, double tolerance);
+string parsingErr(string);
+void help();
+
+
+// ---------------------------------------------------------------------------
+//	Main function
+// ---------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	//	Display help
+	if (parsing::hasFlag(argc, argv, "--help"))
+	{
+		help();
+		return 0;
+	}
+
+
+	//	Parsing
+	try
+	{
+		int seed = 1;
+		if (parsing::hasFlag(argc, argv, "--seed"))
+			seed = max(atoi(parsing::getValue(argc, argv, "--seed").c_str()), 0);
+		init(seed);
+
+		string distribDir = "data/distributions/";
+		if (parsing::hasFlag(argc, argv, "--distribution_dir"))
+		{
+			distribDir = parsing::getValue(argc, argv, "--distribution_dir");
+			distribDir += "/";
+		}
+
+		string filter;
+		if (parsing::hasFlag(argc, argv, "--filter"))
+			filter = parsing::getValue(argc, argv, "--filter");
+
+		double minTime = 100.0;
+		if (parsing::hasFlag(argc, argv, "--min_time"))
+			minTime = atof(parsing::getValue(argc, argv, "--min_time").c_str());
+
+		unsigned int nbRep = 5;
+		if (parsing::hasFlag(argc, argv, "--repetitions"))
+		{
+			nbRep = atoi(
+					parsing::getValue(argc, argv, "--repetitions").c_str());
+		}
+
+		string output;
+		if (parsing::hasFlag(argc, argv, "--output"))
+			output = parsing::getValue(argc, argv, "--output");
+
+		string baselineFile;
+		if (parsing::hasFlag(argc, argv, "--baseline"))
+			baselineFile = parsing::getValue(argc, argv, "--baseline");
+
+		double tolerance = 0.1;
+		if (parsing::hasFlag(argc, argv, "--tolerance"))
+		{
+			tolerance = atof(
+					parsing::getValue(argc, argv, "--tolerance").c_str());
+		}
+
+		if ((minTime <= 0.0) || (nbRep == 0) || (tolerance < 0.0))
+		{
+			cout << "\n" << parsingErr("Invalid benchmark settings!");
+			cout << "\n\n";
+			return -1;
+		}
+
+
+		//	Load the baseline
+		map<string, double> baseline;
+		if (!baselineFile.empty())
+		{
+			baseline = importJSON(baselineFile);
+			if (baseline.empty())
+			{
+				cout << "\n\tUnable to load the baseline \"";
+				cout << baselineFile << "\"!\n\n";
+				return -1;
+			}
+		}
+
+
+		//	Run the benchmarks on each distribution
+		const char* distribNameList[] = { "GC", "GDL", "Grid" };
+		vector<Result> resultList;
+
+		cout << "\n";
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			string file = (distribDir + distribNameList[i] + "-distrib.dat");
+			ifstream is(file.c_str());
+			if (is.fail())
+			{
+				cout << "\tUnable to open \"" << file << "\"!\n\n";
+				return -1;
+			}
+			DirMultiDistribution distrib(is);
+			is.close();
+
+
+			vector<Benchmark*> benchmarkList = getBenchmarks(&distrib);
+			for (unsigned int j = 0; j < benchmarkList.size(); ++j)
+			{
+				Benchmark* benchmark = benchmarkList[j];
+				if (benchmark->getName().find(filter) != string::npos)
+				{
+					cout << "\t" << left << setw(56) << benchmark->getName();
+					cout << flush;
+
+					Result result = measure(benchmark, minTime, nbRep);
+					resultList.push_back(result);
+
+					cout << right << setw(12) << formatTime(result.nsPerOp);
+					cout << "  (" << setprecision(4)
+					     << (1e9 / result.nsPerOp)
+					     << (result.macro ? " trajectories/s" : " op/s")
+					     << ")\n";
+				}
+				delete benchmark;
+			}
+		}
+		cout << "\n";
+
+
+		//	Export the results
+		if (!output.empty())
+		{
+			exportJSON(resultList, seed, output);
+			cout << "\tResults exported to \"" << output << "\"\n\n";
+		}
+
+
+		//	Compare to the baseline
+		//	(a regression leads to a non-zero exit status)
+		if (!baseline.empty() && !compare(resultList, baseline, tolerance))
+			return 1;
+	}
+
+	catch (parsing::ParsingException& e)
+	{
+		cout << "\n" << parsingErr(e.what()) << "\n\n";
+		return -1;
+	}
+
+	catch (exception& e)
+	{
+		cout << "\nexception: " << e.what() << "\n\n";
+		return -1;
+	}
+
+
+	//	Return
+	return 0;
+}
+
+
+// ---------------------------------------------------------------------------
+//	Extra functions implementation
+// ---------------------------------------------------------------------------
+/**
+	\brief			Return the Benchmarks to run on 'distrib'.
+
+	\param[distrib	The distribution.
+
+	\return			The Benchmarks to run on 'distrib' (to free).
+*/
+vector<Benchmark*> getBenchmarks(const DirMultiDistribution* distrib)
+{
+	vector<Benchmark*> benchmarkList;
+
+
+	//	Kernels
+	benchmarkList.push_back(new PerformBench(distrib));
+	benchmarkList.push_back(new IterationBench(distrib, false));
+	benchmarkList.push_back(new IterationBench(distrib, true));
+	benchmarkList.push_back(new CModelBench(distrib));
+	benchmarkList.push_back(new DrawBench(distrib));
+	benchmarkList.push_back(new DirichletBench(distrib));
+	benchmarkList.push_back(new FormulaBench(distrib));
+	benchmarkList.push_back(new FANNBench(distrib));
+
+	const unsigned int KList[] = { 10, 100, 1000 };
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		stringstream sstr;
+		sstr << "(K = " << KList[i] << ")";
+
+		benchmarkList.push_back(new DecisionBench(
+				"BAMCP decision " + sstr.str(), distrib,
+				new BAMCPAgent(KList[i])));
+	}
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		stringstream sstr;
+		sstr << "(K = " << KList[i] << ", C = 5, depth = 15)";
+
+		benchmarkList.push_back(new DecisionBench(
+				"BFS3 decision " + sstr.str(), distrib,
+				new BFS3Agent(KList[i], 5, 15)));
+	}
+
+
+	//	Trajectories
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/RandomAgent", distrib, new RandomAgent()));
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/EGreedyAgent (0.1)", distrib,
+			new EGreedyAgent(0.1)));
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/SoftMaxAgent (0.2)", distrib,
+			new SoftMaxAgent(0.2)));
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/VDBEEGreedyAgent (2.0, 0.25, 1.0)", distrib,
+			new VDBEEGreedyAgent(2.0, 0.25, 1.0)));
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/BEBAgent (1.0)", distrib, new BEBAgent(1.0)));
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/BAMCPAgent (10)", distrib, new BAMCPAgent(10)));
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/BFS3Agent (10, 5, 15)", distrib,
+			new BFS3Agent(10, 5, 15)));
+	benchmarkList.push_back(new TrajectoryBench(
+			"trajectory/SBOSSAgent (1.0, 9.0)", distrib,
+			new SBOSSAgent(1.0, 9.0)));
+
+
+	//	Return
+	return benchmarkList;
+}
+
+
+/**
+	\brief			Run 'benchmark' and return its result.
+					The number of operations per repetition is doubled until
+					a repetition lasts 'minTime' ms at least.
+
+	\param[benchmark	The Benchmark to run.
+	\param[minTime		The minimal duration of a repetition (in ms).
+	\param[nbRep		The number of repetitions.
+
+	\return			The result of 'benchmark' (the median and the minimum
+					over the repetitions).
+*/
+Result measure(Benchmark* benchmark, double minTime, unsigned int nbRep)
+{
+	//	Calibration (also warms up the caches)
+	unsigned long n = 1;
+	double start = Profiler::now();
+	benchmark->run(n);
+	double time = (Profiler::now() - start);
+
+	while (time < minTime)
+	{
+		n *= 2;
+		start = Profiler::now();
+		benchmark->run(n);
+		time = (Profiler::now() - start);
+	}
+
+
+	//	Repetitions
+	vector<double> nsPerOpList;
+	for (unsigned int i = 0; i < nbRep; ++i)
+	{
+		start = Profiler::now();
+		benchmark->run(n);
+		nsPerOpList.push_back(1e6 * (Profiler::now() - start) / n);
+	}
+	sort(nsPerOpList.begin(), nsPerOpList.end());
+
+
+	//	Return
+	Result result;
+	result.name       = benchmark->getName();
+	result.macro      = benchmark->isMacro();
+	result.n          = n;
+	result.nsPerOp    = nsPerOpList[nsPerOpList.size() / 2];
+	result.nsPerOpMin = nsPerOpList[0];
+
+	return result;
+}
+
+
+/**
+	\brief		Return 'ns' formatted in a readable unit.
+
+	\param[ns	A duration (in ns).
+
+	\return		'ns' formatted in a readable unit.
+*/
+string formatTime(double ns)
+{
+	stringstream sstr;
+	sstr << fixed << setprecision(2);
+
+	if      (ns < 1e3) { sstr << ns << " ns";         }
+	else if (ns < 1e6) { sstr << (ns / 1e3) << " us"; }
+	else if (ns < 1e9) { sstr << (ns / 1e6) << " ms"; }
+	else               { sstr << (ns / 1e9) << " s";  }
+
+	return sstr.str();
+}
+
+
+/**
+	\brief			Export 'resultList' in JSON format
+					(one benchmark per line, see 'importJSON()').
+
+	\param[resultList	The results to export.
+	\param[seed		The seed used.
+	\param[file		The output file.
+*/
+void exportJSON(const vector<Result>& resultList, int seed, string file)
+{
+	ofstream os(file.c_str());
+	os << setprecision(17);
+
+	os << "{\n";
+	os << "\t\"seed\": " << seed << ",\n";
+	os << "\t\"benchmarks\":\n";
+	os << "\t[\n";
+	for (unsigned int i = 0; i < resultList.size(); ++i)
+	{
+		const Result& r = resultList[i];
+
+		os << "\t\t{ \"name\": \"" << r.name << "\", ";
+		os << "\"kind\": \"" << (r.macro ? "macro" : "micro") << "\", ";
+		os << "\"iterations\": " << r.n << ", ";
+		os << "\"ns_per_op\": " << r.nsPerOp << ", ";
+		os << "\"ns_per_op_min\": " << r.nsPerOpMin << ", ";
+		os << "\"ops_per_s\": " << (1e9 / r.nsPerOp) << " }";
+		os << ((i < (resultList.size() - 1)) ? ",\n" : "\n");
+	}
+	os << "\t]\n";
+	os << "}\n";
+
+	os.close();
+}
+
+
+/**
+	\brief		Load the median time per operation of each benchmark of a
+				file created by 'exportJSON()'.
+
+	\param[file	The file to load.
+
+	\return		The median time per operation (in ns) of each benchmark,
+				indexed by name (empty if the file cannot be read).
+*/
+map<string, double> importJSON(string file)
+{
+	map<string, double> baseline;
+
+	ifstream is(file.c_str());
+	string line;
+	while (getline(is, line))
+	{
+		size_t i = line.find("\"name\": \"");
+		size_t j = line.find("\"ns_per_op\": ");
+		if ((i == string::npos) || (j == string::npos)) { continue; }
+
+		i += 9;
+		string name = line.substr(i, line.find('"', i) - i);
+		baseline[name] = atof(line.c_str() + j + 13);
+	}
+
+	return baseline;
+}
+
+
+/**
+	\brief			Compare 'resultList' to 'baseline', and print out the
+					relative changes.
+
+	\param[resultList	The results to compare.
+	\param[baseline	The median time per operation (in ns) of each
+					benchmark of the baseline.
+	\param[tolerance	The relative slowdown tolerated.
+
+	\return			False if at least one benchmark is slower than its
+					baseline by more than 'tolerance', true else.
+*/
+bool compare(const vector<Result>& resultList,
+             const map<string, double>& baseline, double tolerance)
+{
+	unsigned int nbRegressions = 0;
+
+	cout << "\tComparison to the baseline (tolerance: ";
+	cout << (100.0 * tolerance) << "%)\n";
+	for (unsigned int i = 0; i < resultList.size(); ++i)
+	{
+		map<string, double>::const_iterator it =
+				baseline.find(resultList[i].name);
+		if (it == baseline.end()) { continue; }
+
+		double change = ((resultList[i].nsPerOp / it->second) - 1.0);
+
+		cout << "\t\t" << left << setw(56) << resultList[i].name << right;
+		cout << setw(10) << fixed << setprecision(1) << (100.0 * change);
+		cout << "%";
+		cout.unsetf(ios_base::floatfield);
+
+		if (change > tolerance)
+		{
+			cout << "  REGRESSION";
+			++nbRegressions;
+		}
+		else if (change < -tolerance) { cout << "  improvement"; }
+		cout << "\n";
+	}
+
+	cout << "\n\t" << nbRegressions << " regression(s) found.\n\n";
+
+	return (nbRegressions == 0);
+}
+
+
+string parsingErr(string msg)
+{
+	return ("[parsing error]:\t" + msg);
+}
+
+
+void help()
+{
+	ifstream is("doc/command-line manual (BBRL-bench).txt");
+	string line;
+	cout << "\n";
+	while (!is.eof()) { getline(is, line); cout << line << "\n"; }
+}
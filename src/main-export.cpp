@@ -63,6 +63,15 @@ int main(int argc, char* argv[])
      bool noPdf = parsing::hasFlag(argc, argv, "--no-pdf");
      
      
+     //   Retrieve the directory of the test-set store (if any)
+     try
+     {
+          Experiment::addTestSetStoreDir(
+               parsing::getValue(argc, argv, "--test_set_store"));
+     }
+     catch (parsing::ParsingException& e) {}
+     
+     
      //   Create a folder for the generated files
      string folderStr;
      if (!prefixStr.empty()) { folderStr = prefixStr; }
@@ -319,6 +328,224 @@ int main(int argc, char* argv[])
      }
 
 
+     //   ONLINE/REGRET graph -------------------------------------------------
+     xField = ONLINE_TIME;
+     yField = REGRET;
+     fontSize = 12;
+     xLabel = "Online computation cost (in ms)";
+     yLabel = "Mean regret";
+
+     output = ("data/export/" + folderStr);
+     if (!prefixStr.empty()) { output += (prefixStr + "-"); }
+     output += "graph-regret";
+     if (!suffixStr.empty()) { output += ("-" + suffixStr); }
+     
+     //   For each experiment, create a graph
+     for (unsigned int i = 0; i < expStrList.size(); ++i)
+     {
+          double T = 250.0;
+          xCoeff = (1.0 / T);
+          string expName = expStrList[i];
+
+
+          //   Apply a filter to get the data related to the current
+          //   experiment (only the agents whose regret is known)
+          vector<unsigned int> c;
+          vector<unsigned int> cExp = filter(db, EXP_NAME, STR_EQUAL, expName);
+          for (unsigned int j = 0; j < cExp.size(); ++j)
+               if (db[cExp[j]].isRegretLoaded()) { c.push_back(cExp[j]); }
+          if (c.empty()) { continue; }
+
+
+          //   Retrieve the maximal 'x' value
+          double xMax = xCoeff * db[getMax(c, db, xField)].getField(xField);
+
+
+          //   Retrieve the minimal and maximal 'y' values
+          double yMin = db[getMin(c, db, yField)].getField(yField);
+          double yMax = db[getMax(c, db, yField)].getField(yField);
+
+
+          //   For each type of agent, create a curve
+          vector<string> classStrList = getList(c, db, CLASS_NAME);
+          vector<vector<pair<double, double> > > data, bounds;
+          for (unsigned int j = 0; j < classStrList.size(); ++j)
+          {
+               string className = classStrList[j];
+
+
+               //   Apply a filter to get the data related to the current
+               //   type of agent
+               vector<unsigned int> cc =
+                         filter(c, db, CLASS_NAME, STR_EQUAL, className);
+
+
+               //   For each sample, create a point
+               vector<pair<double, double> > dataV;
+               vector<unsigned int> sortedList = sort(cc, db, xField);
+
+               for (unsigned int k = 0; k < sortedList.size(); ++k)
+               {
+                    double x = db[sortedList[k]].getField(xField) * xCoeff;
+                    double y = db[sortedList[k]].getField(yField);
+                    dataV.push_back(pair<double, double>(x, y));
+               }
+               
+                              
+               //   Add the data points associated to this type of agent
+               //   to the list
+               data.push_back(dataV);
+          }
+          
+          
+          //   Create the graph
+          GnuplotOptions opt(fontSize);
+          
+               //   Add grid
+          opt.setOption("grid", "lc \"#ED000000\"");
+          
+               //   Set a palette
+          opt.setOption("palette",
+                         "defined ( 0 \"green\", 1 \"blue\", 2 \"red\","
+                         " 3 \"orange\" ) ");
+          opt.unsetOption("colorbox");
+          
+               //   Set 'with'
+          opt.setWith("points");
+          
+               //   Change y range to ensure that legend is not
+               //   overlapping the graph
+          unsigned int n = (classStrList.size() + 1);
+          double lW = (0.03 * (fontSize / 12.0));
+          yMin -= (lW*n * (yMax - yMin))/(1.0 - lW*n);      
+          
+          stringstream sstr;
+          sstr << "[" << yMin << ":" << yMax + 0.05*(yMax-yMin) << "]";          
+          opt.setOption("yrange", sstr.str());
+          opt.setOption("title", "\"" + expName + "\"");
+          opt.setOption("xlabel", "\"" + xLabel + "\"");
+          opt.setOption("ylabel", "\"" + yLabel + "\"");
+          opt.setOption("logscale", "x");
+          
+          sstr.str(string());
+          double x0 = pow(10, log(xMax) - pow(10, 8));
+          double x1 = pow(10, log(xMax) + 1);
+          sstr << x0 << ",100," << x1;
+          opt.setOption("xtics",  sstr.str());
+          opt.setOption("format", "x \"%.e\"");
+          opt.setOption("size", "0.75,0.75");
+
+          
+               //   Plot
+          sstr.clear(); sstr.str(string());
+          sstr << "\'" << output << "-" << i << ".eps\'";
+          opt.setOption("output", sstr.str());
+          plot(opt, data, classStrList, bounds);
+     }
+
+
+     //   SIMULATIONS/SCORE graph ---------------------------------------------
+     xField = NB_SIMULATIONS;
+     yField = MEAN;
+     fontSize = 12;
+     xLabel = "Mean number of simulations (per decision)";
+     yLabel = "Mean score";
+
+     output = ("data/export/" + folderStr);
+     if (!prefixStr.empty()) { output += (prefixStr + "-"); }
+     output += "graph-simulations";
+     if (!suffixStr.empty()) { output += ("-" + suffixStr); }
+     
+     //   For each experiment, create a graph
+     for (unsigned int i = 0; i < expStrList.size(); ++i)
+     {
+          string expName = expStrList[i];
+
+
+          //   Apply a filter to get the data related to the current
+          //   experiment (only the agents which plan)
+          vector<unsigned int> c = filter(db, EXP_NAME, STR_EQUAL, expName);
+          c = filter(c, db, xField, DBL_ABOVE, 0.0);
+          if (c.empty()) { continue; }
+
+
+          //   Retrieve the minimal and maximal 'y' values
+          double yMin = db[getMin(c, db, yField)].getField(yField);
+          double yMax = db[getMax(c, db, yField)].getField(yField);
+
+
+          //   For each type of agent, create a curve
+          vector<string> classStrList = getList(c, db, CLASS_NAME);
+          vector<vector<pair<double, double> > > data, bounds;
+          for (unsigned int j = 0; j < classStrList.size(); ++j)
+          {
+               string className = classStrList[j];
+
+
+               //   Apply a filter to get the data related to the current
+               //   type of agent
+               vector<unsigned int> cc =
+                         filter(c, db, CLASS_NAME, STR_EQUAL, className);
+
+
+               //   For each sample, create a point
+               vector<pair<double, double> > dataV;
+               vector<unsigned int> sortedList = sort(cc, db, xField);
+
+               for (unsigned int k = 0; k < sortedList.size(); ++k)
+               {
+                    double x = db[sortedList[k]].getField(xField);
+                    double y = db[sortedList[k]].getField(yField);
+                    dataV.push_back(pair<double, double>(x, y));
+               }
+               
+                              
+               //   Add the data points associated to this type of agent
+               //   to the list
+               data.push_back(dataV);
+          }
+          
+          
+          //   Create the graph
+          GnuplotOptions opt(fontSize);
+          
+               //   Add grid
+          opt.setOption("grid", "lc \"#ED000000\"");
+          
+               //   Set a palette
+          opt.setOption("palette",
+                         "defined ( 0 \"green\", 1 \"blue\", 2 \"red\","
+                         " 3 \"orange\" ) ");
+          opt.unsetOption("colorbox");
+          
+               //   Set 'with'
+          opt.setWith("points");
+          
+               //   Change y range to ensure that legend is not
+               //   overlapping the graph
+          unsigned int n = (classStrList.size() + 1);
+          double lW = (0.03 * (fontSize / 12.0));
+          yMin -= (lW*n * (yMax - yMin))/(1.0 - lW*n);      
+          
+          stringstream sstr;
+          sstr << "[" << yMin << ":" << yMax + 0.05*(yMax-yMin) << "]";          
+          opt.setOption("yrange", sstr.str());
+          opt.setOption("title", "\"" + expName + "\"");
+          opt.setOption("xlabel", "\"" + xLabel + "\"");
+          opt.setOption("ylabel", "\"" + yLabel + "\"");
+          opt.setOption("logscale", "x");
+          opt.setOption("format", "x \"%.e\"");
+          opt.setOption("size", "0.75,0.75");
+
+          
+               //   Plot
+          sstr.clear(); sstr.str(string());
+          sstr << "\'" << output << "-" << i << ".eps\'";
+          opt.setOption("output", sstr.str());
+          plot(opt, data, classStrList, bounds);
+     }
+
+
      //   ONLINE/OFFLINE graph ------------------------------------------------
      xField = ONLINE_TIME;
      yField = OFFLINE_TIME;
@@ -535,6 +762,12 @@ int main(int argc, char* argv[])
           }
 
           
+          //   Check if the regret of some agents is known
+          bool hasRegret = false;
+          for (unsigned int j = 0; j < c.size(); ++j)
+               if (db[c[j]].isRegretLoaded()) { hasRegret = true; break; }
+
+          
           //   Create the table
           vector<vector<Cell*> > grid;
 
@@ -544,6 +777,7 @@ int main(int argc, char* argv[])
           firstLine.push_back(new StrCell("Offline time"));
           firstLine.push_back(new StrCell("Mean online time (per decision)"));
           firstLine.push_back(new StrCell("Score"));
+          if (hasRegret) { firstLine.push_back(new StrCell("Regret")); }
           grid.push_back(firstLine);
           
                //   For each agent, add an entry
@@ -561,6 +795,14 @@ int main(int argc, char* argv[])
                double upperBound = agentData.getField(UPPER_BOUND);
                line.push_back(new NumberIntervalCell(lowerBound, upperBound));
                
+               if (hasRegret && agentData.isRegretLoaded())
+               {
+                    line.push_back(new NumberIntervalCell(
+                              agentData.getField(REGRET_LOWER_BOUND),
+                              agentData.getField(REGRET_UPPER_BOUND)));
+               }
+               else if (hasRegret) { line.push_back(new StrCell("-")); }
+               
                for (unsigned int k = 0; k < bestNameList.size(); ++k)
                {
                     string cName = agentData.getField(NAME);
@@ -587,6 +829,7 @@ int main(int argc, char* argv[])
           vLines[1] = 1;
           vLines[2] = 1;
           vLines[3] = 1;
+          if (hasRegret) { vLines[4] = 1; }
           
                //   Make the table
           stringstream sstr;
@@ -663,6 +906,20 @@ void generateReport(string folderStr,
           if (!suffixStr.empty()) { onGraph << "-" << suffixStr; }
           onGraph << "-" << i;
 
+          stringstream regretGraph;
+          regretGraph << folderStr;
+          if (!prefixStr.empty()) { regretGraph << prefixStr << "-"; }
+          regretGraph << "graph-regret";
+          if (!suffixStr.empty()) { regretGraph << "-" << suffixStr; }
+          regretGraph << "-" << i;
+
+          stringstream simGraph;
+          simGraph << folderStr;
+          if (!prefixStr.empty()) { simGraph << prefixStr << "-"; }
+          simGraph << "graph-simulations";
+          if (!suffixStr.empty()) { simGraph << "-" << suffixStr; }
+          simGraph << "-" << i;
+
           stringstream onOffGraph;
           onOffGraph << folderStr;
           if (!prefixStr.empty()) { onOffGraph << prefixStr << "-"; }
@@ -690,6 +947,31 @@ void generateReport(string folderStr,
           file << "\t\\caption{Online computation cost Vs. Performance}\n";
           file << "\\end{figure}\n";
           file << "\n";
+          
+          //   (only generated if the regret of some agents is known)
+          ifstream regretGraphFile(
+                    ("data/export/" + regretGraph.str() + ".eps").c_str());
+          if (regretGraphFile.good())
+          {
+               file << "\\begin{figure}[!ht]\n";
+               file << "\t\\centering\\includegraphics[scale=1.5]{" << regretGraph.str() << "}\n";
+               file << "\t\\caption{Online computation cost Vs. Regret}\n";
+               file << "\\end{figure}\n";
+               file << "\n";
+          }
+          
+          //   (only generated if some agents report their simulations)
+          ifstream simGraphFile(
+                    ("data/export/" + simGraph.str() + ".eps").c_str());
+          if (simGraphFile.good())
+          {
+               file << "\\begin{figure}[!ht]\n";
+               file << "\t\\centering\\includegraphics[scale=1.5]{" << simGraph.str() << "}\n";
+               file << "\t\\caption{Number of simulations Vs. Performance}\n";
+               file << "\\end{figure}\n";
+               file << "\n";
+          }
+          
           file << "\\begin{figure}[!ht]\n";
           file << "\t\\centering\\includegraphics[scale=1.5]{" << onOffGraph.str() << "}\n";
           file << "\t\\caption{Best algorithms w.r.t offline/online time periods}\n";
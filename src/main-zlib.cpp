@@ -23,6 +23,7 @@ using namespace utils::compression;
 //	Extra functions header (see below for documentation)
 // ---------------------------------------------------------------------------
 string parsingErr(string);
+unsigned int parseThreads(int& argc, char* argv[]);
 void help();
 
 
@@ -45,6 +46,20 @@ int main(int argc, char *argv[])
 	
 	
 	string mode(argv[1]);
+
+
+	//	'nThreads' (optional, may appear anywhere after the mode)
+	unsigned int nThreads = parseThreads(argc, argv);
+	if (nThreads == 0)
+	{
+		string msg;
+		msg += "'--threads'/'-t' must be followed by a positive integer!";
+		cout << parsingErr(msg) << "\n";
+		
+		return -1;
+	}
+
+
 	if (mode == "--help") { help(); }
 
 	else if ((mode == "--compress") || (mode == "-z"))
@@ -111,7 +126,7 @@ int main(int argc, char *argv[])
 		Chrono compressTime;
 		cout << "\tCompress the data and save them into a file..." << flush;
 		ofstream os(output.c_str());
-		os << compressStr(dStr, compressionLevel);
+		os << compressStr(dStr, compressionLevel, nThreads);
 		os.close();
 		cout << "done! (in " << compressTime.get() << "ms)\n\n";
 			
@@ -155,7 +170,7 @@ int main(int argc, char *argv[])
 		cout << "\tDecompress the data and save them into a file...";
 		cout << flush;
 		ofstream os(output.c_str());
-		os << decompressStr(cStr);
+		os << decompressStr(cStr, nThreads);
 		os.close();
 		cout << "done! (in " << decompressTime.get() << "ms)\n\n";
 			
@@ -180,6 +195,32 @@ string parsingErr(string msg)
 }
 
 
+unsigned int parseThreads(int& argc, char* argv[])
+{
+	unsigned int nThreads = 1;
+	for (int i = 2; i < argc; ++i)
+	{
+		string arg(argv[i]);
+		if ((arg != "--threads") && (arg != "-t")) { continue; }
+		
+		if ((i + 1) >= argc) { return 0; }
+		
+		int n = atoi(argv[i + 1]);
+		if (n <= 0) { return 0; }
+		nThreads = n;
+		
+		
+		//	Remove the two tokens, so that the other arguments keep
+		//	their positions
+		for (int j = i; (j + 2) < argc; ++j) { argv[j] = argv[j + 2]; }
+		argc -= 2;
+		--i;
+	}
+	
+	return nThreads;
+}
+
+
 void help()
 {
 	ifstream is("doc/command-line manual (BBRL-zlib).txt");
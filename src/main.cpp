@@ -2,8 +2,10 @@
 #include <assert.h>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "DDS/DDSLib.h"
 #include "Utils/UtilsLib.h"
@@ -33,18 +35,36 @@ inline bool fileExists(const std::string& name)
      return (stat (name.c_str(), &buffer) == 0);
 }
 
+Experiment* parseExperimentFile(char* argv0, const std::string& file)
+                                        throw (parsing::ParsingException);
+void writeAtomically(const std::string& file, const std::string& data);
+void exportExperiment(Experiment* experiment, std::string file,
+                      bool compressOutput, int compressionLevel,
+                      unsigned int nThreads = 1);
+void exportMetrics(const std::vector<Experiment*>& expList,
+                   const std::vector<Agent*>& agentList,
+                   const std::vector<std::string>& outputList,
+                   std::string file);
+
 void offlineLearning(int argc, char* argv[]) throw (AgentException,
                                                     MDPException,
                                                     parsing::ParsingException);
-void newExperiment(int argc, char* argv[])   throw (parsing::ParsingException);
+void newExperiment(int argc, char* argv[])   throw (SerializableException,
+                                                    parsing::ParsingException);
 void runExperiment(int argc, char* argv[])   throw (AgentException,
+                                                    MDPException,
+                                                    ExperimentException,
+                                                    parsing::ParsingException);
+void runExperiments(int argc, char* argv[])  throw (AgentException,
                                                     MDPException,
                                                     parsing::ParsingException);
+void mergeExperiments(int argc, char* argv[]) throw (ExperimentException,
+                                                     parsing::ParsingException);
 
 void mdpDistribGen(int argc, char* argv[]) throw (MDPException,
                                                   parsing::ParsingException);
 void formulaSetGen(int argc, char* argv[]) throw (parsing::ParsingException);
-void slSamplesGen(int argc, char* argv[])  throw (bad_cast,
+void slSamplesGen(int argc, char* argv[])  throw (bad_cast, AgentException,
                                                   parsing::ParsingException);
 void newAgentFactory(int argc, char* argv[]) throw (SerializableException,
                                                     parsing::ParsingException);
@@ -78,6 +98,12 @@ int main(int argc, char* argv[])
      bool modeIsRunExperiment =
           parsing::hasFlag(argc, argv, "--run_experiment");
 
+     bool modeIsRunExperiments =
+          parsing::hasFlag(argc, argv, "--run_experiments");
+
+     bool modeIsMergeExperiments =
+          parsing::hasFlag(argc, argv, "--merge_experiments");
+
      bool modeIsMDPDistribGen =
           parsing::hasFlag(argc, argv, "--mdp_distrib_generation");
           
@@ -97,9 +123,19 @@ int main(int argc, char* argv[])
 	    //   2.   Launch the selected mode
      try
      {
+          //   Directory of the test-set store, searched for the test sets
+          //   referenced by the experiments to load (if specified)
+          if (parsing::hasFlag(argc, argv, "--test_set_store"))
+          {
+               Experiment::addTestSetStoreDir(
+                    parsing::getValue(argc, argv, "--test_set_store"));
+          }
+          
           if      (modeIsOfflineLearning) { offlineLearning(argc, argv);   }
           else if (modeIsNewExperiment)   { newExperiment(argc, argv);     }
           else if (modeIsRunExperiment)   { runExperiment(argc, argv);     }
+          else if (modeIsRunExperiments)  { runExperiments(argc, argv);    }
+          else if (modeIsMergeExperiments){ mergeExperiments(argc, argv);  }
           else if (modeIsMDPDistribGen)   { mdpDistribGen(argc, argv);     }
           else if (modeIsFormulaSetGen)   { formulaSetGen(argc, argv);     }
           else if (modeIsSLSamplesGen)    { slSamplesGen(argc, argv);      }
@@ -120,6 +156,12 @@ int main(int argc, char* argv[])
           cout << "\n\n";
      }
      
+     catch (ExperimentException& e)
+     {
+          cout << "\nexperiment exception: " << e.what();
+          cout << "\n\n";
+     }
+     
      catch (parsing::ParsingException& e)
      {
           cout << "\nparsing exception: " << e.what();
@@ -137,6 +179,233 @@ int main(int argc, char* argv[])
 // ---------------------------------------------------------------------------
 //	Extra functions implementation
 // ---------------------------------------------------------------------------
+Experiment* parseExperimentFile(char* argv0, const string& file)
+                                        throw (parsing::ParsingException)
+{
+     //   Parsed as '--experiment --experiment_file <file>' (see
+     //   'Experiment::parse()'), so that compressed files are supported
+     int argcBis = 4;
+     char* argvBis[4];
+     string strList[3] = { "--experiment", "--experiment_file", file };
+     
+     argvBis[0] = argv0;
+     for (unsigned int i = 0; i < 3; ++i)
+     {
+          argvBis[i + 1] = new char[strList[i].size() + 1];
+          std::copy(strList[i].begin(), strList[i].end(), argvBis[i + 1]);
+          argvBis[i + 1][strList[i].size()] = '\0';
+     }
+     
+     Experiment* experiment = 0;
+     try { experiment = Experiment::parse(argcBis, argvBis); }
+     catch (parsing::ParsingException&)
+     {
+          for (unsigned int i = 1; i < 4; ++i) { delete[] argvBis[i]; }
+          throw;
+     }
+     
+     for (unsigned int i = 1; i < 4; ++i) { delete[] argvBis[i]; }
+     
+     return experiment;
+}
+
+
+void writeAtomically(const string& file, const string& data)
+{
+     //   Written under a temporary file name (unique to this process and
+     //   this call, without consuming the global RNG), then renamed, so
+     //   that 'file' is never seen partially written
+     static unsigned int counter = 0;
+     
+     stringstream tmpStr;
+     tmpStr << file << ".tmp." << getpid() << ".";
+     tmpStr << __sync_fetch_and_add(&counter, 1);
+     
+     ofstream os(tmpStr.str().c_str());
+     os.write(data.data(), data.size());
+     os.close();
+     
+     if (os.fail()) { remove(tmpStr.str().c_str()); return; }
+     
+     rename(tmpStr.str().c_str(), file.c_str());
+}
+
+
+void exportExperiment(Experiment* experiment, string file,
+                      bool compressOutput, int compressionLevel,
+                      unsigned int nThreads)
+{
+     stringstream sstr;
+     if (compressOutput)
+          experiment->zSerialize(sstr, compressionLevel, nThreads);
+     else
+          experiment->serialize(sstr);
+     
+     writeAtomically((file + (compressOutput ? ".zz" : "")), sstr.str());
+}
+
+
+void exportMetrics(const vector<Experiment*>& expList,
+                   const vector<Agent*>& agentList,
+                   const vector<string>& outputList, string file)
+{
+     //   Snapshot of the metrics, and labels of each Experiment
+     //   (Prometheus text format)
+     vector<Experiment::Metrics> metricsList;
+     vector<string> labelList;
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          metricsList.push_back(expList[k]->getMetrics());
+          
+          string values[3] = { expList[k]->getName(),
+                               agentList[k]->getClassName(), outputList[k] };
+          for (unsigned int l = 0; l < 3; ++l)
+          {
+               string escaped;
+               for (unsigned int c = 0; c < values[l].size(); ++c)
+               {
+                    if      (values[l][c] == '\n') { escaped += "\\n"; }
+                    else if ((values[l][c] == '\\') || (values[l][c] == '"'))
+                    {
+                         escaped += '\\';
+                         escaped += values[l][c];
+                    }
+                    else { escaped += values[l][c]; }
+               }
+               values[l] = escaped;
+          }
+          
+          labelList.push_back("experiment=\"" + values[0] + "\",agent=\""
+                              + values[1] + "\",output=\"" + values[2]
+                              + "\"");
+     }
+     
+     
+     //   Written atomically (see 'writeAtomically()')
+     stringstream os;
+     os.precision(numeric_limits<double>::digits10);
+     
+     
+     //   Progress and times
+     os << "# HELP bbrl_progress Fraction of the simulations performed.\n";
+     os << "# TYPE bbrl_progress gauge\n";
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          os << "bbrl_progress{" << labelList[k] << "} ";
+          os << expList[k]->getProgress() << "\n";
+     }
+     
+     os << "# HELP bbrl_time_elapsed_ms Time spent in the simulations.\n";
+     os << "# TYPE bbrl_time_elapsed_ms counter\n";
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          os << "bbrl_time_elapsed_ms{" << labelList[k] << "} ";
+          os << expList[k]->getTimeElapsed() << "\n";
+     }
+     
+     os << "# HELP bbrl_offline_time_ms Time spent in the offline phase.\n";
+     os << "# TYPE bbrl_offline_time_ms gauge\n";
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          os << "bbrl_offline_time_ms{" << labelList[k] << "} ";
+          os << agentList[k]->getOfflineTime() << "\n";
+     }
+     
+     
+     //   Discounted sums of rewards, regrets and durations of the
+     //   trajectories
+     os << "# HELP bbrl_trajectories_total Trajectories simulated.\n";
+     os << "# TYPE bbrl_trajectories_total counter\n";
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          os << "bbrl_trajectories_total{" << labelList[k] << "} ";
+          os << metricsList[k].dsr.getCount() << "\n";
+     }
+     
+     bool hasRegrets = false;
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          if (metricsList[k].regret.getCount() > 0) { hasRegrets = true; }
+     }
+     
+     const char* statNames[3] = { "return", "regret", "trajectory_time_ms" };
+     const char* statHelps[3] = { "Discounted sum of rewards",
+                                  "Regret",
+                                  "Duration" };
+     for (unsigned int s = 0; s < 3; ++s)
+     {
+          if ((s == 1) && !hasRegrets) { continue; }
+          
+          string name = (string("bbrl_") + statNames[s]);
+          const char* fields[4] = { "mean", "variance",
+                                    "ci95_lower", "ci95_upper" };
+          for (unsigned int f = 0; f < 4; ++f)
+          {
+               os << "# HELP " << name << "_" << fields[f] << " ";
+               os << statHelps[s] << " of the trajectories (" << fields[f];
+               os << ").\n";
+               os << "# TYPE " << name << "_" << fields[f] << " gauge\n";
+               for (unsigned int k = 0; k < expList.size(); ++k)
+               {
+                    const RunningStatistics* stat[3] = {
+                              &metricsList[k].dsr, &metricsList[k].regret,
+                              &metricsList[k].taskTime };
+                    if ((s == 1) && (stat[s]->getCount() == 0)) { continue; }
+                    
+                    double value;
+                    switch (f)
+                    {
+                         case 0:  value = stat[s]->getMean();              break;
+                         case 1:  value = stat[s]->getVariance();          break;
+                         case 2:  value = stat[s]->computeCI95().first;    break;
+                         default: value = stat[s]->computeCI95().second;   break;
+                    }
+                    
+                    os << name << "_" << fields[f] << "{" << labelList[k];
+                    os << "} " << value << "\n";
+               }
+          }
+     }
+     
+     
+     //   Throughput of each SimulationThread
+     os << "# HELP bbrl_thread_trajectories_total Trajectories simulated ";
+     os << "by a thread.\n";
+     os << "# TYPE bbrl_thread_trajectories_total counter\n";
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          const vector<unsigned int>& nbTasksList
+                    = metricsList[k].nbTasksList;
+          for (unsigned int i = 0; i < nbTasksList.size(); ++i)
+          {
+               os << "bbrl_thread_trajectories_total{" << labelList[k];
+               os << ",thread=\"" << i << "\"} " << nbTasksList[i] << "\n";
+          }
+     }
+     
+     os << "# HELP bbrl_thread_throughput Trajectories simulated by a ";
+     os << "thread per second of simulation.\n";
+     os << "# TYPE bbrl_thread_throughput gauge\n";
+     for (unsigned int k = 0; k < expList.size(); ++k)
+     {
+          const vector<unsigned int>& nbTasksList
+                    = metricsList[k].nbTasksList;
+          const vector<double>& threadTimeList
+                    = metricsList[k].threadTimeList;
+          for (unsigned int i = 0; i < nbTasksList.size(); ++i)
+          {
+               double throughput = ((threadTimeList[i] > 0.0) ?
+                         (1000.0 * nbTasksList[i] / threadTimeList[i]) : 0.0);
+               
+               os << "bbrl_thread_throughput{" << labelList[k];
+               os << ",thread=\"" << i << "\"} " << throughput << "\n";
+          }
+     }
+     
+     writeAtomically(file, os.str());
+}
+
+
 void offlineLearning(int argc, char* argv[]) throw (AgentException,
                                                     MDPException,
                                                     parsing::ParsingException)
@@ -196,7 +465,8 @@ void offlineLearning(int argc, char* argv[]) throw (AgentException,
 	delete mdpDistrib;
 }
 
-void newExperiment(int argc, char* argv[]) throw (parsing::ParsingException)
+void newExperiment(int argc, char* argv[]) throw (SerializableException,
+                                                  parsing::ParsingException)
 {
      //   1.   Get 'name'
      string name = parsing::getValue(argc, argv, "--name");
@@ -208,7 +478,8 @@ void newExperiment(int argc, char* argv[]) throw (parsing::ParsingException)
      
      
      //   3.   Get 'n_mdps', 'n_simulations_per_mdp', 'discount_factor',
-     //        'horizon_limit', 'safe_simulations', 'compress_output', 'output'     
+     //        'horizon_limit', 'safe_simulations', 'compress_output', 'output'
+     //        ('test_set_store' is retrieved after the creation)
      string tmp = parsing::getValue(argc, argv, "--n_mdps");
      unsigned int nMdps = atoi(tmp.c_str());
      
@@ -259,6 +530,34 @@ void newExperiment(int argc, char* argv[]) throw (parsing::ParsingException)
 	cout << "done! (in " << newTime.get() << "ms)\n";
 	
 	
+	    //   Compute the optimal value of each test MDP
+	    //   (stored in the Experiment, in order to report regrets)
+	unsigned int nThreads = 1;
+	if (parsing::hasFlag(argc, argv, "--n_threads"))
+	{
+          tmp = parsing::getValue(argc, argv, "--n_threads");
+          nThreads = atoi(tmp.c_str());
+	}
+	
+	Chrono optimalTime;
+	cout << "\tCompute the optimal values..." << flush;
+	experiment->computeOptimalValues(nThreads);
+	cout << "done! (in " << optimalTime.get() << "ms)\n";
+	
+	
+	    //   Store the test MDPs in the test-set store (if requested)
+	if (parsing::hasFlag(argc, argv, "--test_set_store"))
+	{
+          string storeDir = parsing::getValue(argc, argv, "--test_set_store");
+          
+          Chrono storeTime;
+          cout << "\tStore the test set..." << flush;
+          experiment->storeTestSet(storeDir);
+          cout << "done! (in " << storeTime.get() << "ms)\n";
+          cout << "\t\t(" << experiment->getTestSetFile() << ")\n";
+	}
+	
+	
 	    //	Export the Experiment
 	Chrono exportTime;
 	cout << "\tExport the Experiment..." << flush;
@@ -287,6 +586,7 @@ void newExperiment(int argc, char* argv[]) throw (parsing::ParsingException)
 
 void runExperiment(int argc, char* argv[]) throw (AgentException,
                                                   MDPException,
+                                                  ExperimentException,
                                                   parsing::ParsingException)
 {
      //   1.   Get 'experiment'
@@ -298,28 +598,8 @@ void runExperiment(int argc, char* argv[]) throw (AgentException,
      
      if (fileExists(output + ".bak" + (compressOutput ? ".zz" : "")))
      {
-          int argcBis = 4;
-          char* argvBis[4];
-          string str;
-          
-          argvBis[0] = argv[0];
-          
-          str = "--experiment";
-          argvBis[1] = new char[str.size() + 1];
-          std::copy(str.begin(), str.end(), argvBis[1]);
-          argvBis[1][str.size()] = '\0';
-          
-          str = "--experiment_file";
-          argvBis[2] = new char[str.size() + 1];
-          std::copy(str.begin(), str.end(), argvBis[2]);
-          argvBis[2][str.size()] = '\0';
-          
-          str = (output + ".bak" + (compressOutput ? ".zz" : ""));
-          argvBis[3] = new char[str.size() + 1];
-          std::copy(str.begin(), str.end(), argvBis[3]);
-          argvBis[3][str.size()] = '\0';
-
-          experiment = Experiment::parse(argcBis, argvBis);
+          experiment = parseExperimentFile(
+                    argv[0], (output + ".bak" + (compressOutput ? ".zz" : "")));
      }
 
           //   Other case
@@ -334,7 +614,7 @@ void runExperiment(int argc, char* argv[]) throw (AgentException,
      
      
      //   3.   Get 'n_threads', 'compress_output', 'output',
-     //        'refresh_frequency', 'backup_frequency'     
+     //        'refresh_frequency', 'backup_frequency', 'metrics_file'
      string tmp = parsing::getValue(argc, argv, "--n_threads");
      unsigned int nThreads = atoi(tmp.c_str());
 
@@ -343,6 +623,82 @@ void runExperiment(int argc, char* argv[]) throw (AgentException,
      
      tmp = parsing::getValue(argc, argv, "--backup_frequency");
      unsigned int backupFrequency = (1000.0 * atoi(tmp.c_str()));
+     
+     string metricsFile;
+     if (parsing::hasFlag(argc, argv, "--metrics_file"))
+          metricsFile = parsing::getValue(argc, argv, "--metrics_file");
+     
+     
+     //   4.   Get 'shard' (if specified)
+     //        (each simulation is seeded by its index, so that the results
+     //        do not depend on the shard performing it)
+     if (parsing::hasFlag(argc, argv, "--shard"))
+     {
+          tmp = parsing::getValue(argc, argv, "--shard");
+          unsigned int shardIndex, nShards;
+          if ((sscanf(tmp.c_str(), "%u/%u", &shardIndex, &nShards) != 2)
+                    || (nShards == 0) || (shardIndex >= nShards))
+          {
+               throw parsing::ParsingException("--shard");
+          }
+          
+          int seed = 0;
+          if (parsing::hasFlag(argc, argv, "--seed"))
+               seed = atoi(parsing::getValue(argc, argv, "--seed").c_str());
+          
+          if (seed <= 0)
+          {
+               cout << "\n\tA seed (> 0) is required with '--shard'!\n";
+               
+               delete agent;
+               delete experiment;
+               return;
+          }
+          
+          experiment->setShard(shardIndex, nShards);
+          experiment->setTaskSeed(seed);
+     }
+     
+     
+     //   5.   Get 'early_stopping' (if specified)
+     //        (the test MDPs are processed in a random order, so that the
+     //        simulations performed when stopping are a random sample)
+     bool earlyStopping = parsing::hasFlag(argc, argv, "--early_stopping");
+     double ciHalfWidth = 0.0;
+     Experiment* reference = 0;
+     unsigned int nbReferenceSim = 0;
+     if (earlyStopping)
+     {
+          if (parsing::hasFlag(argc, argv, "--ci_half_width"))
+          {
+               tmp = parsing::getValue(argc, argv, "--ci_half_width");
+               ciHalfWidth = atof(tmp.c_str());
+          }
+          
+          if (parsing::hasFlag(argc, argv, "--reference_file"))
+          {
+               tmp = parsing::getValue(argc, argv, "--reference_file");
+               try { reference = parseExperimentFile(argv[0], tmp); }
+               catch (parsing::ParsingException&)
+               {
+                    delete agent;
+                    delete experiment;
+                    throw parsing::ParsingException("--reference_file");
+               }
+               
+               nbReferenceSim = reference->computeDSRList().size();
+          }
+          
+          if ((ciHalfWidth <= 0.0) && !reference)
+          {
+               delete agent;
+               delete experiment;
+               throw parsing::ParsingException("--early_stopping");
+          }
+          
+          experiment->setRandomOrder(
+                    RandomGen::randIntRange_Uniform(1, INT_MAX - 1));
+     }
 
 
      assert(nThreads > 0);
@@ -353,6 +709,10 @@ void runExperiment(int argc, char* argv[]) throw (AgentException,
           cout << "\n\tThe file \"";
           cout << (output + (compressOutput ? ".zz" : ""));
           cout << "\" already exists!\n\n";
+          
+          delete agent;
+          delete experiment;
+          if (reference) { delete reference; }
           return;
      }
      
@@ -365,71 +725,154 @@ void runExperiment(int argc, char* argv[]) throw (AgentException,
                && (nThreads > 1))
      {
           cout << "\n\tCannot use this agent with more than one thread!\n";
+          
+          delete agent;
+          delete experiment;
+          if (reference) { delete reference; }
           return;
      }          
      //
      
      
-     //   4.   Run
+     //   6.   Run
      Chrono backupChrono;
+     double alphaSpent = 0.0;
 	while (experiment->getProgress() < 1.0)
 	{
 		//	Run the Experiment for a certain amount of time
 		experiment->run(agent, refreshFrequency, nThreads);
+		experiment->addProfile(utils::Profiler::collect());
+		utils::Profiler::reset();
 
 
 		//	Print out a summary of the Experiment
-		vector<double> dsrList = experiment->computeDSRList();
-		pair<double, double> CI95 = statistics::computeCI95<double>(dsrList);
+		Experiment::Metrics metrics = experiment->getMetrics();
+		pair<double, double> CI95 = metrics.dsr.computeCI95();
 
 		cout << "\tProgression: " << 100*experiment->getProgress() << "%\n";
 		cout << "\t\tOffline time:                 ";
 		cout << agent->getOfflineTime() << "ms\n";
 		cout << "\t\tOnline time (per trajectory): ";
-		cout << (experiment->getTimeElapsed() / dsrList.size()) << "ms\n";
+		cout << (experiment->getTimeElapsed() / metrics.dsr.getCount());
+		cout << "ms\n";
 		cout << "\t\tExpected return in            ";
 		cout << "[" << CI95.first << "; " << CI95.second;
 		cout << "] (with 95% confidence)\n";
+		if (!experiment->getOptimalValueList().empty())
+		{
+			pair<double, double> rCI95 = metrics.regret.computeCI95();
+			
+			cout << "\t\tExpected regret in            ";
+			cout << "[" << rCI95.first << "; " << rCI95.second;
+			cout << "] (with 95% confidence)\n";
+		}
+		
+		const vector<double>& nbSimList = experiment->getNbSimulationsList();
+		double nbSimulations = 0.0;
+		unsigned int nbPerformed = 0;
+		for (unsigned int t = 0; t < nbSimList.size(); ++t)
+		{
+			if (nbSimList[t] > 0.0)
+			{
+				nbSimulations += nbSimList[t];
+				++nbPerformed;
+			}
+		}
+		if (nbPerformed > 0)
+		{
+			cout << "\t\tSimulations (per decision):   ";
+			cout << (nbSimulations / nbPerformed) << "\n";
+		}
+		
+		const utils::Profiler::Profile& profile = experiment->getProfile();
+		if (!profile.empty())
+		{
+			cout << "\t\tProfile (calls, total time):\n";
+			utils::Profiler::Profile::const_iterator it;
+			for (it = profile.begin(); it != profile.end(); ++it)
+			{
+				cout << "\t\t\t" << it->first << ": " << it->second.count;
+				if (it->second.time > 0.0)
+					cout << ", " << it->second.time << "ms";
+				cout << "\n";
+			}
+		}
 		cout << "\n";
 		
 		
+		//	Export the metrics of the Experiment if needed
+		if (metricsFile != "")
+		{
+			exportMetrics(vector<Experiment*>(1, experiment),
+			              vector<Agent*>(1, agent),
+			              vector<string>(1, output), metricsFile);
+		}
+		
+		
+		//	Stop early if the result is precise enough, or if it differs
+		//	significantly from the reference
+		//	(at least 30 simulations, as required by the Z-test)
+		if (earlyStopping && (metrics.dsr.getCount() >= 30))
+		{
+			bool stop = false;
+			if ((ciHalfWidth > 0.0)
+					&& (((CI95.second - CI95.first) / 2.0) <= ciHalfWidth))
+			{
+				cout << "\tEarly stopping: CI half-width below ";
+				cout << ciHalfWidth << "\n\n";
+				stop = true;
+			}
+			
+			if (reference)
+			{
+				vector<double> x, y;
+				experiment->computePairedDSRLists(*reference, x, y);
+				
+				//	(sequential test: the 5% type I error is spent over
+				//	the looks following an O'Brien-Fleming-type
+				//	spending function of the fraction of the simulations
+				//	of the reference available, each look being tested at
+				//	the error spent since the previous one)
+				double tau = (x.size() / (double) nbReferenceSim);
+				double alpha = statistics::computeOBFAlphaSpending(0.05, tau);
+				
+				if ((x.size() >= 30) && (alpha > alphaSpent))
+				{
+					double z = statistics::computePairedZ<double>(x, y);
+					double zThreshold =
+							statistics::getBilateralZThreshold(
+									alpha - alphaSpent);
+					alphaSpent = alpha;
+					
+					cout << "\t\tPaired Z-test (reference):    ";
+					cout << "Z = " << z << " (threshold: " << zThreshold;
+					cout << ")\n\n";
+					
+					if (z >= zThreshold)
+					{
+						cout << "\tEarly stopping: significantly ";
+						cout << ((statistics::computeMean<double>(x)
+						          > statistics::computeMean<double>(y)) ?
+						               "better" : "worse");
+						cout << " than the reference\n\n";
+						stop = true;
+					}
+				}
+			}
+			
+			if (stop) { break; }
+		}
+		
+		
 		//	Create a bakcup if needed
 		if ((backupFrequency > 0) && (backupChrono.get() >= backupFrequency))
 		{
 			Chrono backupTime;
 			
 			cout << "\tCreate a backup..." << flush;
-
-			//	Generate a random file name
-			string tmpStr
-					= output.substr(0, output.find_last_of("/"));
-			tmpStr += "/";
-			const char alphanum[] =
-				"0123456789"
-				"!@#$%^&*"
-				"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-				"abcdefghijklmnopqrstuvwxyz";
-			for (int l = 0; l < 42; ++l)
-			{ tmpStr += alphanum[rand() % (sizeof(alphanum) - 1)]; }
-
-
-			if (compressOutput)
-			{	
-				ofstream os(tmpStr.c_str());
-				experiment->zSerialize(os, Z_BEST_SPEED);
-				os.close();
-
-				rename(tmpStr.c_str(), (output + ".bak.zz").c_str());
-			}
-
-			else
-			{
-				ofstream os(tmpStr.c_str());
-				experiment->serialize(os);
-				os.close();
-
-				rename(tmpStr.c_str(), (output + ".bak").c_str());
-			}
+			
+			exportExperiment(experiment, (output + ".bak"),
+			                 compressOutput, Z_BEST_SPEED, nThreads);
 			
 			cout << "done! (in " << backupTime.get() << "ms)\n\n";
 			
@@ -442,32 +885,322 @@ void runExperiment(int argc, char* argv[]) throw (AgentException,
 			
 	cout << "\tExport the results..." << flush;
 	
-	if (compressOutput)
+	exportExperiment(experiment, output, compressOutput, Z_BEST_COMPRESSION,
+	                 nThreads);
+	
+	
+	//	Remove backup
+	remove((output + ".bak" + (compressOutput ? ".zz" : "")).c_str());
+	
+	cout << "done! (in " << exportTime.get() << "ms)\n\n";
+	
+	
+	//  Free
+	delete agent;
+	delete experiment;
+	if (reference) { delete reference; }
+}
+
+
+void runExperiments(int argc, char* argv[]) throw (AgentException,
+                                                   MDPException,
+                                                   parsing::ParsingException)
+{
+     //   1.   Get 'experiment' (its test MDPs are shared by all the agents)
+     Experiment* experiment = Experiment::parse(argc, argv);
+     assert(experiment);
+     
+     
+     //   2.   Get 'n_threads', 'compress_output', 'refresh_frequency',
+     //        'backup_frequency', 'metrics_file'
+     string tmp = parsing::getValue(argc, argv, "--n_threads");
+     unsigned int nThreads = atoi(tmp.c_str());
+     
+     bool compressOutput = parsing::hasFlag(argc, argv, "--compress_output");
+
+     tmp = parsing::getValue(argc, argv, "--refresh_frequency");
+     unsigned int refreshFrequency = (1000.0 * atoi(tmp.c_str()));
+     
+     tmp = parsing::getValue(argc, argv, "--backup_frequency");
+     unsigned int backupFrequency = (1000.0 * atoi(tmp.c_str()));
+     
+     string metricsFile;
+     if (parsing::hasFlag(argc, argv, "--metrics_file"))
+          metricsFile = parsing::getValue(argc, argv, "--metrics_file");
+     
+     assert(nThreads > 0);
+     
+     
+     //   3.   Get the agents, and create an Experiment for each one
+     //        (restored from its backup if any)
+     tmp = parsing::getValue(argc, argv, "--agents");
+     unsigned int nAgents = atoi(tmp.c_str());
+     if (nAgents == 0) { throw parsing::ParsingException("--agents"); }
+     
+     vector<string> agentValues
+               = parsing::getValues(argc, argv, "--agents", 1 + 3*nAgents);
+     
+          //   Special case for agents based on A. Guez implementation
+     for (unsigned int k = 0; k < nAgents; ++k)
+     {
+          string agentClassName = agentValues[1 + 3*k];
+          if (((agentClassName == BAMCPAgent::toString())
+                    || (agentClassName == BFS3Agent::toString())
+                    || (agentClassName == SBOSSAgent::toString())
+                    || (agentClassName == BEBAgent::toString()))
+                    && (nThreads > 1))
+          {
+               cout << "\n\tCannot use this agent with more than one thread!\n";
+               
+               delete experiment;
+               return;
+          }
+     }
+     //
+     
+     vector<Agent*> agentList;
+     vector<Experiment*> expList;
+     vector<string> outputList;
+     for (unsigned int k = 0; k < nAgents; ++k)
+     {
+          string agentClassName = agentValues[1 + 3*k];
+          string agentFile      = agentValues[2 + 3*k];
+          string output         = agentValues[3 + 3*k];
+          assert(output != "");
+          
+          if (fileExists(output + (compressOutput ? ".zz" : "")))
+          {
+               cout << "\n\tThe file \"";
+               cout << (output + (compressOutput ? ".zz" : ""));
+               cout << "\" already exists! (skipped)\n";
+               continue;
+          }
+          
+          
+               //   Agent
+          ifstream is(agentFile.c_str());
+          if (is.fail()) // Unable to open the file
+               throw parsing::ParsingException("--agents");
+          
+          Agent* agent = dynamic_cast<Agent*>(
+                    Serializable::createInstance(agentClassName, is));
+          assert(agent);
+          
+          
+               //   Experiment (sharing the test MDPs of 'experiment', its
+               //   results being restored from its backup if any)
+          Experiment* exp = experiment->emptyCopy();
+          
+          string backup = (output + ".bak" + (compressOutput ? ".zz" : ""));
+          if (fileExists(backup))
+          {
+               ifstream bis(backup.c_str());
+               Experiment* bak = dynamic_cast<Experiment*>(
+                         Serializable::createInstance("Experiment", bis));
+               assert(bak);
+               
+               bool restored = true;
+               try { exp->merge(*bak); }
+               catch (ExperimentException&)
+               {
+                    cout << "\n\tThe backup \"" << backup << "\" does not ";
+                    cout << "match the experiment! (skipped)\n";
+                    restored = false;
+               }
+               delete bak;
+               
+               if (!restored) { delete exp; delete agent; continue; }
+          }
+          
+          expList.push_back(exp);
+          agentList.push_back(agent);
+          outputList.push_back(output);
+     }
+     
+     if (agentList.empty()) { delete experiment; return; }
+     
+     
+     //   4.   Run
+     vector<IExperiment<Agent, MDP, SimulationRecord>*> iExpList(
+               expList.begin(), expList.end());
+     vector<bool> exportedList(expList.size(), false);
+     
+     Chrono backupChrono;
+     unsigned int nExported = 0;
+	while (nExported < expList.size())
 	{
-		ofstream os((output + ".zz").c_str());
-		experiment->zSerialize(os, Z_BEST_COMPRESSION);
-		os.close();
+		//	Run the Experiments for a certain amount of time
+		IExperiment<Agent, MDP, SimulationRecord>::runAll(
+				iExpList, agentList, refreshFrequency, nThreads);
+		
+		//	(the pooled threads mix all the agents in a single profile,
+		//	 shared by all the Experiments still running)
+		utils::Profiler::Profile profile = utils::Profiler::collect();
+		utils::Profiler::reset();
+		
+		for (unsigned int k = 0; k < expList.size(); ++k)
+			if (!exportedList[k]) { expList[k]->addProfile(profile); }
+		
+		
+		//	Print out a summary of each Experiment
+		bool doBackup = ((backupFrequency > 0)
+		                    && (backupChrono.get() >= backupFrequency));
+		
+		for (unsigned int k = 0; k < expList.size(); ++k)
+		{
+			if (exportedList[k]) { continue; }
+			
+			Experiment::Metrics metrics = expList[k]->getMetrics();
+			pair<double, double> CI95 = metrics.dsr.computeCI95();
+			
+			cout << "\t" << outputList[k] << "\n";
+			cout << "\t\tProgression:                  ";
+			cout << 100*expList[k]->getProgress() << "%\n";
+			cout << "\t\tOffline time:                 ";
+			cout << agentList[k]->getOfflineTime() << "ms\n";
+			cout << "\t\tOnline time (per trajectory): ";
+			cout << (expList[k]->getTimeElapsed() / metrics.dsr.getCount());
+			cout << "ms\n";
+			cout << "\t\tExpected return in            ";
+			cout << "[" << CI95.first << "; " << CI95.second;
+			cout << "] (with 95% confidence)\n";
+			if (!expList[k]->getOptimalValueList().empty())
+			{
+				pair<double, double> rCI95 = metrics.regret.computeCI95();
+				
+				cout << "\t\tExpected regret in            ";
+				cout << "[" << rCI95.first << "; " << rCI95.second;
+				cout << "] (with 95% confidence)\n";
+			}
+			cout << "\n";
+			
+			
+			//	Export the final results
+			if (expList[k]->getProgress() >= 1.0)
+			{
+				Chrono exportTime;
+				cout << "\tExport the results..." << flush;
+				
+				exportExperiment(expList[k], outputList[k],
+				                 compressOutput, Z_BEST_COMPRESSION, nThreads);
+				remove((outputList[k] + ".bak"
+				          + (compressOutput ? ".zz" : "")).c_str());
+				
+				cout << "done! (in " << exportTime.get() << "ms)\n\n";
+				
+				exportedList[k] = true;
+				++nExported;
+			}
+			
+			
+			//	Create a backup if needed
+			else if (doBackup)
+			{
+				Chrono backupTime;
+				cout << "\tCreate a backup..." << flush;
+				
+				exportExperiment(expList[k], (outputList[k] + ".bak"),
+				                 compressOutput, Z_BEST_SPEED, nThreads);
+				
+				cout << "done! (in " << backupTime.get() << "ms)\n\n";
+			}
+		}
+		
+		if (doBackup) { backupChrono.restart(); }
 		
 		
-		//	Remove backup
-		remove((output + ".bak.zz").c_str());
+		//	Export the metrics of the Experiments if needed
+		if (metricsFile != "")
+			exportMetrics(expList, agentList, outputList, metricsFile);
 	}
 	
-	else
+	
+	//  Free
+	for (unsigned int k = 0; k < expList.size(); ++k)
 	{
-		ofstream os(output.c_str());
-		experiment->serialize(os);
-		os.close();
-		
-		//	Remove backup
-		remove((output + ".bak").c_str());
+		delete agentList[k];
+		delete expList[k];
 	}
+	delete experiment;
+}
+
+
+void mergeExperiments(int argc, char* argv[]) throw (ExperimentException,
+                                                     parsing::ParsingException)
+{
+     //   1.   Get the Experiments to merge
+     string tmp = parsing::getValue(argc, argv, "--experiments");
+     unsigned int nExperiments = atoi(tmp.c_str());
+     if (nExperiments == 0) { throw parsing::ParsingException("--experiments"); }
+     
+     vector<string> experimentFiles
+               = parsing::getValues(argc, argv, "--experiments", 1 + nExperiments);
+     
+     
+     //   2.   Get 'compress_output', 'output'
+     bool compressOutput = parsing::hasFlag(argc, argv, "--compress_output");
+     string output = parsing::getValue(argc, argv, "--output");
+     assert(output != "");
+     
+     if (fileExists(output + (compressOutput ? ".zz" : "")))
+     {
+          cout << "\n\tThe file \"";
+          cout << (output + (compressOutput ? ".zz" : ""));
+          cout << "\" already exists!\n\n";
+          return;
+     }
+     
+     
+     //   3.   Run
+     Chrono mergeTime;
+	cout << "\n";
+	cout << "\tMerge the Experiments..." << flush;
+	
+	Experiment* experiment = 0;
+	for (unsigned int i = 1; i <= nExperiments; ++i)
+	{
+          ifstream is(experimentFiles[i].c_str());
+          if (is.fail()) //   Unable to open the file
+               throw parsing::ParsingException("--experiments");
+          
+          Experiment* shard = dynamic_cast<Experiment*>(
+                    Serializable::createInstance("Experiment", is));
+          assert(shard);
+          
+          if (!experiment) { experiment = shard; continue; }
+          
+          try { experiment->merge(*shard); }
+          catch (ExperimentException& e)
+          {
+               delete shard;
+               delete experiment;
+               throw;
+          }
+          delete shard;
+	}
+	experiment->setShard(0, 1);
 	
+	cout << "done! (in " << mergeTime.get() << "ms)\n";
+	
+	
+	    //	Print out a summary of the Experiment
+	vector<double> dsrList = experiment->computeDSRList();
+	pair<double, double> CI95 = statistics::computeCI95<double>(dsrList);
+	
+	cout << "\tProgression: " << 100*experiment->getProgress() << "%\n";
+	cout << "\t\tExpected return in            ";
+	cout << "[" << CI95.first << "; " << CI95.second;
+	cout << "] (with 95% confidence)\n";
+	
+	
+	    //	Export the merged Experiment
+	Chrono exportTime;
+	cout << "\tExport the results..." << flush;
+	exportExperiment(experiment, output, compressOutput, Z_BEST_COMPRESSION);
 	cout << "done! (in " << exportTime.get() << "ms)\n\n";
 	
 	
-	//  Free
-	delete agent;
+	//  4.   Free data
 	delete experiment;
 }
 
@@ -672,7 +1405,7 @@ void formulaSetGen(int argc, char* argv[]) throw (parsing::ParsingException)
 }
 
 
-void slSamplesGen(int argc, char* argv[]) throw (bad_cast,
+void slSamplesGen(int argc, char* argv[]) throw (bad_cast, AgentException,
                                                  parsing::ParsingException)
 {
      //   1.   Get 'agent' (if specified)
@@ -704,23 +1437,63 @@ void slSamplesGen(int argc, char* argv[]) throw (bad_cast,
      unsigned int T = atoi(tmp.c_str());
      
      
-     //   6.   Generate the SL samples
+     //   6.   Get 'output', 'n_threads' (if specified) and 'binary_shards'
+     string output = parsing::getValue(argc, argv, "--output");
+     
+     unsigned int nbThreads = 1;
+     if (parsing::hasFlag(argc, argv, "--n_threads"))
+     {
+          tmp = parsing::getValue(argc, argv, "--n_threads");
+          nbThreads = atoi(tmp.c_str());
+     }
+     
+     bool binaryShards = parsing::hasFlag(argc, argv, "--binary_shards");
+     
+     
+     //   7.   Generate the SL samples
      Chrono time;
 	cout << "\tGenerate the SL samples..." << flush;
 	
 	vector<vector<double> > inputs, outputs;
 	vector<double> weights;
 	vector<unsigned int> indexes;
-     SLAgent::generateSLSamples(agent, dirDistrib, nbOfMDPs, simGamma, T,
-                                inputs, outputs, weights, indexes);
+	if (binaryShards || (nbThreads > 1))
+	{
+		string shardPrefix = (binaryShards ? output : (output + ".tmp"));
+		vector<string> shardFileList =
+				SLAgent::generateSLSamples(agent, dirDistrib, nbOfMDPs,
+				                           simGamma, T,
+				                           shardPrefix, nbThreads);
+		
+		//	The shards are the output
+		if (binaryShards)
+		{
+			cout << "done! (in " << time.get() << "ms)\n\n";
+			for (unsigned int k = 0; k < shardFileList.size(); ++k)
+				cout << "\t\t" << shardFileList[k] << "\n";
+			cout << "\n";
+			
+			delete mdpDistrib;
+			if (agent) { delete agent; }
+			
+			return;
+		}
+		
+		//	The shards are merged into a single text file
+		SLAgent::loadSLSamples(shardFileList,
+		                       inputs, outputs, weights, indexes);
+		for (unsigned int k = 0; k < shardFileList.size(); ++k)
+			remove(shardFileList[k].c_str());
+	}
+	else
+	{
+		SLAgent::generateSLSamples(agent, dirDistrib, nbOfMDPs, simGamma, T,
+		                           inputs, outputs, weights, indexes);
+	}
 	
 	cout << "done! (in " << time.get() << "ms)\n\n";
      
      
-     //   7.   Get 'output'
-     string output = parsing::getValue(argc, argv, "--output");
-     
-     
      //   8.   Save the ML samples into a file
 	Chrono exportTime;
 	cout << "\tExport the results..." << flush;